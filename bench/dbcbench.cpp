@@ -0,0 +1,632 @@
+// dbc_bench: times the core pipeline (parse, columnar snapshot, validate, model traversal, frame
+// dispatch, signal decode, DBC write, Excel export/import) on the bundled sample DBCs and on synthetic scaled-up
+// copies, and prints one JSON document that CI can store and trend.
+//
+// Usage: dbc_bench [--iterations N] [--scales 1,4,16] [--synthetic 1000,5000] [--seed N] [--output FILE] [files...]
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "canmessage.h"
+#include "cansignal.h"
+#include "dbcexcelconverter.h"
+#include "dbcgenerator.h"
+#include "dbcparser.h"
+#include "dbcvalidator.h"
+#include "dbcwriter.h"
+#include "decodeplan.h"
+#include "messageindex.h"
+#include "signalcolumns.h"
+#include "signalcodec.h"
+
+// ---------------------------------------------------------------------------------------------
+// Allocation counting: global operator new/delete replacements for this executable only.
+
+namespace {
+std::atomic<quint64> g_allocations{0};
+std::atomic<quint64> g_allocatedBytes{0};
+
+void *countedAlloc(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try { return countedAlloc(size); } catch (...) { return nullptr; }
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+/** Process peak resident set size in KiB (0 when unavailable). */
+qint64 peakRssKb()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(Q_OS_MACOS)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;        // KiB on Linux
+#endif
+#endif
+}
+
+/** Linux: resets VmHWM so each stage reports its own peak (no-op elsewhere). */
+void resetPeakRss()
+{
+#if defined(Q_OS_LINUX)
+    QFile clearRefs(QStringLiteral("/proc/self/clear_refs"));
+    if (clearRefs.open(QIODevice::WriteOnly)) {
+        clearRefs.write("5");
+    }
+#endif
+}
+
+qint64 currentPeakKb()
+{
+#if defined(Q_OS_LINUX)
+    QFile status(QStringLiteral("/proc/self/status"));
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray &line : status.readAll().split('\n')) {
+            if (line.startsWith("VmHWM:")) {
+                return line.mid(6).trimmed().split(' ').value(0).toLongLong();
+            }
+        }
+    }
+#endif
+    return peakRssKb();
+}
+
+struct Dataset
+{
+    QString name;
+    int scale = 1;
+    QString dbcPath;
+    QString xlsxPath;   // produced by the export stage, consumed by import
+    qint64 bytes = 0;
+    int messages = 0;
+    int signalCount = 0;
+};
+
+struct StageResult
+{
+    QVector<double> ms;
+    quint64 allocations = 0;     // of the last iteration
+    quint64 allocatedBytes = 0;
+    qint64 peakRssKb = 0;
+    bool ok = true;
+    QString error;
+};
+
+/** Runs fn iterations times; allocation counts are taken from the final (warm) iteration. */
+StageResult runStage(int iterations, const std::function<bool(QString *)> &fn)
+{
+    StageResult result;
+    resetPeakRss();
+    for (int i = 0; i < iterations && result.ok; ++i) {
+        const quint64 allocBefore = g_allocations.load();
+        const quint64 bytesBefore = g_allocatedBytes.load();
+        QElapsedTimer timer;
+        timer.start();
+        result.ok = fn(&result.error);
+        result.ms.append(timer.nsecsElapsed() / 1e6);
+        result.allocations = g_allocations.load() - allocBefore;
+        result.allocatedBytes = g_allocatedBytes.load() - bytesBefore;
+    }
+    result.peakRssKb = currentPeakKb();
+    return result;
+}
+
+void deleteMessages(const QList<CanMessage *> &messages)
+{
+    for (CanMessage *message : messages) {
+        qDeleteAll(message->getSignals());
+        delete message;
+    }
+}
+
+/** Writes a copy of parser's database repeated scale times (IDs and names made unique). */
+bool writeScaled(const DbcParser &parser, int scale, const QString &path, QString *error)
+{
+    QList<CanMessage *> messages;
+    for (int copy = 0; copy < scale; ++copy) {
+        for (const CanMessage *source : parser.getMessages()) {
+            CanMessage *message = new CanMessage(source->fieldsOnly());
+            if (copy > 0) {
+                // Spread copies through the 29-bit extended range; relocated standard IDs no longer
+                // fit in 11 bits, so every copy is marked extended (bit 31).
+                const quint32 id = source->getId();
+                message->setId(0x80000000u | (((id & 0x1FFFFFFFu) + quint32(copy) * 0x100000u) & 0x1FFFFFFFu));
+                message->setName(QString("%1_x%2").arg(source->getName()).arg(copy));
+            }
+            for (const CanSignal *signal : source->getSignals()) {
+                message->addSignal(new CanSignal(*signal));
+            }
+            messages.append(message);
+        }
+    }
+    const bool ok = DbcWriter::write(path, parser.getVersion(), parser.getBusType(), parser.getNodes(), messages,
+                                     QString(), parser.getDocumentTitle(), parser.getChangeHistory(),
+                                     parser.getGlobalValueTables(), parser.attributes(), error);
+    deleteMessages(messages);
+    return ok;
+}
+
+QJsonObject stageJson(const Dataset &dataset, const QString &stage, const StageResult &result, qint64 bytes)
+{
+    QVector<double> sorted = result.ms;
+    std::sort(sorted.begin(), sorted.end());
+    const double minMs = sorted.isEmpty() ? 0.0 : sorted.first();
+    const double medianMs = sorted.isEmpty() ? 0.0 : sorted.at(sorted.size() / 2);
+
+    QJsonObject object;
+    object.insert("dataset", dataset.name);
+    object.insert("scale", dataset.scale);
+    object.insert("stage", stage);
+    object.insert("ok", result.ok);
+    if (!result.ok) {
+        object.insert("error", result.error);
+        return object;
+    }
+    object.insert("messages", dataset.messages);
+    object.insert("signals", dataset.signalCount);
+    object.insert("bytes", bytes);
+    object.insert("minMs", minMs);
+    object.insert("medianMs", medianMs);
+    object.insert("mbPerSec", medianMs > 0 ? bytes / (1024.0 * 1024.0) / (medianMs / 1000.0) : 0.0);
+    object.insert("signalsPerSec", medianMs > 0 ? dataset.signalCount / (medianMs / 1000.0) : 0.0);
+    object.insert("allocations", static_cast<qint64>(result.allocations));
+    object.insert("allocatedBytes", static_cast<qint64>(result.allocatedBytes));
+    object.insert("peakRssKb", result.peakRssKb);
+    return object;
+}
+
+const int kDecodeFrames = 64;        // random payloads per message for the decode stages
+const int kDispatchFrames = 1 << 18; // frame IDs looked up by the dispatch stages
+
+/** Random payloads and decode plans for every message; checks the plan against SignalCodec. */
+struct DecodeFixture
+{
+    QVector<QByteArray> payloads;       // kDecodeFrames per message, message-major
+    QVector<DecodePlan> plans;
+    QVector<DecodePlan> genericPlans;
+    qint64 bytes = 0;
+};
+
+DecodeFixture makeDecodeFixture(const QList<CanMessage *> &messages)
+{
+    DecodeFixture fixture;
+    QRandomGenerator rng(1);
+    for (const CanMessage *message : messages) {
+        fixture.plans.append(DecodePlan(*message));
+        fixture.genericPlans.append(DecodePlan(*message, DecodePlan::GenericOnly));
+        for (int i = 0; i < kDecodeFrames; ++i) {
+            QByteArray payload(qBound(0, message->getLength(), DecodePlan::kMaxFrameBytes), Qt::Uninitialized);
+            for (char &byte : payload) {
+                byte = char(rng.bounded(256));
+            }
+            fixture.bytes += payload.size();
+            fixture.payloads.append(payload);
+        }
+    }
+    return fixture;
+}
+
+/** Decodes every payload with fn(messageIndex, payload, out) and sums the raw values. */
+template <typename Fn>
+quint64 decodeAll(const QList<CanMessage *> &messages, const DecodeFixture &fixture, Fn fn)
+{
+    QVector<quint64> raw;
+    quint64 sum = 0;
+    for (int m = 0; m < messages.size(); ++m) {
+        raw.resize(messages.at(m)->getSignals().size());
+        for (int i = 0; i < kDecodeFrames; ++i) {
+            const QByteArray &payload = fixture.payloads.at(m * kDecodeFrames + i);
+            fn(m, reinterpret_cast<const uchar *>(payload.constData()), payload.size(), raw.data());
+            for (quint64 value : raw) {
+                sum += value;
+            }
+        }
+    }
+    return sum;
+}
+
+/**
+ * Reads every string, receiver list, value table and signal list of the database. Copy holds
+ * each one in a local the way by-value getters did (one refcount increment and decrement per
+ * container); otherwise the const references are used directly. Returns a size checksum.
+ */
+template <bool Copy>
+quint64 traverseModel(const QList<CanMessage *> &messages)
+{
+    using Text = std::conditional_t<Copy, const QString, const QString &>;
+    using Names = std::conditional_t<Copy, const QStringList, const QStringList &>;
+    using Table = std::conditional_t<Copy, const QMap<int, QString>, const QMap<int, QString> &>;
+    using Signals = std::conditional_t<Copy, const QList<CanSignal *>, const QList<CanSignal *> &>;
+    quint64 sum = 0;
+    for (const CanMessage *message : messages) {
+        Text name = message->getName();
+        Text transmitter = message->getTransmitter();
+        Text comment = message->getComment();
+        Names receivers = message->getReceivers();
+        Signals signalList = message->getSignals();
+        sum += name.size() + transmitter.size() + comment.size() + receivers.size() + signalList.size();
+        for (const CanSignal *signal : signalList) {
+            Text signalName = signal->getName();
+            Text unit = signal->getUnit();
+            Text description = signal->getDescription();
+            Names signalReceivers = signal->getReceivers();
+            Table valueTable = signal->getValueTable();
+            sum += signalName.size() + unit.size() + description.size() + signalReceivers.size();
+            for (auto it = valueTable.constBegin(); it != valueTable.constEnd(); ++it) {
+                sum += it.value().size();
+            }
+        }
+    }
+    return sum;
+}
+
+QJsonArray benchDataset(Dataset &dataset, int iterations, const QString &workDir, QTextStream &err)
+{
+    QJsonArray results;
+    const QString tag = QString("%1_x%2").arg(QFileInfo(dataset.dbcPath).completeBaseName()).arg(dataset.scale);
+    dataset.xlsxPath = QDir(workDir).filePath(tag + ".xlsx");
+    const QString dbcOut = QDir(workDir).filePath(tag + ".out.dbc");
+
+    DbcParser parser;
+    const StageResult parse = runStage(iterations, [&](QString *error) {
+        if (!parser.parseFile(dataset.dbcPath)) {
+            *error = "parse failed";
+            return false;
+        }
+        return true;
+    });
+    if (!parse.ok) {
+        results.append(stageJson(dataset, "parse", parse, dataset.bytes));
+        return results;
+    }
+    dataset.messages = parser.getMessages().size();
+    dataset.signalCount = 0;
+    for (const CanMessage *message : parser.getMessages()) {
+        dataset.signalCount += message->getSignals().size();
+    }
+    results.append(stageJson(dataset, "parse", parse, dataset.bytes));
+    err << "  parse      " << dataset.name << " x" << dataset.scale << "\n";
+
+    results.append(stageJson(dataset, "signalColumns", runStage(iterations, [&](QString *) {
+        const SignalColumns columns(parser.getMessages());
+        return columns.signalCount() == dataset.signalCount;
+    }), dataset.bytes));
+    err << "  columns    " << dataset.name << " x" << dataset.scale << "\n";
+
+    results.append(stageJson(dataset, "validate", runStage(iterations, [&](QString *) {
+        validateMessages(parser.getMessages());
+        return true;
+    }), dataset.bytes));
+    err << "  validate   " << dataset.name << " x" << dataset.scale << "\n";
+
+    // Full read traversal: by-value copies vs the const-reference accessors. Neither allocates;
+    // the copy variant pays two refcount atomics per container read.
+    const quint64 traverseSum = traverseModel<false>(parser.getMessages());
+    results.append(stageJson(dataset, "traverseCopy", runStage(iterations, [&](QString *error) {
+        if (traverseModel<true>(parser.getMessages()) != traverseSum) {
+            *error = "traversal checksum differs";
+            return false;
+        }
+        return true;
+    }), dataset.bytes));
+    results.append(stageJson(dataset, "traverseRef", runStage(iterations, [&](QString *) {
+        return traverseModel<false>(parser.getMessages()) == traverseSum;
+    }), dataset.bytes));
+    err << QString("  traverse   %1 x%2, %3 container copies avoided per pass\n")
+               .arg(dataset.name).arg(dataset.scale)
+               .arg(5 * (qint64(parser.getMessages().size()) + dataset.signalCount));
+
+    // Signal decoding: per-call bit walk (SignalCodec), plan with generic kernels only, plan with
+    // layout-specialised kernels. All three must produce the same checksum.
+    const QList<CanMessage *> &messages = parser.getMessages();
+    const DecodeFixture fixture = makeDecodeFixture(messages);
+    quint64 expectedSum = 0;
+    bool haveExpected = false;
+    auto decodeStage = [&](const char *stage, const std::function<quint64()> &run) {
+        results.append(stageJson(dataset, stage, runStage(iterations, [&](QString *error) {
+            const quint64 sum = run();
+            if (!haveExpected) {
+                expectedSum = sum;
+                haveExpected = true;
+            } else if (sum != expectedSum) {
+                *error = "decoded values differ from SignalCodec";
+                return false;
+            }
+            return true;
+        }), fixture.bytes));
+        err << "  " << QString(stage).leftJustified(10) << " " << dataset.name << " x" << dataset.scale << "\n";
+    };
+    decodeStage("decodeCodec", [&]() {
+        return decodeAll(messages, fixture, [&](int m, const uchar *data, int size, quint64 *out) {
+            const QList<CanSignal *> &signalList = messages.at(m)->getSignals();
+            for (int s = 0; s < signalList.size(); ++s) {
+                const CanSignal &signal = *signalList.at(s);
+                const quint64 raw = SignalCodec::extractRaw(signal, data, size);
+                out[s] = signal.isSigned() ? quint64(SignalCodec::toSigned(raw, signal.getLength())) : raw;
+            }
+        });
+    });
+    decodeStage("decodeGeneric", [&]() {
+        return decodeAll(messages, fixture, [&](int m, const uchar *data, int size, quint64 *out) {
+            fixture.genericPlans.at(m).decodeRaw(data, size, out);
+        });
+    });
+    decodeStage("decodePlan", [&]() {
+        return decodeAll(messages, fixture, [&](int m, const uchar *data, int size, quint64 *out) {
+            fixture.plans.at(m).decodeRaw(data, size, out);
+        });
+    });
+    int specialized = 0;
+    for (const DecodePlan &plan : fixture.plans) {
+        specialized += plan.size() - plan.countOf(DecodePlan::GenericKernel);
+    }
+    err << QString("  decode     %1 of %2 signals use specialised kernels, checksum %3\n")
+               .arg(specialized).arg(dataset.signalCount).arg(expectedSum, 0, 16);
+
+    // Frame dispatch: ID -> message through the parser's QMap vs the flat MessageIndex.
+    // 7 of 8 lookups hit a known ID, the rest are IDs absent from the database.
+    QVector<quint32> frameIds(kDispatchFrames);
+    QRandomGenerator idRng(2);
+    for (quint32 &id : frameIds) {
+        if (!messages.isEmpty() && idRng.bounded(8) != 0) {
+            id = messages.at(idRng.bounded(messages.size()))->getId();
+        } else {
+            id = idRng.bounded(2) ? idRng.bounded(0x800u) : (0x80000000u | idRng.bounded(0x20000000u));
+        }
+    }
+    const qint64 dispatchBytes = qint64(kDispatchFrames) * sizeof(quint32);
+    quint64 mapSum = 0;
+    results.append(stageJson(dataset, "dispatchMap", runStage(iterations, [&](QString *) {
+        quint64 sum = 0;
+        for (quint32 id : frameIds) {
+            const CanMessage *message = parser.getMessage(id);
+            sum += message ? message->getId() : 0;
+        }
+        mapSum = sum;
+        return true;
+    }), dispatchBytes));
+    err << "  dispatchMap   " << dataset.name << " x" << dataset.scale << "\n";
+    results.append(stageJson(dataset, "dispatchIndex", runStage(iterations, [&](QString *error) {
+        const MessageIndex &index = parser.messageIndex();
+        quint64 sum = 0;
+        for (quint32 id : frameIds) {
+            const int ordinal = index.ordinal(id);
+            sum += ordinal >= 0 ? messages.at(ordinal)->getId() : 0;
+        }
+        if (sum != mapSum) {
+            *error = "MessageIndex disagrees with DbcParser::getMessage";
+            return false;
+        }
+        return true;
+    }), dispatchBytes));
+    err << "  dispatchIndex " << dataset.name << " x" << dataset.scale << "\n";
+
+    // The output only exists once the stage has run, so its size is read afterwards.
+    const StageResult writeResult = runStage(iterations, [&](QString *error) {
+        return DbcWriter::write(dbcOut, parser.getVersion(), parser.getBusType(), parser.getNodes(),
+                                parser.getMessages(), QString(), parser.getDocumentTitle(),
+                                parser.getChangeHistory(), parser.getGlobalValueTables(), parser.attributes(), error);
+    });
+    results.append(stageJson(dataset, "writeDbc", writeResult, QFileInfo(dbcOut).size()));
+    err << "  writeDbc   " << dataset.name << " x" << dataset.scale << "\n";
+
+    const StageResult exportResult = runStage(iterations, [&](QString *error) {
+        return DbcExcelConverter::exportToExcel(dataset.xlsxPath, parser.getVersion(), parser.getBusType(),
+                                                parser.getNodes(), parser.getMessages(),
+                                                parser.getDocumentTitle(), parser.getChangeHistory(), true,
+                                                DbcExcelConverter::CompressionBalanced, error);
+    });
+    results.append(stageJson(dataset, "exportXlsx", exportResult, QFileInfo(dataset.xlsxPath).size()));
+    err << "  exportXlsx " << dataset.name << " x" << dataset.scale << "\n";
+    if (!exportResult.ok) {
+        return results;
+    }
+
+    results.append(stageJson(dataset, "importXlsx", runStage(iterations, [&](QString *error) {
+        DbcExcelConverter::ImportResult imported;
+        const bool ok = DbcExcelConverter::importFromExcel(dataset.xlsxPath, imported, error);
+        imported.clear();
+        return ok;
+    }), QFileInfo(dataset.xlsxPath).size()));
+    err << "  importXlsx " << dataset.name << " x" << dataset.scale << "\n";
+    return results;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    int iterations = 5;
+    QVector<int> scales = {1, 4, 16};
+    QString outputPath;
+    QVector<int> syntheticCounts;
+    quint32 seed = 1;
+    QStringList inputs;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (arg == QLatin1String("--iterations") && i + 1 < args.size()) {
+            iterations = qMax(1, args.at(++i).toInt());
+        } else if (arg == QLatin1String("--scales") && i + 1 < args.size()) {
+            scales.clear();
+            for (const QString &part : args.at(++i).split(QLatin1Char(','), QString::SkipEmptyParts)) {
+                if (part.toInt() > 0) {
+                    scales.append(part.toInt());
+                }
+            }
+        } else if (arg == QLatin1String("--synthetic") && i + 1 < args.size()) {
+            for (const QString &part : args.at(++i).split(QLatin1Char(','), QString::SkipEmptyParts)) {
+                if (part.toInt() > 0) {
+                    syntheticCounts.append(part.toInt());
+                }
+            }
+        } else if (arg == QLatin1String("--seed") && i + 1 < args.size()) {
+            seed = args.at(++i).toUInt();
+        } else if (arg == QLatin1String("--output") && i + 1 < args.size()) {
+            outputPath = args.at(++i);
+        } else if (arg.startsWith(QLatin1String("--"))) {
+            err << "Usage: dbc_bench [--iterations N] [--scales 1,4,16] [--synthetic 1000,5000] [--seed N] [--output FILE] [files...]\n";
+            return 2;
+        } else {
+            inputs.append(arg);
+        }
+    }
+    if (inputs.isEmpty() && syntheticCounts.isEmpty()) {
+        const QDir dataDir(QStringLiteral(DBC_BENCH_DATA_DIR));
+        for (const QString &name : dataDir.entryList(QStringList("*.dbc"), QDir::Files, QDir::Name)) {
+            inputs.append(dataDir.filePath(name));
+        }
+    }
+    if ((inputs.isEmpty() || scales.isEmpty()) && syntheticCounts.isEmpty()) {
+        err << "No input DBC files\n";
+        return 2;
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        err << "Cannot create a temporary directory\n";
+        return 1;
+    }
+
+    QJsonArray results;
+    bool allOk = true;
+    for (const QString &input : inputs) {
+        DbcParser source;
+        if (!source.parseFile(input)) {
+            err << "Failed to parse: " << input << "\n";
+            allOk = false;
+            continue;
+        }
+        for (int scale : scales) {
+            Dataset dataset;
+            dataset.name = QFileInfo(input).fileName();
+            dataset.scale = scale;
+            dataset.dbcPath = input;
+            if (scale > 1) {
+                dataset.dbcPath = workDir.filePath(QString("%1_x%2.dbc").arg(QFileInfo(input).completeBaseName()).arg(scale));
+                QString error;
+                if (!writeScaled(source, scale, dataset.dbcPath, &error)) {
+                    err << "Failed to build scaled dataset: " << error << "\n";
+                    allOk = false;
+                    continue;
+                }
+            }
+            dataset.bytes = QFileInfo(dataset.dbcPath).size();
+            for (const QJsonValue &value : benchDataset(dataset, iterations, workDir.path(), err)) {
+                allOk = allOk && value.toObject().value("ok").toBool();
+                results.append(value);
+            }
+        }
+    }
+
+    // Generated databases (DbcGenerator defaults: CAN FD, 40 signals/message, mixed byte order).
+    for (int count : syntheticCounts) {
+        DbcGenerator::Options options;
+        options.seed = seed;
+        options.messageCount = count;
+        DbcExcelConverter::ImportResult database;
+        DbcGenerator::generate(options, database);
+
+        Dataset dataset;
+        dataset.name = QString("synthetic-%1-seed%2").arg(count).arg(seed);
+        dataset.dbcPath = workDir.filePath(dataset.name + ".dbc");
+        QString error;
+        const bool written = DbcGenerator::writeDbc(dataset.dbcPath, database, &error);
+        database.clear();
+        if (!written) {
+            err << "Failed to write synthetic dataset: " << error << "\n";
+            allOk = false;
+            continue;
+        }
+        dataset.bytes = QFileInfo(dataset.dbcPath).size();
+        for (const QJsonValue &value : benchDataset(dataset, iterations, workDir.path(), err)) {
+            allOk = allOk && value.toObject().value("ok").toBool();
+            results.append(value);
+        }
+    }
+
+    QJsonObject root;
+    root.insert("schema", 1);
+    root.insert("tool", "dbc_bench");
+    root.insert("timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+    root.insert("qtVersion", QString::fromLatin1(qVersion()));
+    root.insert("cpu", QSysInfo::currentCpuArchitecture());
+    root.insert("os", QSysInfo::prettyProductName());
+    root.insert("iterations", iterations);
+    root.insert("seed", static_cast<qint64>(seed));
+    root.insert("peakRssKb", peakRssKb());
+    root.insert("results", results);
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    if (outputPath.isEmpty()) {
+        out << json;
+    } else {
+        QFile file(outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            err << "Cannot write " << outputPath << "\n";
+            return 1;
+        }
+    }
+    return allOk ? 0 : 1;
+}
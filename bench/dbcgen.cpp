@@ -0,0 +1,100 @@
+// dbc_gen: writes a deterministic synthetic database (DBC and/or XLSX) for scale testing.
+//
+// Usage: dbc_gen [--seed N] [--messages N] [--signals N] [--frame-bytes N] [--motorola RATIO]
+//                [--value-tables RATIO] [--value-entries N] [--comment-chars N] [--nodes N]
+//                [--dbc OUT.dbc] [--xlsx OUT.xlsx]
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "canmessage.h"
+#include "dbcgenerator.h"
+
+namespace {
+
+void printUsage(QTextStream &err)
+{
+    err << "Usage: dbc_gen [--seed N] [--messages N] [--signals N] [--frame-bytes N] [--motorola RATIO]\n"
+           "               [--value-tables RATIO] [--value-entries N] [--comment-chars N] [--nodes N]\n"
+           "               [--dbc OUT.dbc] [--xlsx OUT.xlsx]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    DbcGenerator::Options options;
+    QString dbcPath;
+    QString xlsxPath;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (i + 1 >= args.size()) {
+            printUsage(err);
+            return 2;
+        }
+        const QString value = args.at(++i);
+        bool ok = true;
+        if (arg == QLatin1String("--seed")) {
+            options.seed = value.toUInt(&ok);
+        } else if (arg == QLatin1String("--messages")) {
+            options.messageCount = value.toInt(&ok);
+        } else if (arg == QLatin1String("--signals")) {
+            options.signalsPerMessage = value.toInt(&ok);
+        } else if (arg == QLatin1String("--frame-bytes")) {
+            options.frameBytes = value.toInt(&ok);
+        } else if (arg == QLatin1String("--motorola")) {
+            options.motorolaRatio = value.toDouble(&ok);
+        } else if (arg == QLatin1String("--value-tables")) {
+            options.valueTableRatio = value.toDouble(&ok);
+        } else if (arg == QLatin1String("--value-entries")) {
+            options.valueTableEntries = value.toInt(&ok);
+        } else if (arg == QLatin1String("--comment-chars")) {
+            options.commentLength = value.toInt(&ok);
+        } else if (arg == QLatin1String("--nodes")) {
+            options.nodeCount = value.toInt(&ok);
+        } else if (arg == QLatin1String("--dbc")) {
+            dbcPath = value;
+        } else if (arg == QLatin1String("--xlsx")) {
+            xlsxPath = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            err << "Invalid option: " << arg << ' ' << value << "\n";
+            printUsage(err);
+            return 2;
+        }
+    }
+    if (dbcPath.isEmpty() && xlsxPath.isEmpty()) {
+        printUsage(err);
+        return 2;
+    }
+
+    DbcExcelConverter::ImportResult database;
+    DbcGenerator::generate(options, database);
+    int signalCount = 0;
+    for (const CanMessage *message : database.messages) {
+        signalCount += message->getSignals().size();
+    }
+
+    QString error;
+    if (!dbcPath.isEmpty() && !DbcGenerator::writeDbc(dbcPath, database, &error)) {
+        err << "Failed to write " << dbcPath << ": " << error << "\n";
+        database.clear();
+        return 1;
+    }
+    if (!xlsxPath.isEmpty() && !DbcGenerator::writeXlsx(xlsxPath, database, &error)) {
+        err << "Failed to write " << xlsxPath << ": " << error << "\n";
+        database.clear();
+        return 1;
+    }
+    out << "Generated " << database.messages.size() << " messages, " << signalCount
+        << " signals (seed " << options.seed << ")\n";
+    database.clear();
+    return 0;
+}
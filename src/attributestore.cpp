@@ -0,0 +1,448 @@
+#include "attributestore.h"
+
+#include <QLocale>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+struct NameRegistry
+{
+    QReadWriteLock lock;
+    QHash<QString, int> ids;
+    QStringList names;
+};
+
+NameRegistry &nameRegistry()
+{
+    static NameRegistry registry;
+    return registry;
+}
+
+/** Integral values print without exponent (100000000000, not 1e+11); others as the shortest exact form. */
+QString formatNumber(double value)
+{
+    if (std::isfinite(value) && value == std::floor(value) && std::abs(value) < 1e15) {
+        return QString::number(qint64(value));
+    }
+    return QLocale::c().toString(value, 'g', QLocale::FloatingPointShortest);
+}
+
+QString quote(const QString &text)
+{
+    QString escaped = text;
+    escaped.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    escaped.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    return QLatin1Char('"') + escaped + QLatin1Char('"');
+}
+
+/** Strips the quotes of a DBC string token and resolves \" and \\; false when token is not quoted. */
+bool unquote(const QString &token, QString *text)
+{
+    if (token.size() < 2 || !token.startsWith(QLatin1Char('"')) || !token.endsWith(QLatin1Char('"'))) {
+        return false;
+    }
+    text->clear();
+    text->reserve(token.size() - 2);
+    for (int i = 1; i < token.size() - 1; ++i) {
+        QChar c = token.at(i);
+        if (c == QLatin1Char('\\') && i + 1 < token.size() - 1
+            && (token.at(i + 1) == QLatin1Char('"') || token.at(i + 1) == QLatin1Char('\\'))) {
+            c = token.at(++i);
+        }
+        text->append(c);
+    }
+    return true;
+}
+
+bool parseInteger(const QString &text, qint64 *value)
+{
+    bool ok = false;
+    if (text.startsWith(QLatin1String("0x"), Qt::CaseInsensitive)) {
+        *value = text.mid(2).toLongLong(&ok, 16);
+    } else {
+        *value = text.toLongLong(&ok);
+        if (!ok) {
+            // Some tools write integral attributes as reals ("100.0")
+            const double real = text.toDouble(&ok);
+            ok = ok && real == std::floor(real) && std::abs(real) < 9.2e18;
+            *value = ok ? qint64(real) : 0;
+        }
+    }
+    return ok;
+}
+
+const char *scopeKeyword(AttributeStore::Scope scope)
+{
+    switch (scope) {
+    case AttributeStore::Node: return "BU_ ";
+    case AttributeStore::Message: return "BO_ ";
+    case AttributeStore::Signal: return "SG_ ";
+    case AttributeStore::EnvironmentVariable: return "EV_ ";
+    case AttributeStore::Network: break;
+    }
+    return "";
+}
+
+/** Value of an attribute that has no BA_DEF_DEF_. */
+AttributeValue zeroValue(AttributeStore::Type type)
+{
+    switch (type) {
+    case AttributeStore::Float: return AttributeValue::fromReal(0.0);
+    case AttributeStore::String: return AttributeValue::fromText(QString());
+    default: break;
+    }
+    return AttributeValue::fromInteger(0);
+}
+
+const char *typeKeyword(AttributeStore::Type type)
+{
+    switch (type) {
+    case AttributeStore::Int: return "INT";
+    case AttributeStore::Hex: return "HEX";
+    case AttributeStore::Float: return "FLOAT";
+    case AttributeStore::String: return "STRING";
+    case AttributeStore::Enum: return "ENUM";
+    }
+    return "STRING";
+}
+
+} // namespace
+
+AttributeValue AttributeValue::fromInteger(qint64 value)
+{
+    AttributeValue result;
+    result.m_kind = Integer;
+    result.m_integer = value;
+    return result;
+}
+
+AttributeValue AttributeValue::fromReal(double value)
+{
+    AttributeValue result;
+    result.m_kind = Real;
+    result.m_real = value;
+    return result;
+}
+
+AttributeValue AttributeValue::fromText(QString value)
+{
+    AttributeValue result;
+    result.m_kind = Text;
+    result.m_text = std::move(value);
+    return result;
+}
+
+QString AttributeValue::toString() const
+{
+    switch (m_kind) {
+    case Integer: return QString::number(m_integer);
+    case Real: return formatNumber(m_real);
+    case Text: return m_text;
+    }
+    return QString();
+}
+
+bool AttributeValue::operator==(const AttributeValue &other) const
+{
+    if (m_kind != other.m_kind) {
+        return false;
+    }
+    switch (m_kind) {
+    case Integer: return m_integer == other.m_integer;
+    case Real: return m_real == other.m_real;
+    case Text: return m_text == other.m_text;
+    }
+    return false;
+}
+
+const AttributeValue *AttributeValues::find(int id) const
+{
+    const auto it = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), id,
+                                     [](const Entry &entry, int key) { return entry.id < key; });
+    return it != m_entries.constEnd() && it->id == id ? &it->value : nullptr;
+}
+
+void AttributeValues::set(int id, const AttributeValue &value)
+{
+    const auto it = std::lower_bound(m_entries.begin(), m_entries.end(), id,
+                                     [](const Entry &entry, int key) { return entry.id < key; });
+    if (it != m_entries.end() && it->id == id) {
+        it->value = value;
+    } else {
+        m_entries.insert(it, Entry{id, value});
+    }
+}
+
+bool AttributeValues::remove(int id)
+{
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).id == id) {
+            m_entries.remove(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AttributeValues::operator==(const AttributeValues &other) const
+{
+    if (m_entries.size() != other.m_entries.size()) {
+        return false;
+    }
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).id != other.m_entries.at(i).id || m_entries.at(i).value != other.m_entries.at(i).value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AttributeStore::nameId(const QString &name)
+{
+    NameRegistry &registry = nameRegistry();
+    {
+        QReadLocker locker(&registry.lock);
+        const auto it = registry.ids.constFind(name);
+        if (it != registry.ids.constEnd()) {
+            return it.value();
+        }
+    }
+    QWriteLocker locker(&registry.lock);
+    const auto it = registry.ids.constFind(name);
+    if (it != registry.ids.constEnd()) {
+        return it.value();
+    }
+    const int id = registry.names.size();
+    registry.names.append(name);
+    registry.ids.insert(name, id);
+    return id;
+}
+
+QString AttributeStore::nameOf(int id)
+{
+    NameRegistry &registry = nameRegistry();
+    QReadLocker locker(&registry.lock);
+    return id >= 0 && id < registry.names.size() ? registry.names.at(id) : QString();
+}
+
+AttributeStore::ModelField AttributeStore::modelField(int id)
+{
+    static const QHash<int, ModelField> fields = {
+        {nameId(QStringLiteral("BusType")), BusTypeField},
+        {nameId(QStringLiteral("DocumentTitle")), DocumentTitleField},
+        {nameId(QStringLiteral("ChangeHistory")), ChangeHistoryField},
+        {nameId(QStringLiteral("GenMsgCycleTime")), CycleTimeField},
+        {nameId(QStringLiteral("GenMsgCycleTimeFast")), CycleTimeFastField},
+        {nameId(QStringLiteral("GenMsgSendType")), MessageSendTypeField},
+        {nameId(QStringLiteral("VFrameFormat")), FrameFormatField},
+        {nameId(QStringLiteral("GenMsgNrOfRepetition")), RepetitionsField},
+        {nameId(QStringLiteral("GenMsgNrOfRepetitions")), RepetitionsField},
+        {nameId(QStringLiteral("GenMsgDelayTime")), DelayTimeField},
+        {nameId(QStringLiteral("GenSigSendType")), SignalSendTypeField},
+        {nameId(QStringLiteral("GenSigStartValue")), StartValueField},
+        {nameId(QStringLiteral("GenSigSNA")), SnaField},
+    };
+    return fields.value(id, NoModelField);
+}
+
+void AttributeStore::clear()
+{
+    m_definitions.clear();
+    m_index.clear();
+    m_network = AttributeValues();
+    m_nodes.clear();
+}
+
+void AttributeStore::define(const Definition &definition)
+{
+    const auto it = m_index.constFind(definition.id);
+    if (it != m_index.constEnd()) {
+        m_definitions[it.value()] = definition;
+        return;
+    }
+    m_index.insert(definition.id, m_definitions.size());
+    m_definitions.append(definition);
+}
+
+const AttributeStore::Definition *AttributeStore::definition(int id) const
+{
+    const auto it = m_index.constFind(id);
+    return it != m_index.constEnd() ? &m_definitions.at(it.value()) : nullptr;
+}
+
+bool AttributeStore::setDefault(int id, const AttributeValue &value)
+{
+    const auto it = m_index.constFind(id);
+    if (it == m_index.constEnd()) {
+        return false;
+    }
+    Definition &definition = m_definitions[it.value()];
+    definition.hasDefault = true;
+    definition.defaultValue = value;
+    return true;
+}
+
+void AttributeStore::removeDefinition(int id)
+{
+    const auto it = m_index.constFind(id);
+    if (it == m_index.constEnd()) {
+        return;
+    }
+    m_definitions.remove(it.value());
+    m_index.clear();
+    for (int i = 0; i < m_definitions.size(); ++i) {
+        m_index.insert(m_definitions.at(i).id, i);
+    }
+    m_network.remove(id);
+    for (auto node = m_nodes.begin(); node != m_nodes.end();) {
+        node.value().remove(id);
+        node = node.value().isEmpty() ? m_nodes.erase(node) : std::next(node);
+    }
+}
+
+bool AttributeStore::parseValue(int id, const QString &token, AttributeValue *value, QString *error) const
+{
+    const Definition *def = definition(id);
+    if (!def) {
+        if (error) {
+            *error = QStringLiteral("Attribute %1 is not defined").arg(nameOf(id));
+        }
+        return false;
+    }
+    QString text;
+    const bool quoted = unquote(token, &text);
+    if (!quoted) {
+        text = token;
+    }
+    bool ok = false;
+    switch (def->type) {
+    case Int:
+    case Hex: {
+        qint64 integer = 0;
+        ok = parseInteger(text.trimmed(), &integer);
+        *value = AttributeValue::fromInteger(integer);
+        break;
+    }
+    case Float: {
+        const double real = text.trimmed().toDouble(&ok);
+        *value = AttributeValue::fromReal(real);
+        break;
+    }
+    case String:
+        ok = true;
+        *value = AttributeValue::fromText(text);
+        break;
+    case Enum: {
+        qint64 index = def->enumValues.indexOf(text);
+        ok = index >= 0;
+        if (!ok && !quoted) {
+            ok = parseInteger(text.trimmed(), &index) && index >= 0 && index < def->enumValues.size();
+        }
+        *value = AttributeValue::fromInteger(index);
+        break;
+    }
+    }
+    if (!ok && error) {
+        *error = QStringLiteral("Invalid %1 value %2 for attribute %3")
+                     .arg(QLatin1String(typeKeyword(def->type)), token, nameOf(id));
+    }
+    return ok;
+}
+
+QString AttributeStore::formatValue(int id, const AttributeValue &value, bool enumName) const
+{
+    const Definition *def = definition(id);
+    const Type type = def ? def->type : (value.kind() == AttributeValue::Text ? String : Int);
+    switch (type) {
+    case Int:
+    case Hex:
+        return QString::number(value.integer());
+    case Float:
+        return formatNumber(value.real());
+    case String:
+        return quote(value.text());
+    case Enum:
+        if (enumName && def) {
+            return quote(def->enumValues.value(int(value.integer())));
+        }
+        return QString::number(value.integer());
+    }
+    return QString();
+}
+
+QString AttributeStore::formatDefinition(const Definition &definition) const
+{
+    QString text = QLatin1String(scopeKeyword(definition.scope)) + quote(definition.name()) + QLatin1Char(' ')
+                   + QLatin1String(typeKeyword(definition.type));
+    switch (definition.type) {
+    case Int:
+    case Hex:
+    case Float:
+        text += QLatin1Char(' ') + formatNumber(definition.minimum) + QLatin1Char(' ') + formatNumber(definition.maximum);
+        break;
+    case String:
+        text += QLatin1Char(' ');
+        break;
+    case Enum: {
+        QStringList values;
+        for (const QString &value : definition.enumValues) {
+            values.append(quote(value));
+        }
+        text += QLatin1Char(' ') + values.join(QLatin1Char(','));
+        break;
+    }
+    }
+    return text;
+}
+
+QString AttributeStore::formatDefault(const Definition &definition) const
+{
+    return quote(definition.name()) + QLatin1Char(' ') + formatValue(definition.id, definition.defaultValue, true);
+}
+
+AttributeValue AttributeStore::value(int id, const AttributeValues &values) const
+{
+    if (const AttributeValue *stored = values.find(id)) {
+        return *stored;
+    }
+    const Definition *def = definition(id);
+    if (!def) {
+        return AttributeValue();
+    }
+    return def->hasDefault ? def->defaultValue : zeroValue(def->type);
+}
+
+void AttributeStore::setValue(AttributeValues *values, int id, const AttributeValue &value) const
+{
+    const Definition *def = definition(id);
+    if (def && def->hasDefault && def->defaultValue == value) {
+        values->remove(id);
+    } else {
+        values->set(id, value);
+    }
+}
+
+void AttributeStore::setNodeValue(const QString &node, int id, const AttributeValue &value)
+{
+    AttributeValues &values = m_nodes[node];
+    setValue(&values, id, value);
+    if (values.isEmpty()) {
+        m_nodes.remove(node);
+    }
+}
+
+void AttributeStore::setNodeValues(const QString &node, AttributeValues values)
+{
+    if (values.isEmpty()) {
+        m_nodes.remove(node);
+    } else {
+        m_nodes.insert(node, std::move(values));
+    }
+}
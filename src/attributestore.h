@@ -0,0 +1,187 @@
+#ifndef ATTRIBUTESTORE_H
+#define ATTRIBUTESTORE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+#include <utility>
+
+/** One attribute value: an integer (INT, HEX and ENUM index), a real (FLOAT) or a text (STRING). */
+class AttributeValue
+{
+public:
+    enum Kind
+    {
+        Integer,
+        Real,
+        Text
+    };
+
+    AttributeValue() = default;
+    static AttributeValue fromInteger(qint64 value);
+    static AttributeValue fromReal(double value);
+    static AttributeValue fromText(QString value);
+
+    Kind kind() const { return m_kind; }
+    qint64 integer() const { return m_kind == Real ? qint64(m_real) : m_integer; }
+    double real() const { return m_kind == Real ? m_real : double(m_integer); }
+    const QString &text() const { return m_text; }
+    /** Plain text for reports and diffs (no DBC quoting, enum values as index). */
+    QString toString() const;
+
+    bool operator==(const AttributeValue &other) const;
+    bool operator!=(const AttributeValue &other) const { return !(*this == other); }
+
+private:
+    Kind m_kind = Integer;
+    union {
+        qint64 m_integer = 0;
+        double m_real;
+    };
+    QString m_text;
+};
+
+/**
+ * Attribute values explicitly set on one object (message, signal, node or the network),
+ * sorted by attribute ID. Attributes left at their default are not stored, so an object
+ * without overrides holds an empty vector and allocates nothing.
+ */
+class AttributeValues
+{
+public:
+    struct Entry
+    {
+        int id;
+        AttributeValue value;
+    };
+
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    int size() const { return m_entries.size(); }
+    const AttributeValue *find(int id) const;
+    void set(int id, const AttributeValue &value);
+    bool remove(int id);
+
+    QVector<Entry>::const_iterator begin() const { return m_entries.constBegin(); }
+    QVector<Entry>::const_iterator end() const { return m_entries.constEnd(); }
+
+    bool operator==(const AttributeValues &other) const;
+    bool operator!=(const AttributeValues &other) const { return !(*this == other); }
+
+private:
+    QVector<Entry> m_entries;
+};
+
+/**
+ * Typed DBC attribute model: BA_DEF_ definitions (INT, HEX, FLOAT, STRING, ENUM at network,
+ * node, message, signal and environment-variable scope), BA_DEF_DEF_ defaults and the
+ * network and node values. Message and signal values live on CanMessage/CanSignal.
+ *
+ * Attributes are identified by an ID interned per name for the whole process, so values
+ * of different databases (snapshots, diff, merge) compare without going through names.
+ */
+class AttributeStore
+{
+public:
+    enum Scope
+    {
+        Network,
+        Node,
+        Message,
+        Signal,
+        EnvironmentVariable
+    };
+
+    enum Type
+    {
+        Int,
+        Hex,
+        Float,
+        String,
+        Enum
+    };
+
+    /** Attributes the parser maps onto model fields and the writer regenerates from them. */
+    enum ModelField
+    {
+        NoModelField,
+        BusTypeField,
+        DocumentTitleField,
+        ChangeHistoryField,
+        CycleTimeField,
+        CycleTimeFastField,
+        MessageSendTypeField,
+        FrameFormatField,
+        RepetitionsField,
+        DelayTimeField,
+        SignalSendTypeField,
+        StartValueField,
+        SnaField
+    };
+
+    struct Definition
+    {
+        int id = -1;
+        Scope scope = Network;
+        Type type = Int;
+        double minimum = 0.0;   // INT, HEX, FLOAT
+        double maximum = 0.0;
+        QStringList enumValues;
+        bool hasDefault = false;
+        AttributeValue defaultValue;
+
+        QString name() const { return AttributeStore::nameOf(id); }
+    };
+
+    /** ID of an attribute name, interning it on first use (thread-safe). */
+    static int nameId(const QString &name);
+    static QString nameOf(int id);
+    static ModelField modelField(int id);
+    static bool isModelAttribute(int id) { return modelField(id) != NoModelField; }
+
+    bool isEmpty() const { return m_definitions.isEmpty(); }
+    void clear();
+
+    /** Adds a definition, or replaces the one with the same name in place. */
+    void define(const Definition &definition);
+    bool contains(int id) const { return m_index.contains(id); }
+    const Definition *definition(int id) const;
+    /** Definitions in declaration order. */
+    const QVector<Definition> &definitions() const { return m_definitions; }
+    bool setDefault(int id, const AttributeValue &value);
+    /** Drops a definition together with its network and node values. */
+    void removeDefinition(int id);
+
+    /**
+     * Parses a DBC value token (number or quoted string) for attribute id. ENUM accepts an
+     * index or a quoted enumerator name. Returns false for unknown IDs and invalid tokens.
+     */
+    bool parseValue(int id, const QString &token, AttributeValue *value, QString *error = nullptr) const;
+    /** DBC token for a value; ENUM values are written as an index, or as a quoted name with enumName. */
+    QString formatValue(int id, const AttributeValue &value, bool enumName = false) const;
+    /** BA_DEF_ / BA_DEF_DEF_ record bodies, without the leading keyword. */
+    QString formatDefinition(const Definition &definition) const;
+    QString formatDefault(const Definition &definition) const;
+
+    /** The value stored in values, else the definition default. */
+    AttributeValue value(int id, const AttributeValues &values) const;
+    /** Stores value in values, or removes the entry when value equals the default. */
+    void setValue(AttributeValues *values, int id, const AttributeValue &value) const;
+
+    const AttributeValues &networkValues() const { return m_network; }
+    void setNetworkValue(int id, const AttributeValue &value) { setValue(&m_network, id, value); }
+    void setNetworkValues(AttributeValues values) { m_network = std::move(values); }
+    const QHash<QString, AttributeValues> &nodeValues() const { return m_nodes; }
+    void setNodeValue(const QString &node, int id, const AttributeValue &value);
+    void setNodeValues(const QString &node, AttributeValues values);
+
+private:
+    QVector<Definition> m_definitions;
+    QHash<int, int> m_index; // attribute ID -> position in m_definitions
+    AttributeValues m_network;
+    QHash<QString, AttributeValues> m_nodes;
+};
+
+#endif // ATTRIBUTESTORE_H
@@ -1,12 +1,7 @@
 #include "canmessage.h"
 
 CanMessage::CanMessage()
-    : m_id(0)
-    , m_length(0)
-    , m_cycleTime(0)
-    , m_cycleTimeFast(0)
-    , m_nrOfRepetitions(0)
-    , m_delayTime(0)
+    : d(new CanMessageData)
 {
 }
 
@@ -49,10 +44,40 @@ void CanMessage::insertSignal(int index, CanSignal *signal)
 
 QString CanMessage::getFormattedId() const
 {
-    return QString("0x%1").arg(m_id, 0, 16).toUpper();
+    return QString("0x%1").arg(d->id, 0, 16).toUpper();
 }
 
 QString CanMessage::getFormattedLength() const
 {
-    return QString("%1 bytes").arg(m_length);
+    return QString("%1 bytes").arg(d->length);
+}
+
+CanMessage CanMessage::fieldsOnly() const
+{
+    CanMessage copy;
+    copy.d = d;
+    return copy;
+}
+
+bool CanMessage::hasSameFields(const CanMessage &other) const
+{
+    if (d == other.d) {
+        return true;
+    }
+    const CanMessageData &a = *d;
+    const CanMessageData &b = *other.d;
+    return a.id == b.id
+        && a.name == b.name
+        && a.length == b.length
+        && a.transmitter == b.transmitter
+        && a.cycleTime == b.cycleTime
+        && a.frameFormat == b.frameFormat
+        && a.sendType == b.sendType
+        && a.cycleTimeFast == b.cycleTimeFast
+        && a.nrOfRepetitions == b.nrOfRepetitions
+        && a.delayTime == b.delayTime
+        && a.comment == b.comment
+        && a.messageType == b.messageType
+        && a.receivers == b.receivers
+        && a.attributes == b.attributes;
 }
@@ -6,67 +6,90 @@
 #include <QMap>
 #include <QStringList>
 #include <QtGlobal>
+#include <QSharedData>
+#include <QSharedDataPointer>
 #include "cansignal.h"
 
+/** Field storage of CanMessage (everything except the signal list). */
+class CanMessageData : public QSharedData
+{
+public:
+    quint32 id = 0;
+    QString name;
+    int length = 0;
+    QString transmitter;
+    int cycleTime = 0; // in ms
+    QString frameFormat;
+    QString sendType;
+    int cycleTimeFast = 0;
+    int nrOfRepetitions = 0;
+    int delayTime = 0;
+    QString comment;
+    QString messageType;
+    QStringList receivers;
+    AttributeValues attributes; // BA_ values other than the fields above
+};
+
+/**
+ * CAN message definition. The fields are implicitly shared (see CanMessageData); the
+ * signal list holds the live, individually owned CanSignal objects.
+ */
 class CanMessage
 {
 public:
     CanMessage();
     
     // Getters
-    quint32 getId() const { return m_id; }
-    QString getName() const { return m_name; }
-    int getLength() const { return m_length; }
-    QString getTransmitter() const { return m_transmitter; }
-    QList<CanSignal*> getSignals() const { return m_signals; }
+    quint32 getId() const { return d->id; }
+    const QString &getName() const { return d->name; }
+    int getLength() const { return d->length; }
+    const QString &getTransmitter() const { return d->transmitter; }
+    const QList<CanSignal*> &getSignals() const { return m_signals; }
     CanSignal* getSignal(const QString &name) const;
-    int getCycleTime() const { return m_cycleTime; }
-    QString getFrameFormat() const { return m_frameFormat; }
-    QString getSendType() const { return m_sendType; }
-    int getCycleTimeFast() const { return m_cycleTimeFast; }
-    int getNrOfRepetitions() const { return m_nrOfRepetitions; }
-    int getDelayTime() const { return m_delayTime; }
-    QString getComment() const { return m_comment; }
-    QString getMessageType() const { return m_messageType; }
-    QStringList getReceivers() const { return m_receivers; }
+    int getCycleTime() const { return d->cycleTime; }
+    const QString &getFrameFormat() const { return d->frameFormat; }
+    const QString &getSendType() const { return d->sendType; }
+    int getCycleTimeFast() const { return d->cycleTimeFast; }
+    int getNrOfRepetitions() const { return d->nrOfRepetitions; }
+    int getDelayTime() const { return d->delayTime; }
+    const QString &getComment() const { return d->comment; }
+    const QString &getMessageType() const { return d->messageType; }
+    const QStringList &getReceivers() const { return d->receivers; }
+    const AttributeValues &getAttributes() const { return d->attributes; }
     
     // Setters
-    void setId(quint32 id) { m_id = id; }
-    void setName(const QString &name) { m_name = name; }
-    void setLength(int length) { m_length = length; }
-    void setTransmitter(const QString &transmitter) { m_transmitter = transmitter; }
+    void setId(quint32 id) { d->id = id; }
+    void setName(QString name) { d->name = std::move(name); }
+    void setLength(int length) { d->length = length; }
+    void setTransmitter(QString transmitter) { d->transmitter = std::move(transmitter); }
     void addSignal(CanSignal *signal);
     void removeSignal(CanSignal *signal);
     void insertSignal(int index, CanSignal *signal);
-    void setCycleTime(int cycleTime) { m_cycleTime = cycleTime; }
-    void setFrameFormat(const QString &frameFormat) { m_frameFormat = frameFormat; }
-    void setSendType(const QString &sendType) { m_sendType = sendType; }
-    void setCycleTimeFast(int value) { m_cycleTimeFast = value; }
-    void setNrOfRepetitions(int value) { m_nrOfRepetitions = value; }
-    void setDelayTime(int value) { m_delayTime = value; }
-    void setComment(const QString &comment) { m_comment = comment; }
-    void setMessageType(const QString &type) { m_messageType = type; }
-    void setReceivers(const QStringList &receivers) { m_receivers = receivers; }
+    void setCycleTime(int cycleTime) { d->cycleTime = cycleTime; }
+    void setFrameFormat(QString frameFormat) { d->frameFormat = std::move(frameFormat); }
+    void setSendType(QString sendType) { d->sendType = std::move(sendType); }
+    void setCycleTimeFast(int value) { d->cycleTimeFast = value; }
+    void setNrOfRepetitions(int value) { d->nrOfRepetitions = value; }
+    void setDelayTime(int value) { d->delayTime = value; }
+    void setComment(QString comment) { d->comment = std::move(comment); }
+    void setMessageType(QString type) { d->messageType = std::move(type); }
+    void setReceivers(QStringList receivers) { d->receivers = std::move(receivers); }
+    void setAttributes(AttributeValues attributes) { d->attributes = std::move(attributes); }
     
     // Utility functions
     QString getFormattedId() const;
     QString getFormattedLength() const;
 
+    /** O(1) copy sharing this message's fields, with an empty signal list (for snapshots). */
+    CanMessage fieldsOnly() const;
+    /** True when both still reference the same field data (signals not included). */
+    bool sharesFieldsWith(const CanMessage &other) const { return d == other.d; }
+    /** Field-by-field equality, ignoring the signal list; O(1) when the data is shared. */
+    bool hasSameFields(const CanMessage &other) const;
+
 private:
-    quint32 m_id;
-    QString m_name;
-    int m_length;
-    QString m_transmitter;
+    QSharedDataPointer<CanMessageData> d;
     QList<CanSignal*> m_signals;
-    int m_cycleTime; // in ms
-    QString m_frameFormat;
-    QString m_sendType;
-    int m_cycleTimeFast;
-    int m_nrOfRepetitions;
-    int m_delayTime;
-    QString m_comment;
-    QString m_messageType;
-    QStringList m_receivers;
 };
 
 #endif // CANMESSAGE_H
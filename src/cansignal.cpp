@@ -1,37 +1,60 @@
 #include "cansignal.h"
 
 CanSignal::CanSignal()
-    : m_startBit(0)
-    , m_length(1)
-    , m_byteOrder(0)
-    , m_isSigned(false)
-    , m_factor(1.0)
-    , m_offset(0.0)
-    , m_min(0.0)
-    , m_max(0.0)
-    , m_initialValue(0.0)
+    : d(new CanSignalData)
 {
 }
 
 double CanSignal::rawToPhysical(int rawValue) const
 {
-    return rawValue * m_factor + m_offset;
+    return rawValue * d->factor + d->offset;
 }
 
 int CanSignal::physicalToRaw(double physicalValue) const
 {
-    return static_cast<int>((physicalValue - m_offset) / m_factor);
+    return static_cast<int>((physicalValue - d->offset) / d->factor);
 }
 
 QString CanSignal::getValueDescription(int rawValue) const
 {
-    if (m_valueTable.contains(rawValue)) {
-        return m_valueTable[rawValue];
+    const auto it = d->valueTable.constFind(rawValue);
+    if (it != d->valueTable.constEnd()) {
+        return it.value();
     }
     return QString::number(rawValue);
 }
 
 QString CanSignal::getReceiversAsString() const
 {
-    return m_receivers.join(", ");
+    return d->receivers.join(", ");
+}
+
+bool CanSignal::operator==(const CanSignal &other) const
+{
+    if (d == other.d) {
+        return true;
+    }
+    const CanSignalData &a = *d;
+    const CanSignalData &b = *other.d;
+    return a.name == b.name
+        && a.startBit == b.startBit
+        && a.length == b.length
+        && a.byteOrder == b.byteOrder
+        && a.isSigned == b.isSigned
+        && a.factor == b.factor
+        && a.offset == b.offset
+        && a.min == b.min
+        && a.max == b.max
+        && a.unit == b.unit
+        && a.receivers == b.receivers
+        && a.description == b.description
+        && a.sendType == b.sendType
+        && a.initialValue == b.initialValue
+        && a.invalidValueHex == b.invalidValueHex
+        && a.inactiveValueHex == b.inactiveValueHex
+        && a.valueTable == b.valueTable
+        && a.hasRawRange == b.hasRawRange
+        && a.rawMin == b.rawMin
+        && a.rawMax == b.rawMax
+        && a.attributes == b.attributes;
 }
@@ -4,83 +4,109 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QSharedData>
+#include <QSharedDataPointer>
 
+#include <utility>
+
+#include "attributestore.h"
+
+/** Field storage of CanSignal; shared between copies until one of them is modified. */
+class CanSignalData : public QSharedData
+{
+public:
+    QString name;
+    int startBit = 0;
+    int length = 1;
+    int byteOrder = 0; // 0 = little endian, 1 = big endian
+    bool isSigned = false;
+    double factor = 1.0;
+    double offset = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    QString unit;
+    QStringList receivers;
+    QString description;
+    QString sendType;
+    double initialValue = 0.0;
+    QString invalidValueHex;
+    QString inactiveValueHex;
+    QMap<int, QString> valueTable; // Raw value -> Description mapping
+    bool hasRawRange = false;
+    double rawMin = 0.0;
+    double rawMax = 0.0;
+    AttributeValues attributes; // BA_ values other than the fields above
+};
+
+/**
+ * CAN signal definition. Implicitly shared: copying is O(1) and setters copy the field
+ * data only when another CanSignal (e.g. a snapshot) still references it.
+ */
 class CanSignal
 {
 public:
     CanSignal();
-    
+
     // Getters
-    QString getName() const { return m_name; }
-    int getStartBit() const { return m_startBit; }
-    int getLength() const { return m_length; }
-    int getByteOrder() const { return m_byteOrder; }
-    bool isSigned() const { return m_isSigned; }
-    double getFactor() const { return m_factor; }
-    double getOffset() const { return m_offset; }
-    double getMin() const { return m_min; }
-    double getMax() const { return m_max; }
-    QString getUnit() const { return m_unit; }
-    QStringList getReceivers() const { return m_receivers; }
-    QMap<int, QString> getValueTable() const { return m_valueTable; }
-    QString getDescription() const { return m_description; }
-    QString getSendType() const { return m_sendType; }
-    double getInitialValue() const { return m_initialValue; }
-    QString getInvalidValueHex() const { return m_invalidValueHex; }
-    QString getInactiveValueHex() const { return m_inactiveValueHex; }
+    const QString &getName() const { return d->name; }
+    int getStartBit() const { return d->startBit; }
+    int getLength() const { return d->length; }
+    int getByteOrder() const { return d->byteOrder; }
+    bool isSigned() const { return d->isSigned; }
+    double getFactor() const { return d->factor; }
+    double getOffset() const { return d->offset; }
+    double getMin() const { return d->min; }
+    double getMax() const { return d->max; }
+    const QString &getUnit() const { return d->unit; }
+    const QStringList &getReceivers() const { return d->receivers; }
+    const QMap<int, QString> &getValueTable() const { return d->valueTable; }
+    const QString &getDescription() const { return d->description; }
+    const QString &getSendType() const { return d->sendType; }
+    double getInitialValue() const { return d->initialValue; }
+    const QString &getInvalidValueHex() const { return d->invalidValueHex; }
+    const QString &getInactiveValueHex() const { return d->inactiveValueHex; }
     // Raw (bus) range imported from Excel hex columns, optional
-    bool hasRawRange() const { return m_hasRawRange; }
-    double getRawMin() const { return m_rawMin; }
-    double getRawMax() const { return m_rawMax; }
+    bool hasRawRange() const { return d->hasRawRange; }
+    double getRawMin() const { return d->rawMin; }
+    double getRawMax() const { return d->rawMax; }
+    const AttributeValues &getAttributes() const { return d->attributes; }
     QString getReceiversAsString() const;
-    
+
     // Setters
-    void setName(const QString &name) { m_name = name; }
-    void setStartBit(int startBit) { m_startBit = startBit; }
-    void setLength(int length) { m_length = length; }
-    void setByteOrder(int byteOrder) { m_byteOrder = byteOrder; }
-    void setSigned(bool isSigned) { m_isSigned = isSigned; }
-    void setFactor(double factor) { m_factor = factor; }
-    void setOffset(double offset) { m_offset = offset; }
-    void setMin(double min) { m_min = min; }
-    void setMax(double max) { m_max = max; }
-    void setUnit(const QString &unit) { m_unit = unit; }
-    void setReceivers(const QStringList &receivers) { m_receivers = receivers; }
-    void setValueTable(const QMap<int, QString> &valueTable) { m_valueTable = valueTable; }
-    void setDescription(const QString &description) { m_description = description; }
-    void setSendType(const QString &sendType) { m_sendType = sendType; }
-    void setInitialValue(double initialValue) { m_initialValue = initialValue; }
-    void setInvalidValueHex(const QString &value) { m_invalidValueHex = value; }
-    void setInactiveValueHex(const QString &value) { m_inactiveValueHex = value; }
-    void setRawRange(double rawMin, double rawMax) { m_rawMin = rawMin; m_rawMax = rawMax; m_hasRawRange = true; }
-    void clearRawRange() { m_rawMin = 0.0; m_rawMax = 0.0; m_hasRawRange = false; }
-    
+    void setName(QString name) { d->name = std::move(name); }
+    void setStartBit(int startBit) { d->startBit = startBit; }
+    void setLength(int length) { d->length = length; }
+    void setByteOrder(int byteOrder) { d->byteOrder = byteOrder; }
+    void setSigned(bool isSigned) { d->isSigned = isSigned; }
+    void setFactor(double factor) { d->factor = factor; }
+    void setOffset(double offset) { d->offset = offset; }
+    void setMin(double min) { d->min = min; }
+    void setMax(double max) { d->max = max; }
+    void setUnit(QString unit) { d->unit = std::move(unit); }
+    void setReceivers(QStringList receivers) { d->receivers = std::move(receivers); }
+    void setValueTable(QMap<int, QString> valueTable) { d->valueTable = std::move(valueTable); }
+    void setDescription(QString description) { d->description = std::move(description); }
+    void setSendType(QString sendType) { d->sendType = std::move(sendType); }
+    void setInitialValue(double initialValue) { d->initialValue = initialValue; }
+    void setInvalidValueHex(QString value) { d->invalidValueHex = std::move(value); }
+    void setInactiveValueHex(QString value) { d->inactiveValueHex = std::move(value); }
+    void setRawRange(double rawMin, double rawMax) { d->rawMin = rawMin; d->rawMax = rawMax; d->hasRawRange = true; }
+    void clearRawRange() { d->rawMin = 0.0; d->rawMax = 0.0; d->hasRawRange = false; }
+    void setAttributes(AttributeValues attributes) { d->attributes = std::move(attributes); }
+
     // Utility functions
     double rawToPhysical(int rawValue) const;
     int physicalToRaw(double physicalValue) const;
     QString getValueDescription(int rawValue) const;
 
+    /** True when both still reference the same field data (no copy has been made since). */
+    bool isSharedWith(const CanSignal &other) const { return d == other.d; }
+    /** Field-by-field equality; O(1) when the data is shared. */
+    bool operator==(const CanSignal &other) const;
+    bool operator!=(const CanSignal &other) const { return !(*this == other); }
+
 private:
-    QString m_name;
-    int m_startBit;
-    int m_length;
-    int m_byteOrder; // 0 = little endian, 1 = big endian
-    bool m_isSigned;
-    double m_factor;
-    double m_offset;
-    double m_min;
-    double m_max;
-    QString m_unit;
-    QStringList m_receivers;
-    QString m_description;
-    QString m_sendType;
-    double m_initialValue;
-    QString m_invalidValueHex;
-    QString m_inactiveValueHex;
-    QMap<int, QString> m_valueTable; // Raw value -> Description mapping
-    bool m_hasRawRange = false;
-    double m_rawMin = 0.0;
-    double m_rawMax = 0.0;
+    QSharedDataPointer<CanSignalData> d;
 };
 
 #endif // CANSIGNAL_H
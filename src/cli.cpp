@@ -0,0 +1,692 @@
+#include "cli.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFuture>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "cansignal.h"
+#include "codegenerator.h"
+#include "dbcdiff.h"
+#include "dbcexcelconverter.h"
+#include "dbcmerge.h"
+#include "dbcparser.h"
+#include "dbcsnapshot.h"
+#include "dbcvalidator.h"
+#include "dbcwriter.h"
+
+namespace {
+
+const QStringList kCommands = { QStringLiteral("convert"), QStringLiteral("validate"), QStringLiteral("stats"),
+                                QStringLiteral("diff"), QStringLiteral("merge"), QStringLiteral("report"),
+                                QStringLiteral("codegen") };
+const QStringList kInputFilters = { QStringLiteral("*.dbc"), QStringLiteral("*.xlsx") };
+
+struct Options
+{
+    QString command;
+    QStringList inputs;
+    QString target;     // convert: "xlsx", "dbc" or empty (opposite of the input format)
+    QString outDir;
+    DbcExcelConverter::CompressionLevel compression = DbcExcelConverter::CompressionBalanced;
+    bool splitByEcu = true;
+    bool json = false;
+    int jobs = 0;
+    QString historyVersion;  // diff: emit change-history rows for this protocol version
+    QString changer;
+    QString output;          // merge: result path (default: overwrite ours, as a git merge driver expects)
+    CodeGenerator::Options codegen;
+};
+
+/** Outcome of one input file; printed by the main thread in input order. */
+struct FileReport
+{
+    bool ok = false;
+    QStringList output;   // stdout lines
+    QStringList errors;   // stderr lines
+    QJsonObject json;
+};
+
+void printUsage(QTextStream &err)
+{
+    err << "Usage:\n"
+           "  DBCViewer convert  <inputs...> [--to xlsx|dbc] [--out-dir DIR]\n"
+           "                     [--compression store|fast|balanced|best] [--single-sheet] [--jobs N]\n"
+           "  DBCViewer validate <inputs...> [--jobs N]\n"
+           "  DBCViewer stats    <inputs...> [--json] [--jobs N]\n"
+           "  DBCViewer report   <inputs...> [--json] [--jobs N]\n"
+           "  DBCViewer diff     <before> <after> [--json] [--history VERSION [--changer NAME]]\n"
+           "  DBCViewer merge    <base> <ours> <theirs> [-o OUT] [--json]\n"
+           "  DBCViewer codegen  <input> [--lang c|c++] [--prefix NAME] [--out-dir DIR]\n"
+           "                     [--self-check VECTORS] [--seed N]\n"
+           "Inputs may be files, directories or wildcard patterns (*.dbc, *.xlsx).\n"
+           "Exit codes: 0 success, 1 a file failed, 2 usage error.\n"
+           "diff exits with 0 when identical, 1 when different, 2 on error;\n"
+           "merge exits with 0 when clean, 1 on conflicts, 2 on error.\n";
+}
+
+bool isXlsx(const QString &path)
+{
+    return path.endsWith(QStringLiteral(".xlsx"), Qt::CaseInsensitive);
+}
+
+bool parseOptions(const QStringList &args, Options *options, QString *error)
+{
+    options->command = args.value(0);
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        auto value = [&](QString *out) {
+            if (i + 1 >= args.size()) {
+                *error = QString("%1 expects a value").arg(arg);
+                return false;
+            }
+            *out = args.at(++i);
+            return true;
+        };
+        QString text;
+        if (arg == QLatin1String("--to") && options->command == QLatin1String("convert")) {
+            if (!value(&options->target)) {
+                return false;
+            }
+            options->target = options->target.toLower();
+            if (options->target != QLatin1String("xlsx") && options->target != QLatin1String("dbc")) {
+                *error = "--to expects xlsx or dbc";
+                return false;
+            }
+        } else if (arg == QLatin1String("--out-dir")
+                   && (options->command == QLatin1String("convert") || options->command == QLatin1String("codegen"))) {
+            if (!value(&options->outDir)) {
+                return false;
+            }
+        } else if (arg == QLatin1String("--compression") && options->command == QLatin1String("convert")) {
+            if (!value(&text) || !DbcExcelConverter::compressionLevelFromString(text, &options->compression)) {
+                *error = "--compression expects one of: store, fast, balanced, best";
+                return false;
+            }
+        } else if (arg == QLatin1String("--single-sheet") && options->command == QLatin1String("convert")) {
+            options->splitByEcu = false;
+        } else if (arg == QLatin1String("--json") && options->command != QLatin1String("convert")
+                   && options->command != QLatin1String("validate")) {
+            options->json = true;
+        } else if (arg == QLatin1String("--history") && options->command == QLatin1String("diff")) {
+            if (!value(&options->historyVersion)) {
+                return false;
+            }
+        } else if (arg == QLatin1String("--changer") && options->command == QLatin1String("diff")) {
+            if (!value(&options->changer)) {
+                return false;
+            }
+        } else if ((arg == QLatin1String("--output") || arg == QLatin1String("-o"))
+                   && options->command == QLatin1String("merge")) {
+            if (!value(&options->output)) {
+                return false;
+            }
+        } else if (arg == QLatin1String("--lang") && options->command == QLatin1String("codegen")) {
+            if (!value(&text) || !CodeGenerator::languageFromString(text, &options->codegen.language)) {
+                *error = "--lang expects c or c++";
+                return false;
+            }
+        } else if (arg == QLatin1String("--prefix") && options->command == QLatin1String("codegen")) {
+            if (!value(&options->codegen.prefix)) {
+                return false;
+            }
+        } else if (arg == QLatin1String("--self-check") && options->command == QLatin1String("codegen")) {
+            bool ok = false;
+            if (value(&text)) {
+                options->codegen.selfCheckVectors = text.toInt(&ok);
+            }
+            if (!ok || options->codegen.selfCheckVectors < 1) {
+                *error = "--self-check expects a positive number of vectors";
+                return false;
+            }
+        } else if (arg == QLatin1String("--seed") && options->command == QLatin1String("codegen")) {
+            bool ok = false;
+            if (value(&text)) {
+                options->codegen.seed = text.toUInt(&ok);
+            }
+            if (!ok) {
+                *error = "--seed expects a number";
+                return false;
+            }
+        } else if (arg == QLatin1String("--jobs") || arg == QLatin1String("-j")) {
+            bool ok = false;
+            if (value(&text)) {
+                options->jobs = text.toInt(&ok);
+            }
+            if (!ok || options->jobs < 1) {
+                *error = "--jobs expects a positive number";
+                return false;
+            }
+        } else if (arg.startsWith(QLatin1String("--"))) {
+            *error = QString("Unknown option for %1: %2").arg(options->command, arg);
+            return false;
+        } else {
+            options->inputs.append(arg);
+        }
+    }
+    if (options->inputs.isEmpty()) {
+        *error = "No input files given";
+        return false;
+    }
+    if (options->command == QLatin1String("diff") && options->inputs.size() != 2) {
+        *error = "diff expects exactly two files";
+        return false;
+    }
+    if (options->command == QLatin1String("merge") && options->inputs.size() != 3) {
+        *error = "merge expects base, ours and theirs";
+        return false;
+    }
+    if (options->command == QLatin1String("codegen") && options->inputs.size() != 1) {
+        *error = "codegen expects exactly one input";
+        return false;
+    }
+    return true;
+}
+
+/** Loads a .dbc or .xlsx into parser. */
+bool loadDatabase(const QString &path, DbcParser &parser, QString *error)
+{
+    if (isXlsx(path)) {
+        DbcExcelConverter::ImportResult result;
+        if (!DbcExcelConverter::importFromExcel(path, result, error)) {
+            return false;
+        }
+        parser.loadFromExcelImport(result);
+        return true;
+    }
+    if (!parser.parseFile(path)) {
+        *error = "Failed to parse DBC file";
+        return false;
+    }
+    return true;
+}
+
+/** Output path of convert for one input: same base name, the target extension, in --out-dir or next to it. */
+QString convertOutputPath(const QString &path, const Options &options)
+{
+    const QFileInfo info(path);
+    const QString target = !options.target.isEmpty() ? options.target
+                         : (isXlsx(path) ? QStringLiteral("dbc") : QStringLiteral("xlsx"));
+    const QString dir = options.outDir.isEmpty() ? info.absolutePath() : options.outDir;
+    return QDir(dir).absoluteFilePath(info.completeBaseName() + QLatin1Char('.') + target);
+}
+
+/** Key under which two paths name the same file (case-insensitive where the file system usually is). */
+QString pathKey(const QString &path)
+{
+    const QString key = QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return key.toLower();
+#else
+    return key;
+#endif
+}
+
+/**
+ * Outputs that would overwrite an input or another output, e.g. A.dbc and A.xlsx in one directory,
+ * or equal base names from different directories with --out-dir. Checked before any file is written.
+ */
+QStringList outputClashes(const QStringList &files, const QStringList &outputs)
+{
+    QHash<QString, QString> inputs;
+    for (const QString &path : files) {
+        inputs.insert(pathKey(path), path);
+    }
+    QStringList clashes;
+    QHash<QString, QString> written; // output key -> input producing it
+    for (int i = 0; i < files.size(); ++i) {
+        const QString key = pathKey(outputs.at(i));
+        const auto input = inputs.constFind(key);
+        if (input != inputs.constEnd()) {
+            clashes << QString("%1: output %2 would overwrite the input %3 (use --out-dir)")
+                           .arg(files.at(i), outputs.at(i), input.value());
+            continue;
+        }
+        const auto other = written.constFind(key);
+        if (other != written.constEnd()) {
+            clashes << QString("%1: output %2 is also written for %3")
+                           .arg(files.at(i), outputs.at(i), other.value());
+            continue;
+        }
+        written.insert(key, files.at(i));
+    }
+    return clashes;
+}
+
+FileReport convertFile(const QString &path, const QString &outPath, const Options &options)
+{
+    FileReport report;
+    const bool toXlsx = isXlsx(outPath);
+
+    QElapsedTimer timer;
+    timer.start();
+    DbcParser parser;
+    QString error;
+    report.json.insert("file", path);
+    report.json.insert("output", outPath);
+    if (!loadDatabase(path, parser, &error)) {
+        report.errors << QString("%1: %2").arg(path, error);
+        report.json.insert("error", error);
+        return report;
+    }
+    const qint64 loadMs = timer.restart();
+
+    bool ok;
+    if (toXlsx) {
+        ok = DbcExcelConverter::exportToExcel(outPath, parser.getVersion(), parser.getBusType(), parser.getNodes(),
+                                              parser.getMessages(), parser.getDocumentTitle(),
+                                              parser.getChangeHistory(), options.splitByEcu,
+                                              options.compression, &error);
+    } else {
+        ok = DbcWriter::write(outPath, parser.getVersion(), parser.getBusType(), parser.getNodes(),
+                              parser.getMessages(), QString(), parser.getDocumentTitle(),
+                              parser.getChangeHistory(), parser.getGlobalValueTables(), parser.attributes(), &error);
+    }
+    if (!ok) {
+        report.errors << QString("%1: export failed: %2").arg(path, error);
+        report.json.insert("error", error);
+        return report;
+    }
+    const qint64 writeMs = timer.elapsed();
+    const qint64 bytes = QFileInfo(outPath).size();
+    report.ok = true;
+    report.json.insert("loadMs", loadMs);
+    report.json.insert("writeMs", writeMs);
+    report.json.insert("bytes", bytes);
+    if (toXlsx) {
+        report.json.insert("compression", DbcExcelConverter::compressionLevelName(options.compression));
+    }
+    report.output << QString("%1 -> %2 (load %3 ms, write %4 ms, %5 bytes)")
+                         .arg(path, outPath).arg(loadMs).arg(writeMs).arg(bytes);
+    return report;
+}
+
+FileReport validateFile(const QString &path)
+{
+    FileReport report;
+    DbcParser parser;
+    QString error;
+    if (!loadDatabase(path, parser, &error)) {
+        report.errors << QString("%1: %2").arg(path, error);
+        return report;
+    }
+    const ValidationResult result = validateMessages(parser.getMessages());
+    report.ok = result.errors.isEmpty();
+    if (report.ok) {
+        report.output << QString("%1: OK").arg(path);
+    } else {
+        report.errors << QString("%1: %2 error(s)").arg(path).arg(result.errors.size());
+        for (const QString &e : result.errors) {
+            report.errors << QString("  %1").arg(e);
+        }
+    }
+    return report;
+}
+
+FileReport statsFile(const QString &path)
+{
+    FileReport report;
+    QElapsedTimer timer;
+    timer.start();
+    DbcParser parser;
+    QString error;
+    if (!loadDatabase(path, parser, &error)) {
+        report.errors << QString("%1: %2").arg(path, error);
+        report.json.insert("file", path);
+        report.json.insert("error", error);
+        return report;
+    }
+    const qint64 loadMs = timer.elapsed();
+
+    int signalCount = 0;
+    int valueTableCount = 0;
+    for (const CanMessage *message : parser.getMessages()) {
+        signalCount += message->getSignals().size();
+        for (const CanSignal *signal : message->getSignals()) {
+            valueTableCount += signal->getValueTable().isEmpty() ? 0 : 1;
+        }
+    }
+    const QFileInfo info(path);
+    report.ok = true;
+    report.json.insert("file", path);
+    report.json.insert("bytes", info.size());
+    report.json.insert("messages", parser.getMessages().size());
+    report.json.insert("signals", signalCount);
+    report.json.insert("signalsWithValueTables", valueTableCount);
+    report.json.insert("nodes", parser.getNodes().size());
+    report.json.insert("loadMs", loadMs);
+    report.output << QString("%1: messages=%2 signals=%3 nodes=%4 bytes=%5 load_ms=%6")
+                         .arg(path).arg(parser.getMessages().size()).arg(signalCount)
+                         .arg(parser.getNodes().size()).arg(info.size()).arg(loadMs);
+    return report;
+}
+
+/** Parse statistics and issues of a .dbc file; fails when any line was malformed, unknown or dropped. */
+FileReport parseReportFile(const QString &path)
+{
+    FileReport report;
+    report.json.insert("file", path);
+    if (isXlsx(path)) {
+        report.errors << QString("%1: parse reports are only available for .dbc files").arg(path);
+        report.json.insert("error", "not a .dbc file");
+        return report;
+    }
+    DbcParser parser;
+    if (!parser.parseFile(path)) {
+        report.errors << QString("%1: Failed to parse DBC file").arg(path);
+        report.json.insert("error", "Failed to parse DBC file");
+        return report;
+    }
+    const ParseReport &parseReport = parser.parseReport();
+    report.ok = parseReport.issueCount() == 0;
+    report.json = parseReport.toJson();
+    report.output << parseReport.toText().split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    return report;
+}
+
+/** Loads paths.size() databases in parallel into parsers; reports failures to err. */
+bool loadInParallel(const QStringList &paths, DbcParser *parsers, QTextStream &err)
+{
+    QVector<QString> errors(paths.size());
+    QList<QFuture<bool>> loads;
+    for (int i = 0; i < paths.size(); ++i) {
+        DbcParser *parser = &parsers[i];
+        QString *error = &errors[i];
+        const QString path = paths.at(i);
+        loads.append(QtConcurrent::run([path, parser, error]() { return loadDatabase(path, *parser, error); }));
+    }
+    bool loaded = true;
+    for (int i = 0; i < paths.size(); ++i) {
+        if (!loads[i].result()) {
+            err << paths.at(i) << ": " << errors.at(i) << "\n";
+            loaded = false;
+        }
+    }
+    return loaded;
+}
+
+int runDiff(const Options &options, QTextStream &out, QTextStream &err)
+{
+    DbcParser parsers[2];
+    if (!loadInParallel(options.inputs, parsers, err)) {
+        return CommandLine::ExitUsage;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const DbcDiff diff = DbcDiffer::diff(snapshotOf(parsers[0]), snapshotOf(parsers[1]));
+    const qint64 diffUs = timer.nsecsElapsed() / 1000;
+
+    if (!options.historyVersion.isEmpty()) {
+        int nextSerial = 1;
+        for (const DbcExcelConverter::ChangeHistoryEntry &e : parsers[1].getChangeHistory()) {
+            nextSerial = qMax(nextSerial, e.serialNumber.toInt() + 1);
+        }
+        const QList<DbcExcelConverter::ChangeHistoryEntry> entries = DbcDiffer::changeHistoryEntries(
+            diff, options.historyVersion, options.changer, QDate::currentDate(), nextSerial);
+        QJsonArray rows;
+        for (const DbcExcelConverter::ChangeHistoryEntry &e : entries) {
+            if (options.json) {
+                QJsonObject row;
+                row.insert("serialNumber", e.serialNumber);
+                row.insert("protocolVersion", e.protocolVersion);
+                row.insert("changeContent", e.changeContent);
+                row.insert("changer", e.changer);
+                row.insert("changeDate", e.changeDate);
+                row.insert("reviewer", e.reviewer);
+                rows.append(row);
+            } else {
+                QString content = e.changeContent;
+                content.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+                out << e.serialNumber << '\t' << e.protocolVersion << '\t' << content << '\t'
+                    << e.changer << '\t' << e.changeDate << '\t' << e.reviewer << "\n";
+            }
+        }
+        if (options.json) {
+            out << QJsonDocument(rows).toJson(QJsonDocument::Indented);
+        }
+    } else if (options.json) {
+        out << QJsonDocument(DbcDiffer::toJson(diff)).toJson(QJsonDocument::Indented);
+    } else {
+        out << DbcDiffer::toText(diff);
+    }
+    err << QString("diff: %1 + %2 messages compared in %3 ms\n")
+               .arg(parsers[0].getMessages().size()).arg(parsers[1].getMessages().size())
+               .arg(diffUs / 1000.0, 0, 'f', 3);
+    return diff.isEmpty() ? CommandLine::ExitOk : CommandLine::ExitFailure;
+}
+
+int runMerge(const Options &options, QTextStream &out, QTextStream &err)
+{
+    DbcParser parsers[3];
+    if (!loadInParallel(options.inputs, parsers, err)) {
+        return CommandLine::ExitUsage;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const MergeResult result = DbcMerger::merge(snapshotOf(parsers[0]), snapshotOf(parsers[1]), snapshotOf(parsers[2]));
+    const qint64 mergeMs = timer.elapsed();
+
+    // 冲突处保留 ours，结果写回 ours（git 合并驱动约定）并以非零退出码标记冲突
+    const QString outPath = options.output.isEmpty() ? options.inputs.at(1) : options.output;
+    const DbcSnapshot &merged = result.merged;
+    const QList<CanMessage *> messages = createMessages(merged);
+    QString error;
+    const bool written = DbcWriter::write(outPath, merged.version, merged.busType, merged.nodes, messages, QString(),
+                                          merged.documentTitle, merged.changeHistory, merged.globalValueTables,
+                                          merged.attributes, &error);
+    for (CanMessage *message : messages) {
+        qDeleteAll(message->getSignals());
+        delete message;
+    }
+    if (!written) {
+        err << outPath << ": " << error << "\n";
+        return CommandLine::ExitUsage;
+    }
+
+    if (options.json) {
+        out << QJsonDocument(DbcMerger::conflictsToJson(result.conflicts)).toJson(QJsonDocument::Indented);
+    }
+    for (const MergeConflict &conflict : result.conflicts) {
+        err << "CONFLICT " << conflict.description() << "\n";
+    }
+    err << QString("merge: %1 messages, %2 auto-merged change(s), %3 conflict(s), %4 ms\n")
+               .arg(merged.messages.size()).arg(result.autoMerged).arg(result.conflicts.size()).arg(mergeMs);
+    return result.isClean() ? CommandLine::ExitOk : CommandLine::ExitFailure;
+}
+
+int runCodegen(const Options &options, QTextStream &err)
+{
+    DbcParser parser;
+    QString error;
+    if (!loadDatabase(options.inputs.first(), parser, &error)) {
+        err << options.inputs.first() << ": " << error << "\n";
+        return CommandLine::ExitUsage;
+    }
+
+    const QString outDir = options.outDir.isEmpty() ? QStringLiteral(".") : options.outDir;
+    CodeGenerator::Output output;
+    if (!CodeGenerator::generate(parser.getMessages(), options.codegen, &output, &error)) {
+        err << error << "\n";
+        return CommandLine::ExitUsage;
+    }
+    if (!QDir().mkpath(outDir) || !CodeGenerator::writeFiles(outDir, output, &error)) {
+        err << error << "\n";
+        return CommandLine::ExitFailure;
+    }
+    err << QString("codegen: %1 messages, %2 signals -> %3/%4, %5")
+               .arg(output.messageCount).arg(output.signalCount).arg(outDir, output.headerName, output.sourceName);
+    if (!output.selfCheckName.isEmpty()) {
+        err << ", " << output.selfCheckName;
+    }
+    err << "\n";
+    if (output.skippedSignals > 0) {
+        err << QString("codegen: %1 signal(s) skipped (length not 1..64 or bits outside the frame)\n")
+                   .arg(output.skippedSignals);
+    }
+    return CommandLine::ExitOk;
+}
+
+bool hasWildcard(const QString &text)
+{
+    return text.contains(QLatin1Char('*')) || text.contains(QLatin1Char('?')) || text.contains(QLatin1Char('['));
+}
+
+} // namespace
+
+bool CommandLine::isCommand(const QString &name)
+{
+    return kCommands.contains(name);
+}
+
+QStringList CommandLine::expandInputs(const QStringList &inputs, QStringList *unmatched)
+{
+    QStringList files;
+    QSet<QString> seen;
+    auto add = [&](const QString &path) {
+        const QString canonical = QFileInfo(path).absoluteFilePath();
+        if (!seen.contains(canonical)) {
+            seen.insert(canonical);
+            files.append(path);
+        }
+    };
+
+    for (const QString &input : inputs) {
+        const QFileInfo info(input);
+        QStringList matches;
+        if (info.isDir()) {
+            const QDir dir(input);
+            for (const QString &name : dir.entryList(kInputFilters, QDir::Files, QDir::Name)) {
+                matches.append(dir.filePath(name));
+            }
+        } else if (hasWildcard(info.fileName())) {
+            // 在 Windows 等不展开通配符的 shell 中自行匹配
+            const QDir dir(info.path());
+            for (const QString &name : dir.entryList(QStringList(info.fileName()), QDir::Files, QDir::Name)) {
+                matches.append(dir.filePath(name));
+            }
+        } else if (info.isFile()) {
+            matches.append(input);
+        }
+        if (matches.isEmpty() && unmatched) {
+            unmatched->append(input);
+        }
+        for (const QString &path : matches) {
+            add(path);
+        }
+    }
+    return files;
+}
+
+int CommandLine::run(const QStringList &args)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Options options;
+    QString error;
+    if (!parseOptions(args, &options, &error)) {
+        err << error << "\n";
+        printUsage(err);
+        return ExitUsage;
+    }
+
+    if (options.command == QLatin1String("diff")) {
+        return runDiff(options, out, err);
+    }
+    if (options.command == QLatin1String("merge")) {
+        return runMerge(options, out, err);
+    }
+    if (options.command == QLatin1String("codegen")) {
+        return runCodegen(options, err);
+    }
+
+    QStringList unmatched;
+    const QStringList files = expandInputs(options.inputs, &unmatched);
+    for (const QString &input : unmatched) {
+        err << "No input files match: " << input << "\n";
+    }
+    if (files.isEmpty()) {
+        return ExitUsage;
+    }
+    QStringList outputs;
+    if (options.command == QLatin1String("convert")) {
+        outputs.reserve(files.size());
+        for (const QString &path : files) {
+            outputs.append(convertOutputPath(path, options));
+        }
+        const QStringList clashes = outputClashes(files, outputs);
+        if (!clashes.isEmpty()) {
+            for (const QString &clash : clashes) {
+                err << clash << "\n";
+            }
+            return ExitUsage;
+        }
+    }
+    if (!options.outDir.isEmpty() && !QDir().mkpath(options.outDir)) {
+        err << "Cannot create output directory: " << options.outDir << "\n";
+        return ExitFailure;
+    }
+
+    // 每个文件一个任务；使用独立线程池，导出内部的并行任务仍走全局线程池，避免互相占满而死锁
+    QElapsedTimer timer;
+    timer.start();
+    QThreadPool pool;
+    pool.setMaxThreadCount(options.jobs > 0 ? options.jobs : QThread::idealThreadCount());
+    QList<QFuture<FileReport>> pending;
+    pending.reserve(files.size());
+    for (int i = 0; i < files.size(); ++i) {
+        const QString path = files.at(i);
+        const QString outPath = outputs.value(i);
+        pending.append(QtConcurrent::run(&pool, [path, outPath, options]() {
+            if (options.command == QLatin1String("convert")) {
+                return convertFile(path, outPath, options);
+            }
+            if (options.command == QLatin1String("validate")) {
+                return validateFile(path);
+            }
+            if (options.command == QLatin1String("report")) {
+                return parseReportFile(path);
+            }
+            return statsFile(path);
+        }));
+    }
+
+    int failed = 0;
+    QJsonArray jsonReports;
+    for (QFuture<FileReport> &future : pending) {
+        const FileReport report = future.result();
+        failed += report.ok ? 0 : 1;
+        if (options.json) {
+            jsonReports.append(report.json);
+        } else {
+            for (const QString &line : report.output) {
+                out << line << "\n";
+            }
+        }
+        for (const QString &line : report.errors) {
+            err << line << "\n";
+        }
+        out.flush();
+        err.flush();
+    }
+
+    if (options.json) {
+        out << QJsonDocument(jsonReports).toJson(QJsonDocument::Indented);
+    } else {
+        err << QString("%1: %2 file(s), %3 failed, %4 ms, %5 job(s)\n")
+                   .arg(options.command).arg(files.size()).arg(failed)
+                   .arg(timer.elapsed()).arg(pool.maxThreadCount());
+    }
+    return failed == 0 && unmatched.isEmpty() ? ExitOk : ExitFailure;
+}
@@ -0,0 +1,43 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Headless batch commands (no QApplication needed):
+ *
+ *   DBCViewer convert  <inputs...> [--to xlsx|dbc] [--out-dir DIR] [--compression LEVEL] [--single-sheet] [--jobs N]
+ *   DBCViewer validate <inputs...> [--jobs N]
+ *   DBCViewer stats    <inputs...> [--json] [--jobs N]
+ *   DBCViewer report   <inputs...> [--json] [--jobs N]   (per-keyword parse time, malformed/dropped lines)
+ *   DBCViewer diff     <before> <after> [--json] [--history VERSION [--changer NAME]]
+ *   DBCViewer merge    <base> <ours> <theirs> [-o OUT] [--json]
+ *   DBCViewer codegen  <input> [--lang c|c++] [--prefix NAME] [--out-dir DIR] [--self-check VECTORS] [--seed N]
+ *
+ * Inputs may be files, directories (all .dbc/.xlsx inside) or wildcard patterns.
+ * Files are processed concurrently; results are printed in input order.
+ * Exit codes: 0 success, 1 at least one file failed, 2 usage error / no inputs.
+ * diff follows diff(1): 0 identical, 1 different, 2 error. merge follows git merge drivers:
+ * the result is written over ours (or -o), exit 0 when clean and 1 when conflicts remain.
+ * Any command can be traced: `DBCViewer --trace out.json <command> ...` (see trace.h).
+ */
+class CommandLine
+{
+public:
+    enum ExitCode
+    {
+        ExitOk = 0,
+        ExitFailure = 1,
+        ExitUsage = 2
+    };
+
+    static bool isCommand(const QString &name);
+    /** Runs a command; args start with the command name. Requires a Q(Core)Application. */
+    static int run(const QStringList &args);
+
+    /** Expands files, directories and wildcard patterns into a sorted, de-duplicated file list. */
+    static QStringList expandInputs(const QStringList &inputs, QStringList *unmatched = nullptr);
+};
+
+#endif // CLI_H
@@ -0,0 +1,729 @@
+#include "codegenerator.h"
+#include "canmessage.h"
+#include "cansignal.h"
+#include "signalcodec.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+namespace {
+
+/** Consecutive raw bits that live in one payload byte: raw[rawShift..] = data[byte] bits [shift, shift+width). */
+struct Segment
+{
+    int byte;
+    int shift;
+    int width;
+    int rawShift;
+};
+
+struct SignalPlan
+{
+    const CanSignal *signal = nullptr;
+    QString field;
+    int length = 0;
+    bool isSigned = false;
+    int typeBits = 8;
+    QVector<Segment> segments;
+};
+
+struct MessagePlan
+{
+    const CanMessage *message = nullptr;
+    QString ident;
+    quint32 frameId = 0;
+    bool extended = false;
+    int length = 0;
+    QVector<SignalPlan> signalPlans;
+};
+
+const QSet<QString> kReservedWords = {
+    "auto", "bool", "break", "case", "char", "class", "const", "continue", "default", "delete", "do", "double",
+    "else", "enum", "extern", "float", "for", "goto", "if", "inline", "int", "long", "namespace", "new",
+    "operator", "private", "protected", "public", "register", "return", "short", "signed", "sizeof", "static",
+    "struct", "switch", "template", "this", "typedef", "union", "unsigned", "using", "void", "volatile", "while",
+    // names used by the generated C++ code itself
+    "frameId", "isExtended", "length", "pack", "unpack", "unpackFrame", "messages", "messageCount", "MessageInfo",
+};
+
+QString identifier(const QString &name)
+{
+    QString out;
+    out.reserve(name.size());
+    for (const QChar ch : name) {
+        const bool ascii = ch.unicode() < 128;
+        out += (ascii && (ch.isLetterOrNumber() || ch == QLatin1Char('_'))) ? ch : QLatin1Char('_');
+    }
+    if (out.isEmpty() || out.at(0).isDigit()) {
+        out.prepend(QLatin1String("n_"));
+    }
+    if (kReservedWords.contains(out)) {
+        out += QLatin1Char('_');
+    }
+    return out;
+}
+
+QString uniqueName(const QString &base, QSet<QString> *used)
+{
+    QString name = base;
+    for (int n = 2; used->contains(name); ++n) {
+        name = QString("%1_%2").arg(base).arg(n);
+    }
+    used->insert(name);
+    return name;
+}
+
+/** Upper-case enumerator from a value description ("Not Active" -> NOT_ACTIVE). */
+QString enumerator(const QString &description, int value)
+{
+    QString out;
+    for (const QChar ch : description) {
+        if (ch.unicode() < 128 && ch.isLetterOrNumber()) {
+            out += ch.toUpper();
+        } else if (!out.isEmpty() && !out.endsWith(QLatin1Char('_'))) {
+            out += QLatin1Char('_');
+        }
+    }
+    while (out.endsWith(QLatin1Char('_'))) {
+        out.chop(1);
+    }
+    if (out.isEmpty()) {
+        return value < 0 ? QString("VALUE_M%1").arg(-qint64(value)) : QString("VALUE_%1").arg(value);
+    }
+    if (out.at(0).isDigit()) {
+        out.prepend(QLatin1String("V_"));
+    }
+    return out;
+}
+
+QString rawType(const SignalPlan &plan)
+{
+    return QString("%1int%2_t").arg(plan.isSigned ? QString() : QStringLiteral("u")).arg(plan.typeBits);
+}
+
+QString hexLiteral(quint64 value, bool wide)
+{
+    return QString("0x%1%2").arg(value, 0, 16).arg(wide ? QStringLiteral("ull") : QStringLiteral("u"));
+}
+
+QString doubleLiteral(double value)
+{
+    QString text = QString::number(value, 'g', 17);
+    if (!text.contains(QLatin1Char('.')) && !text.contains(QLatin1Char('e'))) {
+        text += QLatin1String(".0");
+    }
+    return text;
+}
+
+QString byteList(const uchar *data, int size)
+{
+    QStringList bytes;
+    for (int i = 0; i < size; ++i) {
+        bytes << QString("0x%1").arg(data[i], 2, 16, QLatin1Char('0'));
+    }
+    return bytes.join(QStringLiteral(", "));
+}
+
+/** Precomputes the byte segments of a signal; false when it cannot be packed into the frame. */
+bool planSignal(const CanSignal &signal, int frameBytes, SignalPlan *plan)
+{
+    const QVector<int> positions = SignalCodec::bitPositions(signal);
+    if (positions.isEmpty()) {
+        return false;
+    }
+    for (int bit : positions) {
+        if (bit < 0 || bit >= frameBytes * 8) {
+            return false;
+        }
+    }
+    plan->signal = &signal;
+    plan->length = positions.size();
+    plan->isSigned = signal.isSigned();
+    plan->typeBits = plan->length <= 8 ? 8 : plan->length <= 16 ? 16 : plan->length <= 32 ? 32 : 64;
+    for (int i = 0; i < positions.size(); ++i) {
+        const int byte = positions.at(i) / 8;
+        const int bit = positions.at(i) % 8;
+        if (!plan->segments.isEmpty()) {
+            Segment &last = plan->segments.last();
+            if (last.byte == byte && last.shift + last.width == bit) {
+                ++last.width;
+                continue;
+            }
+        }
+        plan->segments.append(Segment{byte, bit, 1, i});
+    }
+    return true;
+}
+
+/** Branch-free expression reading the raw value of plan from data. */
+QString unpackExpression(const SignalPlan &plan, const QString &data)
+{
+    const bool wide = plan.length > 32;
+    const QString computeType = wide ? QStringLiteral("uint64_t") : QStringLiteral("uint32_t");
+    QStringList terms;
+    for (const Segment &segment : plan.segments) {
+        QString term = QString("%1[%2]").arg(data).arg(segment.byte);
+        if (segment.shift > 0) {
+            term = QString("(%1 >> %2)").arg(term).arg(segment.shift);
+        }
+        if (segment.shift + segment.width < 8) {
+            term = QString("(%1 & %2)").arg(term, hexLiteral((1u << segment.width) - 1, false));
+        }
+        term = QString("(%1)%2").arg(computeType, term);
+        if (segment.rawShift > 0) {
+            term = QString("(%1 << %2)").arg(term).arg(segment.rawShift);
+        }
+        terms << term;
+    }
+    QString raw = terms.join(QStringLiteral(" | "));
+    if (plan.isSigned && plan.length < plan.typeBits) {
+        const QString sign = hexLiteral(quint64(1) << (plan.length - 1), wide);
+        raw = QString("((%1) ^ %2) - %2").arg(raw, sign);
+    }
+    return QString("(%1)(%2)").arg(rawType(plan), raw);
+}
+
+/** Statements OR-ing value (an lvalue of the field) into the zeroed payload. */
+QString packStatements(const SignalPlan &plan, const QString &value, const QString &indent)
+{
+    const bool wide = plan.length > 32;
+    const QString computeType = wide ? QStringLiteral("uint64_t") : QStringLiteral("uint32_t");
+    const QString rawName = QString("r_%1").arg(plan.field);
+    QString out = QString("%1{\n%1    const %2 %3 = (%2)%4;\n").arg(indent, computeType, rawName, value);
+    for (const Segment &segment : plan.segments) {
+        QString term = rawName;
+        if (segment.rawShift > 0) {
+            term = QString("(%1 >> %2)").arg(term).arg(segment.rawShift);
+        }
+        if (segment.width < 8) {
+            term = QString("(%1 & %2)").arg(term, hexLiteral((1u << segment.width) - 1, wide));
+        }
+        if (segment.shift > 0) {
+            term = QString("(%1 << %2)").arg(term).arg(segment.shift);
+        }
+        out += QString("%1    data[%2] |= (uint8_t)%3;\n").arg(indent).arg(segment.byte).arg(term);
+    }
+    out += indent + QStringLiteral("}\n");
+    return out;
+}
+
+QString signalComment(const CanSignal &signal)
+{
+    return QString("%1|%2@%3%4 (%5,%6) [%7|%8] \"%9\"")
+        .arg(signal.getStartBit())
+        .arg(signal.getLength())
+        .arg(signal.getByteOrder())
+        .arg(signal.isSigned() ? QLatin1Char('-') : QLatin1Char('+'))
+        .arg(signal.getFactor(), 0, 'g', 10)
+        .arg(signal.getOffset(), 0, 'g', 10)
+        .arg(signal.getMin(), 0, 'g', 10)
+        .arg(signal.getMax(), 0, 'g', 10)
+        .arg(QString(signal.getUnit()).replace(QLatin1String("*/"), QLatin1String("* /")));
+}
+
+/** DBC-style dispatch key: frame id with bit 31 set for extended frames. */
+quint32 dispatchKey(const MessagePlan &plan)
+{
+    return plan.frameId | (plan.extended ? 0x80000000u : 0u);
+}
+
+class Emitter
+{
+public:
+    Emitter(const QVector<MessagePlan> &plans, const CodeGenerator::Options &options)
+        : m_plans(plans)
+        , m_options(options)
+        , m_cpp(options.language == CodeGenerator::Cpp17)
+        , m_prefix(identifier(options.prefix))
+        , m_macroPrefix(m_prefix.toUpper())
+    {
+    }
+
+    QString typeName(const MessagePlan &plan) const
+    {
+        return m_cpp ? QString("%1::%2").arg(m_prefix, plan.ident) : QString("%1_%2_t").arg(m_prefix, plan.ident);
+    }
+    QString unpackCall(const MessagePlan &plan, const QString &object, const QString &data) const
+    {
+        return m_cpp ? QString("%1::unpack(%2, %3)").arg(m_prefix, object, data)
+                     : QString("%1_%2_unpack(&%3, %4)").arg(m_prefix, plan.ident, object, data);
+    }
+    QString packCall(const MessagePlan &plan, const QString &data, const QString &object) const
+    {
+        return m_cpp ? QString("%1::pack(%2, %3)").arg(m_prefix, data, object)
+                     : QString("%1_%2_pack(%3, &%4)").arg(m_prefix, plan.ident, data, object);
+    }
+
+    QString header() const;
+    QString source(const QString &headerName) const;
+    QString selfCheck(const QString &headerName) const;
+
+private:
+    void emitValueEnum(QString &out, const MessagePlan &plan, const SignalPlan &signalPlan) const;
+
+    const QVector<MessagePlan> &m_plans;
+    const CodeGenerator::Options &m_options;
+    bool m_cpp;
+    QString m_prefix;
+    QString m_macroPrefix;
+};
+
+void Emitter::emitValueEnum(QString &out, const MessagePlan &plan, const SignalPlan &signalPlan) const
+{
+    const QMap<int, QString> table = signalPlan.signal->getValueTable();
+    if (table.isEmpty()) {
+        return;
+    }
+    QSet<QString> used;
+    QStringList entries;
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        QString name = enumerator(it.value(), it.key());
+        if (used.contains(name)) {
+            name += it.key() < 0 ? QString("_M%1").arg(-qint64(it.key())) : QString("_%1").arg(it.key());
+        }
+        used.insert(name);
+        if (m_cpp) {
+            entries << QString("    %1 = %2").arg(name).arg(it.key());
+        } else {
+            entries << QString("    %1_%2_%3_%4 = %5").arg(m_macroPrefix, plan.ident.toUpper(), signalPlan.field.toUpper(),
+                                                       name).arg(it.key());
+        }
+    }
+    if (m_cpp) {
+        out += QString("enum class %1_%2 : int\n{\n%3\n};\n\n").arg(plan.ident, signalPlan.field, entries.join(",\n"));
+    } else {
+        out += QString("enum %1_%2_%3_values\n{\n%4\n};\n\n").arg(m_prefix, plan.ident, signalPlan.field,
+                                                              entries.join(",\n"));
+    }
+}
+
+QString Emitter::header() const
+{
+    const QString guard = m_macroPrefix + QStringLiteral("_H");
+    QString out;
+    out += QString("/* Generated by DBCViewer codegen: %1 messages. Do not edit. */\n").arg(m_plans.size());
+    out += QString("#ifndef %1\n#define %1\n\n").arg(guard);
+    if (m_cpp) {
+        out += "#include <cmath>\n#include <cstddef>\n#include <cstdint>\n#include <cstring>\n\n";
+        out += QString("namespace %1 {\n\n").arg(m_prefix);
+        out += "struct MessageInfo\n{\n    uint32_t frameId;\n    bool isExtended;\n    uint8_t length;\n"
+               "    const char *name;\n};\n\n";
+        out += "extern const MessageInfo messages[];\nextern const std::size_t messageCount;\n";
+        out += "/** key: frame id, bit 31 set for extended frames. out points to the message struct. "
+               "Returns the message index or -1. */\n"
+               "int unpackFrame(uint32_t key, const uint8_t *data, std::size_t size, void *out);\n\n";
+    } else {
+        out += "#include <math.h>\n#include <stddef.h>\n#include <stdint.h>\n#include <string.h>\n\n";
+        out += "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n";
+        out += QString("typedef struct\n{\n    uint32_t frame_id;\n    uint8_t is_extended;\n    uint8_t length;\n"
+                       "    const char *name;\n} %1_message_info_t;\n\n").arg(m_prefix);
+        out += QString("extern const %1_message_info_t %1_messages[];\nextern const size_t %1_message_count;\n")
+                   .arg(m_prefix);
+        out += QString("/* key: frame id, bit 31 set for extended frames. out points to the message struct.\n"
+                       "   Returns the message index or -1. */\n"
+                       "int %1_unpack_frame(uint32_t key, const uint8_t *data, size_t size, void *out);\n\n")
+                   .arg(m_prefix);
+    }
+
+    const QString inlineKeyword = m_cpp ? QStringLiteral("inline") : QStringLiteral("static inline");
+    const QString access = m_cpp ? QStringLiteral(".") : QStringLiteral("->");
+    for (const MessagePlan &plan : m_plans) {
+        const QString macro = QString("%1_%2").arg(m_macroPrefix, plan.ident.toUpper());
+        out += QString("/* ---- %1 (0x%2%3, %4 bytes) ---- */\n\n")
+                   .arg(plan.message->getName()).arg(plan.frameId, 0, 16)
+                   .arg(plan.extended ? QStringLiteral(", extended") : QString()).arg(plan.length);
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            emitValueEnum(out, plan, signalPlan);
+        }
+
+        if (m_cpp) {
+            out += QString("struct %1\n{\n").arg(plan.ident);
+            out += QString("    static constexpr uint32_t frameId = %1;\n").arg(hexLiteral(plan.frameId, false));
+            out += QString("    static constexpr bool isExtended = %1;\n").arg(plan.extended ? "true" : "false");
+            out += QString("    static constexpr std::size_t length = %1;\n\n").arg(plan.length);
+        } else {
+            out += QString("#define %1_FRAME_ID %2\n#define %1_IS_EXTENDED %3\n#define %1_LENGTH %4u\n\n")
+                       .arg(macro, hexLiteral(plan.frameId, false)).arg(plan.extended ? 1 : 0).arg(plan.length);
+            out += "typedef struct\n{\n";
+        }
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            out += QString("    %1 %2%3; /* %4 */\n").arg(rawType(signalPlan), signalPlan.field,
+                                                         m_cpp ? QStringLiteral(" = 0") : QString(),
+                                                         signalComment(*signalPlan.signal));
+        }
+        if (plan.signalPlans.isEmpty()) {
+            out += "    uint8_t unused_;\n";
+        }
+        out += m_cpp ? QStringLiteral("};\n\n") : QString("} %1_%2_t;\n\n").arg(m_prefix, plan.ident);
+
+        // unpack
+        if (m_cpp) {
+            out += QString("inline void unpack(%1 &out, const uint8_t *data) noexcept\n{\n").arg(plan.ident);
+        } else {
+            out += QString("static inline void %1_%2_unpack(%1_%2_t *out, const uint8_t *data)\n{\n")
+                       .arg(m_prefix, plan.ident);
+        }
+        if (plan.signalPlans.isEmpty()) {
+            out += "    (void)out;\n    (void)data;\n";
+        }
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            out += QString("    out%1%2 = %3;\n").arg(access, signalPlan.field,
+                                                    unpackExpression(signalPlan, QStringLiteral("data")));
+        }
+        out += "}\n\n";
+
+        // pack
+        if (m_cpp) {
+            out += QString("inline void pack(uint8_t *data, const %1 &in) noexcept\n{\n").arg(plan.ident);
+            out += QString("    std::memset(data, 0, %1);\n").arg(plan.length);
+        } else {
+            out += QString("static inline void %1_%2_pack(uint8_t *data, const %1_%2_t *in)\n{\n")
+                       .arg(m_prefix, plan.ident);
+            out += QString("    memset(data, 0, %1);\n").arg(plan.length);
+        }
+        if (plan.signalPlans.isEmpty()) {
+            out += "    (void)in;\n";
+        }
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            out += packStatements(signalPlan, QString("in%1%2").arg(access, signalPlan.field), QStringLiteral("    "));
+        }
+        out += "}\n\n";
+
+        // scaling helpers
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            const CanSignal &signal = *signalPlan.signal;
+            const QString name = m_cpp ? QString("%1_%2").arg(plan.ident, signalPlan.field)
+                                       : QString("%1_%2_%3").arg(m_prefix, plan.ident, signalPlan.field);
+            const QString type = rawType(signalPlan);
+            out += QString("%1 double %2_decode(%3 raw)%4\n{\n    return (double)raw * %5 + %6;\n}\n")
+                       .arg(m_cpp ? QStringLiteral("constexpr") : inlineKeyword, name, type,
+                            m_cpp ? QStringLiteral(" noexcept") : QString(),
+                            doubleLiteral(signal.getFactor()), doubleLiteral(signal.getOffset()));
+            if (signal.getFactor() != 0.0) {
+                out += QString("%1 %2 %3_encode(double value)%4\n{\n    return (%2)%5((value - %6) / %7);\n}\n")
+                           .arg(inlineKeyword, type, name, m_cpp ? QStringLiteral(" noexcept") : QString(),
+                                m_cpp ? QStringLiteral("std::llround") : QStringLiteral("llround"),
+                                doubleLiteral(signal.getOffset()), doubleLiteral(signal.getFactor()));
+            }
+        }
+        out += "\n";
+    }
+
+    if (m_cpp) {
+        out += QString("} // namespace %1\n\n").arg(m_prefix);
+    } else {
+        out += "#ifdef __cplusplus\n}\n#endif\n\n";
+    }
+    out += QString("#endif /* %1 */\n").arg(guard);
+    return out;
+}
+
+QString Emitter::source(const QString &headerName) const
+{
+    QString out;
+    out += "/* Generated by DBCViewer codegen. Do not edit. */\n";
+    out += QString("#include \"%1\"\n\n").arg(headerName);
+    QStringList infos;
+    for (const MessagePlan &plan : m_plans) {
+        infos << QString("    {%1, %2, %3, \"%4\"}").arg(hexLiteral(plan.frameId, false))
+                     .arg(m_cpp ? (plan.extended ? "true" : "false") : (plan.extended ? "1" : "0"))
+                     .arg(plan.length).arg(plan.ident);
+    }
+    if (infos.isEmpty()) {
+        infos << (m_cpp ? QStringLiteral("    {0u, false, 0, nullptr}") : QStringLiteral("    {0u, 0, 0, NULL}"));
+    }
+
+    QSet<quint32> keys;
+    QString cases;
+    for (int i = 0; i < m_plans.size(); ++i) {
+        const MessagePlan &plan = m_plans.at(i);
+        if (keys.contains(dispatchKey(plan))) {
+            cases += QString("    /* %1: duplicate frame id, not dispatched */\n").arg(plan.ident);
+            continue;
+        }
+        keys.insert(dispatchKey(plan));
+        const QString cast = m_cpp ? QString("*static_cast<%1 *>(out)").arg(plan.ident)
+                                   : QString("(%1_%2_t *)out").arg(m_prefix, plan.ident);
+        cases += QString("    case %1:\n        if (size < %2) {\n            return -1;\n        }\n"
+                         "        %3(%4, data);\n        return %5;\n")
+                     .arg(hexLiteral(dispatchKey(plan), false)).arg(plan.length)
+                     .arg(m_cpp ? QStringLiteral("unpack") : QString("%1_%2_unpack").arg(m_prefix, plan.ident), cast)
+                     .arg(i);
+    }
+
+    if (m_cpp) {
+        out += QString("namespace %1 {\n\n").arg(m_prefix);
+        out += QString("const MessageInfo messages[] = {\n%1\n};\nconst std::size_t messageCount = %2;\n\n")
+                   .arg(infos.join(",\n")).arg(m_plans.size());
+        out += "int unpackFrame(uint32_t key, const uint8_t *data, std::size_t size, void *out)\n{\n";
+    } else {
+        out += QString("const %1_message_info_t %1_messages[] = {\n%2\n};\nconst size_t %1_message_count = %3;\n\n")
+                   .arg(m_prefix, infos.join(",\n")).arg(m_plans.size());
+        out += QString("int %1_unpack_frame(uint32_t key, const uint8_t *data, size_t size, void *out)\n{\n").arg(m_prefix);
+    }
+    out += "    switch (key) {\n" + cases + "    default:\n        (void)data;\n        (void)size;\n"
+           "        (void)out;\n        return -1;\n    }\n}\n";
+    if (m_cpp) {
+        out += QString("\n} // namespace %1\n").arg(m_prefix);
+    }
+    return out;
+}
+
+QString Emitter::selfCheck(const QString &headerName) const
+{
+    const int vectorCount = m_options.selfCheckVectors;
+    QRandomGenerator rng(m_options.seed);
+
+    QString out;
+    out += "/* Generated by DBCViewer codegen: round-trip self-check and decode benchmark. Do not edit.\n"
+           "   Expected raw values come from the in-tool decoder; build together with the generated source. */\n";
+    out += QString("#include \"%1\"\n\n").arg(headerName);
+    if (m_cpp) {
+        out += "#include <chrono>\n#include <cstdio>\n\n";
+    } else {
+        out += "#include <stdio.h>\n#include <time.h>\n\n";
+    }
+    out += "typedef struct\n{\n    int start;\n    int length;\n    int motorola;\n    int is_signed;\n} "
+           "selfcheck_signal_t;\n\n"
+           "typedef struct\n{\n    const uint8_t *vectors;\n    int length;\n    const selfcheck_signal_t *layout;\n"
+           "    int signal_count;\n} selfcheck_message_t;\n\n";
+    out += QString("enum { VECTOR_COUNT = %1 };\n\n").arg(vectorCount);
+
+    // Generic bit walk, same algorithm as the in-tool SignalCodec
+    out += "static uint64_t generic_extract(const uint8_t *data, int size, const selfcheck_signal_t *s)\n{\n"
+           "    uint64_t raw = 0;\n    int bit = s->start;\n    int k;\n"
+           "    for (k = 0; k < s->length; ++k) {\n"
+           "        const int index = s->motorola ? s->length - 1 - k : k;\n"
+           "        if (bit >= 0 && bit < size * 8 && ((data[bit / 8] >> (bit % 8)) & 1)) {\n"
+           "            raw |= (uint64_t)1 << index;\n        }\n"
+           "        if (s->motorola) {\n            bit += (bit % 8 == 0) ? 15 : -1;\n        } else {\n"
+           "            ++bit;\n        }\n    }\n"
+           "    if (s->is_signed && s->length < 64) {\n"
+           "        const uint64_t sign = (uint64_t)1 << (s->length - 1);\n"
+           "        raw = (raw ^ sign) - sign;\n    }\n    return raw;\n}\n\n";
+    out += "static int check_value(const char *message, const char *signal, int vector, uint64_t actual, uint64_t expected)\n"
+           "{\n    if (actual == expected) {\n        return 0;\n    }\n"
+           "    printf(\"MISMATCH %s.%s vector %d: got 0x%llx, expected 0x%llx\\n\", message, signal, vector,\n"
+           "           (unsigned long long)actual, (unsigned long long)expected);\n    return 1;\n}\n\n";
+    out += "static int check_packed(const char *message, int vector, const uint8_t *packed, const uint8_t *payload,\n"
+           "                        const uint8_t *mask, int length)\n{\n    int i;\n"
+           "    for (i = 0; i < length; ++i) {\n        if (packed[i] != (payload[i] & mask[i])) {\n"
+           "            printf(\"MISMATCH %s pack vector %d byte %d: got 0x%02x, expected 0x%02x\\n\", message, vector, i,\n"
+           "                   packed[i], payload[i] & mask[i]);\n            return 1;\n        }\n    }\n"
+           "    return 0;\n}\n\n";
+
+    QStringList tableEntries;
+    QString checks;
+    QString generatedBench;
+    int checkedMessages = 0;
+    int checkedSignals = 0;
+    QVector<uchar> payload;
+    for (int m = 0; m < m_plans.size(); ++m) {
+        const MessagePlan &plan = m_plans.at(m);
+        if (plan.signalPlans.isEmpty()) {
+            continue;
+        }
+        ++checkedMessages;
+        checkedSignals += plan.signalPlans.size();
+        payload.resize(plan.length);
+
+        QStringList vectorRows;
+        QStringList expectedRows;
+        for (int v = 0; v < vectorCount; ++v) {
+            for (int b = 0; b < plan.length; ++b) {
+                payload[b] = uchar(rng.bounded(256));
+            }
+            QStringList expected;
+            for (const SignalPlan &signalPlan : plan.signalPlans) {
+                const quint64 raw = SignalCodec::extractRaw(*signalPlan.signal, payload.constData(), plan.length);
+                const quint64 value = signalPlan.isSigned ? quint64(SignalCodec::toSigned(raw, signalPlan.length)) : raw;
+                expected << hexLiteral(value, true);
+            }
+            vectorRows << QString("    {%1}").arg(byteList(payload.constData(), plan.length));
+            expectedRows << QString("    {%1}").arg(expected.join(QStringLiteral(", ")));
+        }
+
+        QVector<uchar> mask(plan.length, 0);
+        QStringList layout;
+        for (const SignalPlan &signalPlan : plan.signalPlans) {
+            for (const Segment &segment : signalPlan.segments) {
+                mask[segment.byte] |= uchar(((1u << segment.width) - 1) << segment.shift);
+            }
+            const CanSignal &signal = *signalPlan.signal;
+            layout << QString("    {%1, %2, %3, %4}").arg(signal.getStartBit()).arg(signalPlan.length)
+                          .arg(signal.getByteOrder() == 0 ? 1 : 0).arg(signalPlan.isSigned ? 1 : 0);
+        }
+
+        out += QString("/* %1 */\n").arg(plan.ident);
+        out += QString("static const uint8_t vectors_%1[VECTOR_COUNT][%2] = {\n%3\n};\n")
+                   .arg(m).arg(plan.length).arg(vectorRows.join(",\n"));
+        out += QString("static const uint64_t expected_%1[VECTOR_COUNT][%2] = {\n%3\n};\n")
+                   .arg(m).arg(plan.signalPlans.size()).arg(expectedRows.join(",\n"));
+        out += QString("static const uint8_t mask_%1[%2] = {%3};\n").arg(m).arg(plan.length)
+                   .arg(byteList(mask.constData(), plan.length));
+        out += QString("static const selfcheck_signal_t layout_%1[%2] = {\n%3\n};\n\n")
+                   .arg(m).arg(plan.signalPlans.size()).arg(layout.join(",\n"));
+        tableEntries << QString("    {&vectors_%1[0][0], %2, layout_%1, %3}").arg(m).arg(plan.length)
+                            .arg(plan.signalPlans.size());
+
+        const QString type = typeName(plan);
+        checks += QString("    for (v = 0; v < VECTOR_COUNT; ++v) {\n        %1 value;\n        uint8_t packed[%2];\n"
+                          "        %3;\n")
+                      .arg(type).arg(plan.length).arg(unpackCall(plan, QStringLiteral("value"), QString("vectors_%1[v]").arg(m)));
+        QStringList sum;
+        for (int s = 0; s < plan.signalPlans.size(); ++s) {
+            const SignalPlan &signalPlan = plan.signalPlans.at(s);
+            const QString valueExpr = signalPlan.isSigned ? QString("(uint64_t)(int64_t)value.%1").arg(signalPlan.field)
+                                                          : QString("(uint64_t)value.%1").arg(signalPlan.field);
+            checks += QString("        failures += check_value(\"%1\", \"%2\", v, %3, expected_%4[v][%5]);\n")
+                          .arg(plan.ident, signalPlan.field, valueExpr).arg(m).arg(s);
+            sum << valueExpr;
+        }
+        checks += QString("        %1;\n        failures += check_packed(\"%2\", v, packed, vectors_%3[v], mask_%3, %4);\n    }\n")
+                      .arg(packCall(plan, QStringLiteral("packed"), QStringLiteral("value")), plan.ident).arg(m).arg(plan.length);
+        generatedBench += QString("        for (v = 0; v < VECTOR_COUNT; ++v) {\n            %1 value;\n            %2;\n"
+                                  "            sink += %3;\n        }\n")
+                              .arg(type, unpackCall(plan, QStringLiteral("value"), QString("vectors_%1[v]").arg(m)),
+                                   sum.join(QStringLiteral(" + ")));
+    }
+    if (tableEntries.isEmpty()) {
+        tableEntries << QStringLiteral("    {0, 0, 0, 0}");
+    }
+
+    const qint64 framesPerRound = qint64(qMax(1, checkedMessages)) * qMax(1, vectorCount);
+    const qint64 rounds = qMax<qint64>(1, 2000000 / framesPerRound);
+    out += QString("static const selfcheck_message_t messages_table[] = {\n%1\n};\nenum { MESSAGE_COUNT = %2 };\n\n")
+               .arg(tableEntries.join(",\n")).arg(checkedMessages);
+
+    out += "static int run_checks(void)\n{\n    int failures = 0;\n    int v;\n" + checks + "    return failures;\n}\n\n";
+    out += "static uint64_t run_generated(long rounds)\n{\n    uint64_t sink = 0;\n    long r;\n    int v;\n"
+           "    for (r = 0; r < rounds; ++r) {\n" + generatedBench + "    }\n    return sink;\n}\n\n";
+    out += "static uint64_t run_generic(long rounds)\n{\n    uint64_t sink = 0;\n    long r;\n    int m, v, s;\n"
+           "    for (r = 0; r < rounds; ++r) {\n        for (m = 0; m < MESSAGE_COUNT; ++m) {\n"
+           "            const selfcheck_message_t *msg = &messages_table[m];\n"
+           "            for (v = 0; v < VECTOR_COUNT; ++v) {\n"
+           "                const uint8_t *data = msg->vectors + v * msg->length;\n"
+           "                for (s = 0; s < msg->signal_count; ++s) {\n"
+           "                    sink += generic_extract(data, msg->length, &msg->layout[s]);\n"
+           "                }\n            }\n        }\n    }\n    return sink;\n}\n\n";
+    if (m_cpp) {
+        out += "static double now_seconds()\n{\n"
+               "    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();\n}\n\n";
+    } else {
+        out += "static double now_seconds(void)\n{\n    return (double)clock() / CLOCKS_PER_SEC;\n}\n\n";
+    }
+    out += QString("int main(void)\n{\n    const long rounds = %1;\n    const double frames = (double)rounds * %2;\n")
+               .arg(rounds).arg(framesPerRound);
+    out += QString("    int failures = run_checks();\n"
+                   "    double start = now_seconds();\n    const uint64_t generatedSum = run_generated(rounds);\n"
+                   "    const double generatedSeconds = now_seconds() - start;\n"
+                   "    start = now_seconds();\n    const uint64_t genericSum = run_generic(rounds);\n"
+                   "    const double genericSeconds = now_seconds() - start;\n"
+                   "    const double speedup = generatedSeconds > 0 ? genericSeconds / generatedSeconds : 0.0;\n"
+                   "    if (generatedSum != genericSum) {\n"
+                   "        printf(\"MISMATCH benchmark checksums: generated 0x%llx, generic 0x%llx\\n\",\n"
+                   "               (unsigned long long)generatedSum, (unsigned long long)genericSum);\n"
+                   "        ++failures;\n    }\n"
+                   "    printf(\"self-check: %3 messages, %4 signals, %d vectors each: %s\\n\", VECTOR_COUNT,\n"
+                   "           failures ? \"FAILED\" : \"OK\");\n"
+                   "    printf(\"decode: generated %.1f ns/frame, generic %.1f ns/frame, speedup %.1fx\\n\",\n"
+                   "           generatedSeconds * 1e9 / frames, genericSeconds * 1e9 / frames, speedup);\n"
+                   "    return failures ? 1 : 0;\n}\n")
+               .arg(checkedMessages).arg(checkedSignals);
+    return out;
+}
+
+} // namespace
+
+bool CodeGenerator::generate(const QList<CanMessage *> &messages, const Options &options, Output *output,
+                             QString *error)
+{
+    const QString prefix = identifier(options.prefix);
+    if (options.prefix.isEmpty() || prefix != options.prefix) {
+        if (error) {
+            *error = QString("Prefix must be a C identifier: %1").arg(options.prefix);
+        }
+        return false;
+    }
+
+    *output = Output();
+    QVector<MessagePlan> plans;
+    QSet<QString> messageNames;
+    for (const CanMessage *message : messages) {
+        if (!message || message->getLength() <= 0 || message->getLength() > 64) {
+            continue;
+        }
+        MessagePlan plan;
+        plan.message = message;
+        plan.ident = uniqueName(identifier(message->getName()), &messageNames);
+        plan.extended = (message->getId() & 0x80000000u) != 0 || (message->getId() & 0x1FFFFFFFu) > 0x7FF;
+        plan.frameId = message->getId() & 0x1FFFFFFFu;
+        plan.length = message->getLength();
+        QSet<QString> fieldNames;
+        for (const CanSignal *signal : message->getSignals()) {
+            SignalPlan signalPlan;
+            if (!signal || !planSignal(*signal, plan.length, &signalPlan)) {
+                ++output->skippedSignals;
+                continue;
+            }
+            signalPlan.field = uniqueName(identifier(signal->getName()), &fieldNames);
+            plan.signalPlans.append(signalPlan);
+            ++output->signalCount;
+        }
+        plans.append(plan);
+    }
+    output->messageCount = plans.size();
+
+    const bool cpp = options.language == Cpp17;
+    const Emitter emitter(plans, options);
+    output->headerName = prefix + (cpp ? QStringLiteral(".hpp") : QStringLiteral(".h"));
+    output->sourceName = prefix + (cpp ? QStringLiteral(".cpp") : QStringLiteral(".c"));
+    output->header = emitter.header();
+    output->source = emitter.source(output->headerName);
+    if (options.selfCheckVectors > 0) {
+        output->selfCheckName = prefix + (cpp ? QStringLiteral("_selfcheck.cpp") : QStringLiteral("_selfcheck.c"));
+        output->selfCheck = emitter.selfCheck(output->headerName);
+    }
+    return true;
+}
+
+bool CodeGenerator::writeFiles(const QString &directory, const Output &output, QString *error)
+{
+    const QList<QPair<QString, QString>> files = {
+        {output.headerName, output.header},
+        {output.sourceName, output.source},
+        {output.selfCheckName, output.selfCheck},
+    };
+    for (const auto &file : files) {
+        if (file.first.isEmpty()) {
+            continue;
+        }
+        QFile out(QDir(directory).filePath(file.first));
+        const QByteArray data = file.second.toUtf8();
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(data) != data.size()) {
+            if (error) {
+                *error = QString("%1: %2").arg(out.fileName(), out.errorString());
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CodeGenerator::languageFromString(const QString &name, Language *language)
+{
+    const QString lower = name.toLower();
+    if (lower == QLatin1String("c") || lower == QLatin1String("c99")) {
+        *language = C99;
+        return true;
+    }
+    if (lower == QLatin1String("c++") || lower == QLatin1String("cpp") || lower == QLatin1String("c++17")) {
+        *language = Cpp17;
+        return true;
+    }
+    return false;
+}
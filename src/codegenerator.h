@@ -0,0 +1,56 @@
+#ifndef CODEGENERATOR_H
+#define CODEGENERATOR_H
+
+#include <QList>
+#include <QString>
+
+class CanMessage;
+
+/**
+ * Generates C99 or C++17 pack/unpack code from the loaded database: one struct of raw values
+ * per message, inline branch-free pack/unpack functions whose shifts and masks are computed
+ * at generation time (both byte orders), scaling helpers and value-table enums.
+ *
+ * With selfCheckVectors > 0 a self-check program is emitted as well. It unpacks random
+ * payloads, compares them with raw values from the in-tool decoder (SignalCodec), packs the
+ * values back, and times the generated code against a generic bit-walk decoder. Its exit code
+ * only reflects the round-trip checks; the timing is printed for information.
+ */
+class CodeGenerator
+{
+public:
+    enum Language
+    {
+        C99,
+        Cpp17
+    };
+
+    struct Options
+    {
+        Language language = C99;
+        QString prefix = QStringLiteral("dbc"); // identifier prefix / namespace and file base name
+        int selfCheckVectors = 0;
+        quint32 seed = 1;
+    };
+
+    struct Output
+    {
+        QString headerName;
+        QString header;
+        QString sourceName;
+        QString source;
+        QString selfCheckName; // empty unless requested
+        QString selfCheck;
+        int messageCount = 0;
+        int signalCount = 0;
+        int skippedSignals = 0; // zero/oversized length or bits outside the frame
+    };
+
+    static bool generate(const QList<CanMessage *> &messages, const Options &options, Output *output,
+                         QString *error = nullptr);
+    static bool writeFiles(const QString &directory, const Output &output, QString *error = nullptr);
+
+    static bool languageFromString(const QString &name, Language *language);
+};
+
+#endif // CODEGENERATOR_H
@@ -0,0 +1,522 @@
+#include "dbcdiff.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+using FieldChange = DbcDiff::FieldChange;
+
+QString number(double value)
+{
+    return QString::number(value, 'g', 15);
+}
+
+QString yesNo(bool value)
+{
+    return value ? QStringLiteral("Yes") : QStringLiteral("No");
+}
+
+void compareField(QList<FieldChange> &out, const QString &field, const QString &before, const QString &after)
+{
+    if (before != after) {
+        out.append(FieldChange{field, before, after});
+    }
+}
+
+void compareField(QList<FieldChange> &out, const QString &field, int before, int after)
+{
+    if (before != after) {
+        out.append(FieldChange{field, QString::number(before), QString::number(after)});
+    }
+}
+
+void compareField(QList<FieldChange> &out, const QString &field, double before, double after)
+{
+    if (before != after) {
+        out.append(FieldChange{field, number(before), number(after)});
+    }
+}
+
+/** Attribute stores of both databases, for resolving values against each side's defaults. */
+struct AttributeSides
+{
+    const AttributeStore *before;
+    const AttributeStore *after;
+};
+
+/**
+ * Per-attribute diff of the values set on one object, each side resolved against its own
+ * defaults, so an entry dropped because it now equals a changed default is no change.
+ * Objects that set nothing follow the default, whose change is reported once per database.
+ */
+void compareAttributes(QList<FieldChange> &out, const AttributeSides &sides,
+                       const AttributeValues &before, const AttributeValues &after)
+{
+    if (before == after) {
+        return;
+    }
+    QVector<int> ids;
+    ids.reserve(before.size() + after.size());
+    for (const AttributeValues *values : {&before, &after}) {
+        for (const AttributeValues::Entry &entry : *values) {
+            ids.append(entry.id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    for (int id : ids) {
+        const QString b = sides.before->contains(id) ? sides.before->value(id, before).toString() : QString();
+        const QString a = sides.after->contains(id) ? sides.after->value(id, after).toString() : QString();
+        compareField(out, QString("Attribute %1").arg(AttributeStore::nameOf(id)), b, a);
+    }
+}
+
+/** Definitions and defaults by attribute ID (except model-field ones), then network and node values. */
+void compareAttributeStores(QList<FieldChange> &out, const AttributeStore &before, const AttributeStore &after)
+{
+    const AttributeSides sides{&before, &after};
+    QVector<int> ids;
+    ids.reserve(before.definitions().size() + after.definitions().size());
+    for (const AttributeStore::Definition &definition : before.definitions()) {
+        ids.append(definition.id);
+    }
+    for (const AttributeStore::Definition &definition : after.definitions()) {
+        if (!before.contains(definition.id)) {
+            ids.append(definition.id);
+        }
+    }
+    for (int id : ids) {
+        if (AttributeStore::isModelAttribute(id)) {
+            continue; // backed by model fields, which are compared per message/signal
+        }
+        const AttributeStore::Definition *b = before.definition(id);
+        const AttributeStore::Definition *a = after.definition(id);
+        const QString name = AttributeStore::nameOf(id);
+        compareField(out, QString("Attribute Definition %1").arg(name),
+                     b ? before.formatDefinition(*b) : QString(), a ? after.formatDefinition(*a) : QString());
+        if (b && a) {
+            compareField(out, QString("Attribute Default %1").arg(name),
+                         before.value(id, AttributeValues()).toString(), after.value(id, AttributeValues()).toString());
+        }
+    }
+
+    QList<FieldChange> values;
+    compareAttributes(values, sides, before.networkValues(), after.networkValues());
+    for (FieldChange &value : values) {
+        value.field.prepend(QLatin1String("Network "));
+        out.append(value);
+    }
+    QStringList nodes = before.nodeValues().keys();
+    for (auto it = after.nodeValues().constBegin(); it != after.nodeValues().constEnd(); ++it) {
+        if (!before.nodeValues().contains(it.key())) {
+            nodes.append(it.key());
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    for (const QString &node : nodes) {
+        values.clear();
+        compareAttributes(values, sides, before.nodeValues().value(node), after.nodeValues().value(node));
+        for (FieldChange &value : values) {
+            value.field = QString("Node %1 %2").arg(node, value.field);
+            out.append(value);
+        }
+    }
+}
+
+/** Entry-wise diff of two value tables (both maps are key-sorted, so a single merge pass). */
+void compareValueTables(QList<FieldChange> &out, const QMap<int, QString> &before, const QMap<int, QString> &after)
+{
+    auto a = before.constBegin();
+    auto b = after.constBegin();
+    while (a != before.constEnd() || b != after.constEnd()) {
+        if (b == after.constEnd() || (a != before.constEnd() && a.key() < b.key())) {
+            out.append(FieldChange{QString("Value %1").arg(a.key()), a.value(), QString()});
+            ++a;
+        } else if (a == before.constEnd() || b.key() < a.key()) {
+            out.append(FieldChange{QString("Value %1").arg(b.key()), QString(), b.value()});
+            ++b;
+        } else {
+            compareField(out, QString("Value %1").arg(a.key()), a.value(), b.value());
+            ++a;
+            ++b;
+        }
+    }
+}
+
+/** Set-like diff of two string lists (e.g. nodes, receivers), reported per entry. */
+void compareNames(QList<FieldChange> &out, const QString &field, const QStringList &before, const QStringList &after)
+{
+    if (before == after) {
+        return;
+    }
+    QSet<QString> beforeSet;
+    QSet<QString> afterSet;
+    for (const QString &name : before) {
+        beforeSet.insert(name);
+    }
+    for (const QString &name : after) {
+        afterSet.insert(name);
+    }
+    for (const QString &name : before) {
+        if (!afterSet.contains(name)) {
+            out.append(FieldChange{field, name, QString()});
+        }
+    }
+    for (const QString &name : after) {
+        if (!beforeSet.contains(name)) {
+            out.append(FieldChange{field, QString(), name});
+        }
+    }
+}
+
+QList<FieldChange> compareMessageFields(const AttributeSides &sides, const CanMessage &a, const CanMessage &b)
+{
+    QList<FieldChange> out;
+    if (a.sharesFieldsWith(b)) {
+        return out;
+    }
+    compareField(out, "Name", a.getName(), b.getName());
+    compareField(out, "Length", a.getLength(), b.getLength());
+    compareField(out, "Transmitter", a.getTransmitter(), b.getTransmitter());
+    compareField(out, "Cycle Time", a.getCycleTime(), b.getCycleTime());
+    compareField(out, "Frame Format", a.getFrameFormat(), b.getFrameFormat());
+    compareField(out, "Send Type", a.getSendType(), b.getSendType());
+    compareField(out, "Cycle Time Fast", a.getCycleTimeFast(), b.getCycleTimeFast());
+    compareField(out, "Nr Of Repetitions", a.getNrOfRepetitions(), b.getNrOfRepetitions());
+    compareField(out, "Delay Time", a.getDelayTime(), b.getDelayTime());
+    compareField(out, "Message Type", a.getMessageType(), b.getMessageType());
+    compareField(out, "Comment", a.getComment(), b.getComment());
+    compareNames(out, "Receiver", a.getReceivers(), b.getReceivers());
+    compareAttributes(out, sides, a.getAttributes(), b.getAttributes());
+    return out;
+}
+
+QList<FieldChange> compareSignalFields(const AttributeSides &sides, const CanSignal &a, const CanSignal &b)
+{
+    QList<FieldChange> out;
+    if (a.isSharedWith(b)) {
+        return out;
+    }
+    compareField(out, "Start Bit", a.getStartBit(), b.getStartBit());
+    compareField(out, "Length", a.getLength(), b.getLength());
+    compareField(out, "Byte Order", a.getByteOrder(), b.getByteOrder());
+    compareField(out, "Signed", yesNo(a.isSigned()), yesNo(b.isSigned()));
+    compareField(out, "Factor", a.getFactor(), b.getFactor());
+    compareField(out, "Offset", a.getOffset(), b.getOffset());
+    compareField(out, "Min", a.getMin(), b.getMin());
+    compareField(out, "Max", a.getMax(), b.getMax());
+    compareField(out, "Unit", a.getUnit(), b.getUnit());
+    compareNames(out, "Receiver", a.getReceivers(), b.getReceivers());
+    compareField(out, "Description", a.getDescription(), b.getDescription());
+    compareField(out, "Send Type", a.getSendType(), b.getSendType());
+    compareField(out, "Initial Value", a.getInitialValue(), b.getInitialValue());
+    compareField(out, "Invalid Value", a.getInvalidValueHex(), b.getInvalidValueHex());
+    compareField(out, "Inactive Value", a.getInactiveValueHex(), b.getInactiveValueHex());
+    if (a.hasRawRange() != b.hasRawRange() || a.getRawMin() != b.getRawMin() || a.getRawMax() != b.getRawMax()) {
+        auto range = [](const CanSignal &s) {
+            return s.hasRawRange() ? QString("%1..%2").arg(number(s.getRawMin()), number(s.getRawMax())) : QString();
+        };
+        out.append(FieldChange{"Raw Range", range(a), range(b)});
+    }
+    compareValueTables(out, a.getValueTable(), b.getValueTable());
+    compareAttributes(out, sides, a.getAttributes(), b.getAttributes());
+    return out;
+}
+
+QList<DbcDiff::SignalChange> compareSignalLists(const AttributeSides &sides, const QVector<CanSignal> &before,
+                                               const QVector<CanSignal> &after)
+{
+    // Signals are matched by name; duplicate names pair up in order of appearance.
+    QHash<QString, QVector<int>> afterRows;
+    afterRows.reserve(after.size());
+    for (int i = 0; i < after.size(); ++i) {
+        afterRows[after.at(i).getName()].append(i);
+    }
+
+    QList<DbcDiff::SignalChange> changes;
+    QVector<bool> matched(after.size(), false);
+    for (const CanSignal &old : before) {
+        QVector<int> &rows = afterRows[old.getName()];
+        DbcDiff::SignalChange change;
+        change.name = old.getName();
+        if (rows.isEmpty()) {
+            change.kind = DbcDiff::Removed;
+            changes.append(change);
+            continue;
+        }
+        const int row = rows.takeFirst();
+        matched[row] = true;
+        change.fields = compareSignalFields(sides, old, after.at(row));
+        if (!change.fields.isEmpty()) {
+            changes.append(change);
+        }
+    }
+    for (int i = 0; i < after.size(); ++i) {
+        if (!matched.at(i)) {
+            DbcDiff::SignalChange change;
+            change.kind = DbcDiff::Added;
+            change.name = after.at(i).getName();
+            changes.append(change);
+        }
+    }
+    return changes;
+}
+
+QJsonArray fieldsToJson(const QList<FieldChange> &fields)
+{
+    QJsonArray array;
+    for (const FieldChange &f : fields) {
+        QJsonObject object;
+        object.insert("field", f.field);
+        object.insert("before", f.before);
+        object.insert("after", f.after);
+        array.append(object);
+    }
+    return array;
+}
+
+QString fieldText(const FieldChange &f)
+{
+    if (f.before.isEmpty()) {
+        return QString("%1: + \"%2\"").arg(f.field, f.after);
+    }
+    if (f.after.isEmpty()) {
+        return QString("%1: - \"%2\"").arg(f.field, f.before);
+    }
+    return QString("%1: \"%2\" -> \"%3\"").arg(f.field, f.before, f.after);
+}
+
+QString formattedId(const DbcDiff::MessageChange &change)
+{
+    return (change.kind == DbcDiff::Added ? change.after : change.before).message().getFormattedId();
+}
+
+QChar kindMarker(DbcDiff::Kind kind)
+{
+    switch (kind) {
+    case DbcDiff::Added: return QLatin1Char('+');
+    case DbcDiff::Removed: return QLatin1Char('-');
+    case DbcDiff::Modified: return QLatin1Char('~');
+    }
+    return QLatin1Char('?');
+}
+
+} // namespace
+
+int DbcDiff::count(Kind kind) const
+{
+    int n = 0;
+    for (const MessageChange &change : messages) {
+        n += change.kind == kind ? 1 : 0;
+    }
+    return n;
+}
+
+DbcDiff DbcDiffer::diff(const DbcSnapshot &before, const DbcSnapshot &after)
+{
+    DbcDiff result;
+    compareField(result.databaseFields, "Version", before.version, after.version);
+    compareField(result.databaseFields, "Bus Type", before.busType, after.busType);
+    compareField(result.databaseFields, "Document Title", before.documentTitle, after.documentTitle);
+    compareNames(result.databaseFields, "Node", before.nodes, after.nodes);
+    compareAttributeStores(result.databaseFields, before.attributes, after.attributes);
+    QHash<QString, QMap<int, QString>> afterTables;
+    for (const auto &table : after.globalValueTables) {
+        afterTables.insert(table.first, table.second);
+    }
+    for (const auto &table : before.globalValueTables) {
+        const auto it = afterTables.constFind(table.first);
+        if (it == afterTables.constEnd()) {
+            result.databaseFields.append(FieldChange{"Value Table", table.first, QString()});
+        } else {
+            QList<FieldChange> entries;
+            compareValueTables(entries, table.second, it.value());
+            for (FieldChange &entry : entries) {
+                entry.field = QString("Value Table %1 %2").arg(table.first, entry.field);
+                result.databaseFields.append(entry);
+            }
+            afterTables.remove(table.first);
+        }
+    }
+    for (const auto &table : after.globalValueTables) {
+        if (afterTables.contains(table.first)) {
+            result.databaseFields.append(FieldChange{"Value Table", QString(), table.first});
+        }
+    }
+
+    // Messages are matched by ID; duplicate IDs pair up in order of appearance.
+    const AttributeSides sides{&before.attributes, &after.attributes};
+    QHash<quint32, QVector<int>> afterRows;
+    afterRows.reserve(after.messages.size());
+    for (int i = 0; i < after.messages.size(); ++i) {
+        afterRows[after.messages.at(i).message().getId()].append(i);
+    }
+    QVector<bool> matched(after.messages.size(), false);
+    for (const MessageSnapshot &old : before.messages) {
+        DbcDiff::MessageChange change;
+        change.id = old.message().getId();
+        change.name = old.message().getName();
+        change.before = old;
+        QVector<int> &rows = afterRows[change.id];
+        if (rows.isEmpty()) {
+            change.kind = DbcDiff::Removed;
+            result.messages.append(change);
+            continue;
+        }
+        const int row = rows.takeFirst();
+        matched[row] = true;
+        const MessageSnapshot &current = after.messages.at(row);
+        change.fields = compareMessageFields(sides, old.message(), current.message());
+        change.signalChanges = compareSignalLists(sides, old.signalList(), current.signalList());
+        if (!change.fields.isEmpty() || !change.signalChanges.isEmpty()) {
+            change.name = current.message().getName();
+            change.after = current;
+            result.messages.append(change);
+        }
+    }
+    for (int i = 0; i < after.messages.size(); ++i) {
+        if (!matched.at(i)) {
+            DbcDiff::MessageChange change;
+            change.kind = DbcDiff::Added;
+            change.id = after.messages.at(i).message().getId();
+            change.name = after.messages.at(i).message().getName();
+            change.after = after.messages.at(i);
+            result.messages.append(change);
+        }
+    }
+    return result;
+}
+
+QString DbcDiffer::kindName(DbcDiff::Kind kind)
+{
+    switch (kind) {
+    case DbcDiff::Added: return QStringLiteral("added");
+    case DbcDiff::Removed: return QStringLiteral("removed");
+    case DbcDiff::Modified: return QStringLiteral("modified");
+    }
+    return QString();
+}
+
+QJsonObject DbcDiffer::toJson(const DbcDiff &diff)
+{
+    QJsonArray messages;
+    for (const DbcDiff::MessageChange &change : diff.messages) {
+        QJsonObject object;
+        object.insert("kind", kindName(change.kind));
+        object.insert("id", static_cast<qint64>(change.id));
+        object.insert("idHex", formattedId(change));
+        object.insert("name", change.name);
+        if (change.kind == DbcDiff::Modified) {
+            object.insert("fields", fieldsToJson(change.fields));
+            QJsonArray signalArray;
+            for (const DbcDiff::SignalChange &signalChange : change.signalChanges) {
+                QJsonObject signalObject;
+                signalObject.insert("kind", kindName(signalChange.kind));
+                signalObject.insert("name", signalChange.name);
+                if (signalChange.kind == DbcDiff::Modified) {
+                    signalObject.insert("fields", fieldsToJson(signalChange.fields));
+                }
+                signalArray.append(signalObject);
+            }
+            object.insert("signals", signalArray);
+        }
+        messages.append(object);
+    }
+
+    QJsonObject summary;
+    summary.insert("added", diff.count(DbcDiff::Added));
+    summary.insert("removed", diff.count(DbcDiff::Removed));
+    summary.insert("modified", diff.count(DbcDiff::Modified));
+    summary.insert("databaseFields", diff.databaseFields.size());
+
+    QJsonObject root;
+    root.insert("summary", summary);
+    root.insert("database", fieldsToJson(diff.databaseFields));
+    root.insert("messages", messages);
+    return root;
+}
+
+QString DbcDiffer::toText(const DbcDiff &diff)
+{
+    QString text;
+    for (const FieldChange &f : diff.databaseFields) {
+        text += QString("~ %1\n").arg(fieldText(f));
+    }
+    for (const DbcDiff::MessageChange &change : diff.messages) {
+        text += QString("%1 %2 %3\n").arg(kindMarker(change.kind)).arg(formattedId(change), change.name);
+        for (const FieldChange &f : change.fields) {
+            text += QString("    %1\n").arg(fieldText(f));
+        }
+        for (const DbcDiff::SignalChange &signalChange : change.signalChanges) {
+            text += QString("    %1 signal %2\n").arg(kindMarker(signalChange.kind)).arg(signalChange.name);
+            for (const FieldChange &f : signalChange.fields) {
+                text += QString("        %1\n").arg(fieldText(f));
+            }
+        }
+    }
+    text += QString("%1 added, %2 removed, %3 modified\n")
+        .arg(diff.count(DbcDiff::Added)).arg(diff.count(DbcDiff::Removed)).arg(diff.count(DbcDiff::Modified));
+    return text;
+}
+
+QList<DbcExcelConverter::ChangeHistoryEntry> DbcDiffer::changeHistoryEntries(const DbcDiff &diff,
+                                                                            const QString &protocolVersion,
+                                                                            const QString &changer,
+                                                                            const QDate &date,
+                                                                            int firstSerial)
+{
+    QList<DbcExcelConverter::ChangeHistoryEntry> entries;
+    auto append = [&](const QString &content) {
+        DbcExcelConverter::ChangeHistoryEntry entry;
+        entry.serialNumber = QString::number(firstSerial + entries.size());
+        entry.protocolVersion = protocolVersion;
+        entry.changeContent = content;
+        entry.changer = changer;
+        entry.changeDate = date.toString(Qt::ISODate);
+        entries.append(entry);
+    };
+
+    if (!diff.databaseFields.isEmpty()) {
+        QStringList lines;
+        for (const FieldChange &f : diff.databaseFields) {
+            lines << fieldText(f);
+        }
+        append(QObject::tr("修改数据库属性：\n%1").arg(lines.join(QLatin1Char('\n'))));
+    }
+    for (const DbcDiff::MessageChange &change : diff.messages) {
+        const QString message = QString("%1 (%2)").arg(change.name, formattedId(change));
+        if (change.kind == DbcDiff::Added) {
+            append(QObject::tr("新增报文 %1").arg(message));
+            continue;
+        }
+        if (change.kind == DbcDiff::Removed) {
+            append(QObject::tr("删除报文 %1").arg(message));
+            continue;
+        }
+        QStringList lines;
+        for (const FieldChange &f : change.fields) {
+            lines << fieldText(f);
+        }
+        for (const DbcDiff::SignalChange &signalChange : change.signalChanges) {
+            if (signalChange.kind == DbcDiff::Added) {
+                lines << QObject::tr("新增信号 %1").arg(signalChange.name);
+            } else if (signalChange.kind == DbcDiff::Removed) {
+                lines << QObject::tr("删除信号 %1").arg(signalChange.name);
+            } else {
+                QStringList fields;
+                for (const FieldChange &f : signalChange.fields) {
+                    fields << fieldText(f);
+                }
+                lines << QObject::tr("信号 %1：%2").arg(signalChange.name, fields.join(QStringLiteral("; ")));
+            }
+        }
+        append(QObject::tr("修改报文 %1：\n%2").arg(message, lines.join(QLatin1Char('\n'))));
+    }
+    return entries;
+}
@@ -0,0 +1,79 @@
+#ifndef DBCDIFF_H
+#define DBCDIFF_H
+
+#include <QDate>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+#include "dbcexcelconverter.h"
+#include "dbcsnapshot.h"
+
+/**
+ * Field-level difference between two databases. Messages are matched by CAN ID and
+ * signals by name (hash lookups, so a diff is linear in the database size).
+ */
+struct DbcDiff
+{
+    enum Kind
+    {
+        Added,
+        Removed,
+        Modified
+    };
+
+    struct FieldChange
+    {
+        QString field;   // e.g. "Start Bit", "Value 3"
+        QString before;  // empty when the field/entry did not exist
+        QString after;
+    };
+
+    struct SignalChange
+    {
+        Kind kind = Modified;
+        QString name;
+        QList<FieldChange> fields; // Modified only
+    };
+
+    struct MessageChange
+    {
+        Kind kind = Modified;
+        quint32 id = 0;
+        QString name;
+        QList<FieldChange> fields;          // message-level fields (Modified only)
+        QList<SignalChange> signalChanges;  // Modified only
+        MessageSnapshot before;             // empty for Added
+        MessageSnapshot after;              // empty for Removed
+    };
+
+    QList<FieldChange> databaseFields;      // version, bus type, nodes, attributes, ...
+    QList<MessageChange> messages;          // before order, then messages only in after
+
+    bool isEmpty() const { return databaseFields.isEmpty() && messages.isEmpty(); }
+    int count(Kind kind) const;
+};
+
+class DbcDiffer
+{
+public:
+    static DbcDiff diff(const DbcSnapshot &before, const DbcSnapshot &after);
+
+    static QString kindName(DbcDiff::Kind kind);
+    /** Stable machine-readable form: {"database": [...], "messages": [...], "summary": {...}}. */
+    static QJsonObject toJson(const DbcDiff &diff);
+    /** Unified-diff-like human-readable report. */
+    static QString toText(const DbcDiff &diff);
+
+    /**
+     * One change-history row per changed message (plus one for database-level fields),
+     * numbered from firstSerial, ready to append to the document's change history.
+     */
+    static QList<DbcExcelConverter::ChangeHistoryEntry> changeHistoryEntries(const DbcDiff &diff,
+                                                                            const QString &protocolVersion,
+                                                                            const QString &changer,
+                                                                            const QDate &date,
+                                                                            int firstSerial = 1);
+};
+
+#endif // DBCDIFF_H
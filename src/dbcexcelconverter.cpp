@@ -1,11 +1,17 @@
 #include "dbcexcelconverter.h"
+#include "trace.h"
 
 #include <QDateTime>
+#include <QFuture>
+#include <QHash>
 #include <QMap>
+#include <QSet>
+#include <QVector>
 #include <QLocale>
 #include <QRegularExpression>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <QtConcurrent>
 #include <QtGlobal>
 
 #include <algorithm>
@@ -15,6 +21,7 @@
 #include <utility>
 
 #include "miniz.h"
+#include "xlsxarchive.h"
 
 namespace {
 QStringList headerLabels()
@@ -328,6 +335,7 @@ QByteArray generateContentTypesXml(int sheetCount)
         data.append(".xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>");
     }
     data.append("<Override PartName=\"/xl/styles.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.styles+xml\"/>"
+        "<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sharedStrings+xml\"/>"
         "<Override PartName=\"/docProps/core.xml\" ContentType=\"application/vnd.openxmlformats-package.core-properties+xml\"/>"
         "<Override PartName=\"/docProps/app.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.extended-properties+xml\"/>"
         "</Types>");
@@ -361,6 +369,9 @@ QByteArray generateWorkbookRels(int sheetCount)
     data.append("<Relationship Id=\"rId");
     data.append(QString::number(sheetCount + 1).toUtf8());
     data.append("\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/styles\" Target=\"styles.xml\"/>"
+        "<Relationship Id=\"rId");
+    data.append(QString::number(sheetCount + 2).toUtf8());
+    data.append("\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/sharedStrings\" Target=\"sharedStrings.xml\"/>"
         "</Relationships>");
     return data;
 }
@@ -552,42 +563,91 @@ void writeCoverTitleCell(QXmlStreamWriter &writer, int row, int column, int styl
     writer.writeEndElement();
 }
 
-void writeInlineStringCell(QXmlStreamWriter &writer, int row, int column, int style, const QString &value)
+void writeStyledEmptyCell(QXmlStreamWriter &writer, int row, int column, int styleId)
 {
-    if (value.isEmpty()) {
-        return;
-    }
     writer.writeStartElement("c");
     writer.writeAttribute("r", cellReference(row, column));
-    writer.writeAttribute("t", "inlineStr");
-    if (style >= 0) {
-        writer.writeAttribute("s", QString::number(style));
-    }
-    writer.writeStartElement("is");
-    writer.writeStartElement("t");
-    writer.writeCharacters(value);
-    writer.writeEndElement();
-    writer.writeEndElement();
+    writer.writeAttribute("s", QString::number(styleId));
     writer.writeEndElement();
 }
 
-void writeStyledEmptyCell(QXmlStreamWriter &writer, int row, int column, int styleId)
+void writeNumericCell(QXmlStreamWriter &writer, int row, int column, int style, double value)
 {
     writer.writeStartElement("c");
     writer.writeAttribute("r", cellReference(row, column));
-    writer.writeAttribute("s", QString::number(styleId));
+    if (style >= 0) {
+        writer.writeAttribute("s", QString::number(style));
+    }
+    writer.writeStartElement("v");
+    writer.writeCharacters(doubleToString(value));
+    writer.writeEndElement();
     writer.writeEndElement();
 }
 
-void writeNumericCell(QXmlStreamWriter &writer, int row, int column, int style, double value)
+// Deduplicated string table for xl/sharedStrings.xml; cells reference entries by index.
+class SharedStringTable
+{
+public:
+    // Returns -1 for empty strings, which are written as no cell at all.
+    int add(const QString &value)
+    {
+        if (value.isEmpty()) {
+            return -1;
+        }
+        const auto it = m_index.constFind(value);
+        if (it != m_index.constEnd()) {
+            return it.value();
+        }
+        const int index = m_strings.size();
+        m_strings.append(value);
+        m_index.insert(value, index);
+        return index;
+    }
+
+    int size() const { return m_strings.size(); }
+
+    QByteArray toXml() const
+    {
+        QByteArray data;
+        QXmlStreamWriter writer(&data);
+        writer.writeStartDocument(QStringLiteral("1.0"), true);
+        writer.writeStartElement("sst");
+        writer.writeDefaultNamespace("http://schemas.openxmlformats.org/spreadsheetml/2006/main");
+        writer.writeAttribute("uniqueCount", QString::number(m_strings.size()));
+        for (const QString &value : m_strings) {
+            writer.writeStartElement("si");
+            writer.writeStartElement("t");
+            if (value.at(0).isSpace() || value.at(value.size() - 1).isSpace()
+                || value.contains(QLatin1Char('\n'))) {
+                writer.writeAttribute("xml:space", "preserve");
+            }
+            writer.writeCharacters(value);
+            writer.writeEndElement();
+            writer.writeEndElement();
+        }
+        writer.writeEndElement();
+        writer.writeEndDocument();
+        return data;
+    }
+
+private:
+    QHash<QString, int> m_index;
+    QStringList m_strings;
+};
+
+void writeSharedStringCell(QXmlStreamWriter &writer, int row, int column, int style, int stringIndex)
 {
+    if (stringIndex < 0) {
+        return;
+    }
     writer.writeStartElement("c");
     writer.writeAttribute("r", cellReference(row, column));
+    writer.writeAttribute("t", "s");
     if (style >= 0) {
         writer.writeAttribute("s", QString::number(style));
     }
     writer.writeStartElement("v");
-    writer.writeCharacters(doubleToString(value));
+    writer.writeCharacters(QString::number(stringIndex));
     writer.writeEndElement();
     writer.writeEndElement();
 }
@@ -679,7 +739,8 @@ static const char *kChangeHistoryHeaders[] = {
     "审核人"
 };
 
-QByteArray generateChangeHistorySheetXml(const QList<DbcExcelConverter::ChangeHistoryEntry> &changeHistory)
+QByteArray generateChangeHistorySheetXml(const QList<DbcExcelConverter::ChangeHistoryEntry> &changeHistory,
+                                         SharedStringTable &strings)
 {
     const int totalRows = 1 + changeHistory.size();
     QByteArray data;
@@ -721,7 +782,7 @@ QByteArray generateChangeHistorySheetXml(const QList<DbcExcelConverter::ChangeHi
     writer.writeAttribute("ht", "24");
     writer.writeAttribute("customHeight", "1");
     for (int col = 1; col <= kChangeHistoryColCount; ++col) {
-        writeInlineStringCell(writer, 1, col, 1, QString::fromUtf8(kChangeHistoryHeaders[col - 1]));
+        writeSharedStringCell(writer, 1, col, 1, strings.add(QString::fromUtf8(kChangeHistoryHeaders[col - 1])));
     }
     writer.writeEndElement();
 
@@ -732,12 +793,12 @@ QByteArray generateChangeHistorySheetXml(const QList<DbcExcelConverter::ChangeHi
         writer.writeAttribute("r", QString::number(row));
         writer.writeAttribute("ht", "24");
         writer.writeAttribute("customHeight", "1");
-        writeInlineStringCell(writer, row, 1, 2, e.serialNumber);
-        writeInlineStringCell(writer, row, 2, 2, e.protocolVersion);
-        writeInlineStringCell(writer, row, 3, 2, e.changeContent);
-        writeInlineStringCell(writer, row, 4, 2, e.changer);
-        writeInlineStringCell(writer, row, 5, 2, e.changeDate);
-        writeInlineStringCell(writer, row, 6, 2, e.reviewer);
+        writeSharedStringCell(writer, row, 1, 2, strings.add(e.serialNumber));
+        writeSharedStringCell(writer, row, 2, 2, strings.add(e.protocolVersion));
+        writeSharedStringCell(writer, row, 3, 2, strings.add(e.changeContent));
+        writeSharedStringCell(writer, row, 4, 2, strings.add(e.changer));
+        writeSharedStringCell(writer, row, 5, 2, strings.add(e.changeDate));
+        writeSharedStringCell(writer, row, 6, 2, strings.add(e.reviewer));
         writer.writeEndElement();
     }
 
@@ -755,29 +816,38 @@ QByteArray generateChangeHistorySheetXml(const QList<DbcExcelConverter::ChangeHi
     return data;
 }
 
-// Returns messages that belong to the given node: transmitted by node or any signal received by node.
-static QList<CanMessage*> messagesForNode(const QList<CanMessage*> &messages, const QString &node)
+// Groups messages by node in one pass: a message belongs to a node if the node transmits it
+// or receives any of its signals. Message order is preserved within each node.
+static QHash<QString, QList<CanMessage*>> messagesByNode(const QList<CanMessage*> &messages, const QStringList &nodes)
 {
-    if (node.isEmpty()) {
-        return messages;
+    QHash<QString, QList<CanMessage*>> index;
+    for (const QString &node : nodes) {
+        index.insert(node, QList<CanMessage*>());
     }
-    QList<CanMessage*> out;
+    QSet<QString> seen;
     for (CanMessage *msg : messages) {
         if (!msg) {
             continue;
         }
-        if (msg->getTransmitter() == node) {
-            out.append(msg);
-            continue;
+        seen.clear();
+        const QString &transmitter = msg->getTransmitter();
+        if (index.contains(transmitter)) {
+            index[transmitter].append(msg);
+            seen.insert(transmitter);
         }
         for (const CanSignal *sig : msg->getSignals()) {
-            if (sig && sig->getReceivers().contains(node)) {
-                out.append(msg);
-                break;
+            if (!sig) {
+                continue;
+            }
+            for (const QString &receiver : sig->getReceivers()) {
+                if (!seen.contains(receiver) && index.contains(receiver)) {
+                    index[receiver].append(msg);
+                    seen.insert(receiver);
+                }
             }
         }
     }
-    return out;
+    return index;
 }
 
 // Excel sheet names: max 31 chars, cannot contain \ / ? * [ ]
@@ -797,10 +867,90 @@ static QString sanitizeSheetName(const QString &name)
     return s;
 }
 
-QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QString &busType, bool withFreezePanes)
+// Shared-string indices of the text cells of one message row and its signal rows (-1 = empty).
+struct MessageCellStrings
+{
+    struct SignalStrings
+    {
+        int name = -1;
+        int description = -1;
+        int byteOrder = -1;
+        int sendType = -1;
+        int valueType = -1;
+        int minHex = -1;
+        int maxHex = -1;
+        int initialHex = -1;
+        int invalidHex = -1;
+        int inactiveHex = -1;
+        int unit = -1;
+        int valueTable = -1;
+    };
+
+    int name = -1;
+    int messageType = -1;
+    int id = -1;
+    int transmitter = -1;
+    int receivers = -1;
+    int sendType = -1;
+    int comment = -1;
+    QVector<SignalStrings> signalStrings; // parallel to CanMessage::getSignals()
+};
+
+using MessageCellMap = QHash<const CanMessage*, MessageCellStrings>;
+
+// Formats and interns the text cells of a message once, however many ECU sheets it appears on.
+MessageCellStrings internMessageCells(const CanMessage *message, const QString &busType, SharedStringTable &strings)
+{
+    MessageCellStrings cells;
+    cells.name = strings.add(message->getName());
+    QString msgType = message->getMessageType().isEmpty() ? message->getFrameFormat() : message->getMessageType();
+    if (msgType.isEmpty()) {
+        msgType = busType.contains(QLatin1String("FD"), Qt::CaseInsensitive) ? QStringLiteral("CANFD Standard") : QStringLiteral("CAN Standard");
+    }
+    cells.messageType = strings.add(msgType);
+    cells.id = strings.add(QString("0x%1").arg(message->getId(), 0, 16).toUpper());
+    cells.transmitter = strings.add(message->getTransmitter());
+    QStringList rxForExport;
+    for (const QString &r : message->getReceivers()) {
+        if (r.compare(QStringLiteral("Vector__XXX"), Qt::CaseInsensitive) != 0) {
+            rxForExport.append(r);
+        }
+    }
+    cells.receivers = strings.add(rxForExport.join(QStringLiteral(", ")));
+    cells.sendType = strings.add(message->getSendType());
+    cells.comment = strings.add(message->getComment());
+
+    const QList<CanSignal*> &messageSignals = message->getSignals();
+    cells.signalStrings.resize(messageSignals.size());
+    for (int i = 0; i < messageSignals.size(); ++i) {
+        const CanSignal *signal = messageSignals.at(i);
+        if (!signal) {
+            continue;
+        }
+        MessageCellStrings::SignalStrings &sig = cells.signalStrings[i];
+        sig.name = strings.add(signal->getName());
+        sig.description = strings.add(signal->getDescription());
+        sig.byteOrder = strings.add(signal->getByteOrder() == 0 ? QStringLiteral("Intel LSB") : QStringLiteral("Motorola MSB"));
+        sig.sendType = strings.add(signal->getSendType());
+        sig.valueType = strings.add(signal->isSigned() ? QStringLiteral("signed") : QStringLiteral("unsigned"));
+        sig.minHex = strings.add(formatHex(physicalToRawMasked(signal, signal->getMin())));
+        sig.maxHex = strings.add(formatHex(physicalToRawMasked(signal, signal->getMax())));
+        sig.initialHex = strings.add(
+            formatHex(static_cast<quint64>(std::llround(signal->getInitialValue())) & maskForLength(signal->getLength())));
+        sig.invalidHex = strings.add(signal->getInvalidValueHex());
+        sig.inactiveHex = strings.add(signal->getInactiveValueHex());
+        sig.unit = strings.add(signal->getUnit());
+        sig.valueTable = strings.add(formatValueTable(signal->getValueTable()));
+    }
+    return cells;
+}
+
+// Only reads the string table: all cells were interned up front, so sheets can be generated concurrently.
+QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, bool withFreezePanes,
+                                const QVector<int> &headerStrings, const MessageCellMap &messageCells)
 {
-    const QStringList headers = headerLabels();
-    const int columnCount = headers.size();
+    DBC_TRACE_SCOPE("generateWorksheetXml");
+    const int columnCount = headerStrings.size();
 
     QByteArray data;
     QXmlStreamWriter writer(&data);
@@ -908,7 +1058,7 @@ QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QStrin
     writer.writeAttribute("ht", "30");
     writer.writeAttribute("customHeight", "1");
     for (int col = 1; col <= columnCount; ++col) {
-        writeInlineStringCell(writer, currentRow, col, 1, headers.at(col - 1));
+        writeSharedStringCell(writer, currentRow, col, 1, headerStrings.at(col - 1));
     }
     writer.writeEndElement();
 
@@ -916,6 +1066,7 @@ QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QStrin
         if (!message) {
             continue;
         }
+        const MessageCellStrings &cells = *messageCells.constFind(message);
         ++currentRow;
         const int messageRow = currentRow;
         writer.writeStartElement("row");
@@ -924,36 +1075,28 @@ QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QStrin
         writer.writeAttribute("customFormat", "1");
         writer.writeAttribute("ht", "24");
         writer.writeAttribute("customHeight", "1");
-        writeInlineStringCell(writer, currentRow, 1, 2, message->getName());
-        QString msgType = message->getMessageType().isEmpty() ? message->getFrameFormat() : message->getMessageType();
-        if (msgType.isEmpty()) {
-            msgType = busType.contains(QLatin1String("FD"), Qt::CaseInsensitive) ? QStringLiteral("CANFD Standard") : QStringLiteral("CAN Standard");
-        }
-        writeInlineStringCell(writer, currentRow, 2, 2, msgType);
-        writeInlineStringCell(writer, currentRow, 3, 2, QString("0x%1").arg(message->getId(), 0, 16).toUpper());
-        writeInlineStringCell(writer, currentRow, 4, 2, message->getTransmitter());
-        QStringList rxForExport;
-        for (const QString &r : message->getReceivers()) {
-            if (r.compare(QStringLiteral("Vector__XXX"), Qt::CaseInsensitive) != 0) {
-                rxForExport.append(r);
-            }
-        }
-        writeInlineStringCell(writer, currentRow, 5, 2, rxForExport.join(QStringLiteral(", ")));
-        writeInlineStringCell(writer, currentRow, 6, 2, message->getSendType());
+        writeSharedStringCell(writer, currentRow, 1, 2, cells.name);
+        writeSharedStringCell(writer, currentRow, 2, 2, cells.messageType);
+        writeSharedStringCell(writer, currentRow, 3, 2, cells.id);
+        writeSharedStringCell(writer, currentRow, 4, 2, cells.transmitter);
+        writeSharedStringCell(writer, currentRow, 5, 2, cells.receivers);
+        writeSharedStringCell(writer, currentRow, 6, 2, cells.sendType);
         writeNumericCell(writer, currentRow, 7, 2, message->getCycleTime());
         writeNumericCell(writer, currentRow, 8, 2, message->getLength());
         writeNumericCell(writer, currentRow, 9, 2, message->getCycleTimeFast());
         writeNumericCell(writer, currentRow, 10, 2, message->getNrOfRepetitions());
         writeNumericCell(writer, currentRow, 11, 2, message->getDelayTime());
-        writeInlineStringCell(writer, currentRow, 12, 2, message->getComment());
+        writeSharedStringCell(writer, currentRow, 12, 2, cells.comment);
         writer.writeEndElement();
 
-        const QList<CanSignal*> messageSignals = message->getSignals();
+        const QList<CanSignal*> &messageSignals = message->getSignals();
 
-        for (const CanSignal *signal : messageSignals) {
+        for (int i = 0; i < messageSignals.size(); ++i) {
+            const CanSignal *signal = messageSignals.at(i);
             if (!signal) {
                 continue;
             }
+            const MessageCellStrings::SignalStrings &sig = cells.signalStrings.at(i);
             ++currentRow;
             writer.writeStartElement("row");
             writer.writeAttribute("r", QString::number(currentRow));
@@ -965,26 +1108,25 @@ QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QStrin
             if (currentRow == messageRow + 1) {
                 writeStyledEmptyCell(writer, currentRow, 1, 2);
             }
-            writeInlineStringCell(writer, currentRow, 13, 3, signal->getName());
-            writeInlineStringCell(writer, currentRow, 14, 3, signal->getDescription());
-            writeInlineStringCell(writer, currentRow, 15, 3, signal->getByteOrder() == 0 ? "Intel LSB" : "Motorola MSB");
+            writeSharedStringCell(writer, currentRow, 13, 3, sig.name);
+            writeSharedStringCell(writer, currentRow, 14, 3, sig.description);
+            writeSharedStringCell(writer, currentRow, 15, 3, sig.byteOrder);
             writeNumericCell(writer, currentRow, 16, 3, signal->getStartBit() / 8);
             writeNumericCell(writer, currentRow, 17, 3, signal->getStartBit() % 8);
-            writeInlineStringCell(writer, currentRow, 18, 3, signal->getSendType());
+            writeSharedStringCell(writer, currentRow, 18, 3, sig.sendType);
             writeNumericCell(writer, currentRow, 19, 3, signal->getLength());
-            writeInlineStringCell(writer, currentRow, 20, 3, signal->isSigned() ? "signed" : "unsigned");
+            writeSharedStringCell(writer, currentRow, 20, 3, sig.valueType);
             writeNumericCell(writer, currentRow, 21, 3, signal->getFactor());
             writeNumericCell(writer, currentRow, 22, 3, signal->getOffset());
             writeNumericCell(writer, currentRow, 23, 3, signal->getMin());
             writeNumericCell(writer, currentRow, 24, 3, signal->getMax());
-            writeInlineStringCell(writer, currentRow, 25, 3, formatHex(physicalToRawMasked(signal, signal->getMin())));
-            writeInlineStringCell(writer, currentRow, 26, 3, formatHex(physicalToRawMasked(signal, signal->getMax())));
-            writeInlineStringCell(writer, currentRow, 27, 3,
-                formatHex(static_cast<quint64>(std::llround(signal->getInitialValue())) & maskForLength(signal->getLength())));
-            writeInlineStringCell(writer, currentRow, 28, 3, signal->getInvalidValueHex());
-            writeInlineStringCell(writer, currentRow, 29, 3, signal->getInactiveValueHex());
-            writeInlineStringCell(writer, currentRow, 30, 3, signal->getUnit());
-            writeInlineStringCell(writer, currentRow, 31, 3, formatValueTable(signal->getValueTable()));
+            writeSharedStringCell(writer, currentRow, 25, 3, sig.minHex);
+            writeSharedStringCell(writer, currentRow, 26, 3, sig.maxHex);
+            writeSharedStringCell(writer, currentRow, 27, 3, sig.initialHex);
+            writeSharedStringCell(writer, currentRow, 28, 3, sig.invalidHex);
+            writeSharedStringCell(writer, currentRow, 29, 3, sig.inactiveHex);
+            writeSharedStringCell(writer, currentRow, 30, 3, sig.unit);
+            writeSharedStringCell(writer, currentRow, 31, 3, sig.valueTable);
             writer.writeEndElement();
         }
 
@@ -1026,66 +1168,6 @@ QByteArray generateWorksheetXml(const QList<CanMessage*> &messages, const QStrin
     return data;
 }
 
-bool writeZipArchive(const QString &filePath, const QList<QPair<QString, QByteArray>> &entries, QString *error)
-{
-    mz_zip_archive archive;
-    memset(&archive, 0, sizeof(archive));
-    if (!mz_zip_writer_init_file(&archive, filePath.toUtf8().constData(), 0)) {
-        if (error) {
-            *error = QString("Failed to initialize archive writer for %1").arg(filePath);
-        }
-        return false;
-    }
-
-    for (const auto &entry : entries) {
-        if (!mz_zip_writer_add_mem(&archive, entry.first.toUtf8().constData(), entry.second.constData(), entry.second.size(), MZ_BEST_COMPRESSION)) {
-            if (error) {
-                *error = QString("Failed to add %1 to archive").arg(entry.first);
-            }
-            mz_zip_writer_end(&archive);
-            return false;
-        }
-    }
-
-    const bool ok = mz_zip_writer_finalize_archive(&archive);
-    mz_zip_writer_end(&archive);
-    if (!ok) {
-        if (error) {
-            *error = QString("Failed to finalize Excel archive %1").arg(filePath);
-        }
-        return false;
-    }
-    return true;
-}
-
-QByteArray readZipEntry(const QString &filePath, const QString &entryName, QString *error)
-{
-    mz_zip_archive archive;
-    memset(&archive, 0, sizeof(archive));
-    if (!mz_zip_reader_init_file(&archive, filePath.toUtf8().constData(), 0)) {
-        if (error) {
-            *error = QString("Failed to open %1 as zip archive").arg(filePath);
-        }
-        return QByteArray();
-    }
-
-    size_t size = 0;
-    void *buffer = mz_zip_reader_extract_file_to_heap(&archive, entryName.toUtf8().constData(), &size, 0);
-    mz_zip_reader_end(&archive);
-    if (!buffer || size == 0) {
-        if (error) {
-            *error = QString("Missing entry %1 in %2").arg(entryName, filePath);
-        }
-        if (buffer) {
-            mz_free(buffer);
-        }
-        return QByteArray();
-    }
-    QByteArray data(static_cast<const char*>(buffer), static_cast<int>(size));
-    mz_free(buffer);
-    return data;
-}
-
 QString normalizeSendType(const QString &value, bool isSignal)
 {
     static const QStringList msgTypes = {
@@ -1191,9 +1273,9 @@ quint64 parseHexToUInt64(const QString &text, bool *ok)
 using TableMap = QMap<int, QMap<int, QString>>;
 
 // Returns number of worksheet parts (sheet1, sheet2, ...) by reading workbook.xml.
-static int getWorkbookSheetCount(const QString &filePath, QString *error)
+static int getWorkbookSheetCount(const XlsxArchiveReader &archive, QString *error)
 {
-    const QByteArray wbXml = readZipEntry(filePath, QStringLiteral("xl/workbook.xml"), error);
+    const QByteArray wbXml = archive.read(QStringLiteral("xl/workbook.xml"), error);
     if (wbXml.isEmpty()) {
         return 0;
     }
@@ -1210,6 +1292,7 @@ static int getWorkbookSheetCount(const QString &filePath, QString *error)
 
 TableMap parseWorksheetToTable(const QByteArray &sheetXml, const QStringList &sharedStrings)
 {
+    DBC_TRACE_SCOPE("parseWorksheetToTable");
     TableMap table;
     QXmlStreamReader reader(sheetXml);
     while (!reader.atEnd()) {
@@ -1275,6 +1358,29 @@ TableMap parseWorksheetToTable(const QByteArray &sheetXml, const QStringList &sh
     return table;
 }
 
+struct SheetParseResult
+{
+    bool present = false;
+    TableMap table;
+};
+
+// Runs on a worker thread: opens a private reader over the shared package bytes.
+SheetParseResult parseDataSheet(const QByteArray &packageData, int sheetIndex, const QStringList &sharedStrings)
+{
+    SheetParseResult result;
+    XlsxArchiveReader reader;
+    if (!reader.openData(packageData)) {
+        return result;
+    }
+    const QByteArray sheetXml = reader.read(QStringLiteral("xl/worksheets/sheet%1.xml").arg(sheetIndex));
+    if (sheetXml.isEmpty()) {
+        return result;
+    }
+    result.present = true;
+    result.table = parseWorksheetToTable(sheetXml, sharedStrings);
+    return result;
+}
+
 QString titleFromCoverTable(const TableMap &table)
 {
     if (table.isEmpty()) {
@@ -1348,8 +1454,10 @@ bool DbcExcelConverter::exportToExcel(const QString &filePath,
                                       const QString &documentTitle,
                                       const QList<ChangeHistoryEntry> &changeHistory,
                                       bool splitByEcu,
+                                      CompressionLevel compression,
                                       QString *error)
 {
+    DBC_TRACE_SCOPE("DbcExcelConverter::exportToExcel");
     Q_UNUSED(version);
 
     static const QString kDefaultDocumentTitle = QStringLiteral(
@@ -1372,7 +1480,7 @@ bool DbcExcelConverter::exportToExcel(const QString &filePath,
     }
 
     const int sheetCount = 2 + dataSheetCount;
-    QList<QPair<QString, QByteArray>> entries;
+    QList<XlsxArchiveWriter::Entry> entries;
     entries.append({QStringLiteral("[Content_Types].xml"), generateContentTypesXml(sheetCount)});
     entries.append({QStringLiteral("_rels/.rels"), generateRootRels()});
     entries.append({QStringLiteral("xl/_rels/workbook.xml.rels"), generateWorkbookRels(sheetCount)});
@@ -1382,53 +1490,191 @@ bool DbcExcelConverter::exportToExcel(const QString &filePath,
     entries.append({QStringLiteral("docProps/app.xml"), generateAppProps(sheetCount, dataSheetNames)});
 
     entries.append({QStringLiteral("xl/worksheets/sheet1.xml"), generateCoverSheetXml(coverTitle)});
-    entries.append({QStringLiteral("xl/worksheets/sheet2.xml"), generateChangeHistorySheetXml(changeHistory)});
+
+    // Text cells go through one shared string table. Everything is interned here, in sheet
+    // order, so indices are deterministic and the worksheets below only read the table.
+    SharedStringTable strings;
+    entries.append({QStringLiteral("xl/worksheets/sheet2.xml"), generateChangeHistorySheetXml(changeHistory, strings)});
+
+    QVector<int> headerStrings;
+    for (const QString &header : headerLabels()) {
+        headerStrings.append(strings.add(header));
+    }
+
+    const bool perNode = splitByEcu && !nodes.isEmpty();
+    const QHash<QString, QList<CanMessage*>> nodeMessages = perNode
+        ? messagesByNode(messages, nodes)
+        : QHash<QString, QList<CanMessage*>>();
+    QList<QList<CanMessage*>> sheetMessages;
+    MessageCellMap messageCells;
     for (int i = 0; i < dataSheetCount; ++i) {
-        QList<CanMessage*> sheetMessages = (splitByEcu && !nodes.isEmpty())
-            ? messagesForNode(messages, nodes.at(i))
+        const QList<CanMessage*> sheet = (perNode && !nodes.at(i).isEmpty())
+            ? nodeMessages.value(nodes.at(i))
             : messages;
+        for (const CanMessage *message : sheet) {
+            if (message && !messageCells.contains(message)) {
+                messageCells.insert(message, internMessageCells(message, busType, strings));
+            }
+        }
+        sheetMessages.append(sheet);
+    }
+
+    // Worksheets are independent; build them on the thread pool and append in sheet order.
+    QList<QFuture<QByteArray>> sheets;
+    for (int i = 0; i < dataSheetCount; ++i) {
+        const QList<CanMessage*> sheet = sheetMessages.at(i);
+        const bool withFreezePanes = (i == 0);
+        sheets.append(QtConcurrent::run([sheet, withFreezePanes, headerStrings, messageCells]() {
+            return generateWorksheetXml(sheet, withFreezePanes, headerStrings, messageCells);
+        }));
+    }
+    for (int i = 0; i < dataSheetCount; ++i) {
         const QString path = QStringLiteral("xl/worksheets/sheet%1.xml").arg(i + 3);
-        entries.append({path, generateWorksheetXml(sheetMessages, busType, (i == 0))});
+        entries.append({path, sheets[i].result()});
+    }
+    entries.append({QStringLiteral("xl/sharedStrings.xml"), strings.toXml()});
+
+    int zipLevel;
+    switch (compression) {
+    case CompressionStore:
+        zipLevel = MZ_NO_COMPRESSION;
+        break;
+    case CompressionFast:
+        zipLevel = MZ_BEST_SPEED;
+        break;
+    case CompressionBest:
+        zipLevel = MZ_BEST_COMPRESSION;
+        break;
+    case CompressionBalanced:
+    default:
+        zipLevel = MZ_DEFAULT_LEVEL;
+        break;
+    }
+    return XlsxArchiveWriter::write(filePath, entries, zipLevel, error);
+}
+
+bool DbcExcelConverter::compressionLevelFromString(const QString &name, CompressionLevel *level)
+{
+    const QString key = name.trimmed().toLower();
+    CompressionLevel parsed;
+    if (key == QLatin1String("store")) {
+        parsed = CompressionStore;
+    } else if (key == QLatin1String("fast")) {
+        parsed = CompressionFast;
+    } else if (key == QLatin1String("balanced")) {
+        parsed = CompressionBalanced;
+    } else if (key == QLatin1String("best")) {
+        parsed = CompressionBest;
+    } else {
+        return false;
+    }
+    if (level) {
+        *level = parsed;
+    }
+    return true;
+}
+
+QString DbcExcelConverter::compressionLevelName(CompressionLevel level)
+{
+    switch (level) {
+    case CompressionStore:
+        return QStringLiteral("store");
+    case CompressionFast:
+        return QStringLiteral("fast");
+    case CompressionBest:
+        return QStringLiteral("best");
+    case CompressionBalanced:
+    default:
+        return QStringLiteral("balanced");
     }
+}
 
-    return writeZipArchive(filePath, entries, error);
+bool DbcExcelConverter::importFromExcel(const QString &filePath,
+                                        ImportResult &result,
+                                        QString *error)
+{
+    return importFromExcel(filePath, result, ProgressCallback(), error);
 }
 
 bool DbcExcelConverter::importFromExcel(const QString &filePath,
                                         ImportResult &result,
+                                        const ProgressCallback &progress,
                                         QString *error)
 {
+    DBC_TRACE_SCOPE("DbcExcelConverter::importFromExcel");
     result.clear();
-    const QByteArray sheet1Xml = readZipEntry(filePath, QStringLiteral("xl/worksheets/sheet1.xml"), error);
+    // Steps: package + shared strings, then parse and merge for each data sheet.
+    int progressDone = 0;
+    int progressTotal = 3;
+    auto reportProgress = [&](int messagesParsed) -> bool {
+        ++progressDone;
+        if (progress && !progress(progressDone, progressTotal, messagesParsed)) {
+            if (error) {
+                *error = QStringLiteral("Import cancelled");
+            }
+            return false;
+        }
+        return true;
+    };
+
+    XlsxArchiveReader archive;
+    if (!archive.open(filePath, error)) {
+        return false;
+    }
+    const QByteArray sheet1Xml = archive.read(QStringLiteral("xl/worksheets/sheet1.xml"), error);
     if (sheet1Xml.isEmpty()) {
         return false;
     }
 
     QString sstError;
-    const QByteArray sstXml = readZipEntry(filePath, QStringLiteral("xl/sharedStrings.xml"), &sstError);
+    const QByteArray sstXml = archive.read(QStringLiteral("xl/sharedStrings.xml"), &sstError);
     const QStringList sharedStrings = parseSharedStrings(sstXml);
 
     QString sheet2Error;
-    const QByteArray sheet2Xml = readZipEntry(filePath, QStringLiteral("xl/worksheets/sheet2.xml"), &sheet2Error);
+    const QByteArray sheet2Xml = archive.read(QStringLiteral("xl/worksheets/sheet2.xml"), &sheet2Error);
     const bool hasSheet2 = !sheet2Xml.isEmpty();
 
-    int workbookSheetCount = getWorkbookSheetCount(filePath, error);
+    int workbookSheetCount = getWorkbookSheetCount(archive, error);
     if (workbookSheetCount <= 0) {
         workbookSheetCount = hasSheet2 ? 2 : 1;
     }
+    progressTotal = 1 + 2 * qMax(1, workbookSheetCount - 2);
+    if (!reportProgress(0)) {
+        return false;
+    }
     // Data sheets: if 2 sheets total then sheet2 is data; if 3+ then sheet3, sheet4, ...
-    QList<QByteArray> dataSheetXmls;
+    // ECU sheets are independent until the merge, so each one is inflated and parsed on the
+    // global thread pool with its own reader over the shared package bytes. Results are
+    // collected in sheet order, which keeps the merge below deterministic.
+    QList<TableMap> dataSheetTables;
     if (workbookSheetCount == 2) {
         if (!sheet2Xml.isEmpty()) {
-            dataSheetXmls.append(sheet2Xml);
+            dataSheetTables.append(parseWorksheetToTable(sheet2Xml, sharedStrings));
+        }
+        if (!reportProgress(0)) {
+            return false;
         }
     } else {
+        const QByteArray packageData = archive.data();
+        QList<QFuture<SheetParseResult>> pending;
         for (int idx = 3; idx <= workbookSheetCount; ++idx) {
-            QString err;
-            const QByteArray dataXml = readZipEntry(filePath, QStringLiteral("xl/worksheets/sheet%1.xml").arg(idx), &err);
-            if (!dataXml.isEmpty()) {
-                dataSheetXmls.append(dataXml);
+            pending.append(QtConcurrent::run([packageData, sharedStrings, idx]() {
+                return parseDataSheet(packageData, idx, sharedStrings);
+            }));
+        }
+        bool cancelled = false;
+        for (QFuture<SheetParseResult> &future : pending) {
+            const SheetParseResult parsed = future.result();
+            if (parsed.present) {
+                dataSheetTables.append(parsed.table);
             }
+            // Workers already queued keep running; their results are just dropped.
+            if (!cancelled && !reportProgress(0)) {
+                cancelled = true;
+            }
+        }
+        if (cancelled) {
+            return false;
         }
     }
 
@@ -1480,7 +1726,7 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
     };
 
     TableMap singleTable;
-    if (dataSheetXmls.isEmpty()) {
+    if (dataSheetTables.isEmpty()) {
         singleTable = hasSheet2 ? parseWorksheetToTable(sheet2Xml, sharedStrings) : parseWorksheetToTable(sheet1Xml, sharedStrings);
         if (!hasSheet2) {
             result.documentTitle.clear();
@@ -1561,7 +1807,7 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
                                 merged.append(r);
                             }
                         }
-                        msg->setReceivers(merged);
+                        msg->setReceivers(std::move(merged));
                         for (const QString &r : rxList) {
                             nodeAccumulator.append(r);
                         }
@@ -1618,7 +1864,7 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
                             if (!valueOk) continue;
                             valueTable[rawValue] = line.mid(colonIndex + 1).trimmed();
                         }
-                        signal->setValueTable(valueTable);
+                        signal->setValueTable(std::move(valueTable));
                     }
                 } else {
                     signal->setDescription(row.value(8));
@@ -1656,7 +1902,7 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
                             if (!valueOk) continue;
                             valueTable[rawValue] = line.mid(colonIndex + 1).trimmed();
                         }
-                        signal->setValueTable(valueTable);
+                        signal->setValueTable(std::move(valueTable));
                     }
                 }
                 msg->addSignal(signal);
@@ -1670,7 +1916,7 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
                             merged.append(r);
                         }
                     }
-                    existingSignal->setReceivers(merged);
+                    existingSignal->setReceivers(std::move(merged));
                     for (const QString &receiver : receiverList) {
                         nodeAccumulator.append(receiver);
                     }
@@ -1679,10 +1925,9 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
         }
     };
 
-    if (!dataSheetXmls.isEmpty()) {
+    if (!dataSheetTables.isEmpty()) {
         int headerRowIndex = -1;
-        for (const QByteArray &dataXml : dataSheetXmls) {
-            TableMap table = parseWorksheetToTable(dataXml, sharedStrings);
+        for (const TableMap &table : std::as_const(dataSheetTables)) {
             if (headerRowIndex < 0) {
                 headerRowIndex = findHeaderRow(table);
                 if (headerRowIndex < 0) {
@@ -1711,6 +1956,11 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
                 if (it.key() == headerRowIndex) continue;
                 processRowIntoMerge(it.value(), &currentMessage);
             }
+            if (!reportProgress(resultOrder.size())) {
+                result.messages = resultOrder;
+                result.clear();
+                return false;
+            }
         }
         result.messages = resultOrder;
     } else {
@@ -1743,6 +1993,10 @@ bool DbcExcelConverter::importFromExcel(const QString &filePath,
             processRowIntoMerge(it.value(), &currentMessage);
         }
         result.messages = resultOrder;
+        if (!reportProgress(resultOrder.size())) {
+            result.clear();
+            return false;
+        }
     }
 
     nodeAccumulator.removeDuplicates();
@@ -5,11 +5,22 @@
 #include <QStringList>
 #include <QList>
 
+#include <functional>
+
 #include "canmessage.h"
 
 class DbcExcelConverter
 {
 public:
+    /** Deflate effort for the exported package. Store skips compression entirely. */
+    enum CompressionLevel
+    {
+        CompressionStore,
+        CompressionFast,
+        CompressionBalanced,
+        CompressionBest
+    };
+
     struct ChangeHistoryEntry
     {
         QString serialNumber;
@@ -40,11 +51,26 @@ public:
                               const QString &documentTitle = QString(),
                               const QList<ChangeHistoryEntry> &changeHistory = QList<ChangeHistoryEntry>(),
                               bool splitByEcu = true,
+                              CompressionLevel compression = CompressionBalanced,
                               QString *error = nullptr);
 
+    /**
+     * Import progress: sheets processed so far, total sheet steps, messages merged so far.
+     * Return false to cancel; the import then fails with an "Import cancelled" error.
+     */
+    using ProgressCallback = std::function<bool(int done, int total, int messagesParsed)>;
+
     static bool importFromExcel(const QString &filePath,
                                 ImportResult &result,
                                 QString *error = nullptr);
+    static bool importFromExcel(const QString &filePath,
+                                ImportResult &result,
+                                const ProgressCallback &progress,
+                                QString *error = nullptr);
+
+    /** "store", "fast", "balanced" or "best" (case-insensitive). */
+    static bool compressionLevelFromString(const QString &name, CompressionLevel *level);
+    static QString compressionLevelName(CompressionLevel level);
 };
 
 #endif // DBCEXCELCONVERTER_H
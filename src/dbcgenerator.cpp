@@ -0,0 +1,201 @@
+#include "dbcgenerator.h"
+#include "canmessage.h"
+#include "cansignal.h"
+#include "dbcwriter.h"
+
+#include <QBitArray>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QVector>
+
+namespace {
+
+const char *const kWords[] = {
+    "status", "request", "torque", "wheel", "speed", "brake", "steering", "angle", "lamp", "door",
+    "battery", "voltage", "current", "temperature", "sensor", "fault", "counter", "checksum", "mode", "target",
+};
+const int kWordCount = int(sizeof(kWords) / sizeof(kWords[0]));
+
+const char *const kUnits[] = {"", "km/h", "rpm", "V", "A", "degC", "Nm", "deg", "%", "m/s2"};
+const int kUnitCount = int(sizeof(kUnits) / sizeof(kUnits[0]));
+
+const double kFactors[] = {1.0, 0.5, 0.1, 0.01, 0.001};
+const double kOffsets[] = {0.0, 0.0, -40.0, -100.0};
+const int kCycleTimes[] = {10, 20, 50, 100, 200, 500, 1000};
+
+/** Every pseudo-random draw goes through QRandomGenerator so the output is identical across platforms. */
+bool chance(QRandomGenerator &rng, double ratio)
+{
+    return ratio > 0.0 && rng.generateDouble() < ratio;
+}
+
+QString words(QRandomGenerator &rng, int length)
+{
+    QString text;
+    text.reserve(length + 16);
+    while (text.size() < length) {
+        if (!text.isEmpty()) {
+            text += QLatin1Char(' ');
+        }
+        text += QLatin1String(kWords[rng.bounded(kWordCount)]);
+    }
+    text.truncate(length);
+    return text;
+}
+
+/**
+ * Marks the bits of a signal (same walk as the validator's overlap check: Intel grows upward
+ * from the LSB, Motorola walks down from the MSB and wraps to bit 7 of the next byte).
+ * Returns false, leaving used untouched, when a bit is outside the frame or already taken.
+ */
+bool placeSignal(QBitArray &used, int startBit, int length, bool motorola)
+{
+    QVector<int> bits;
+    bits.reserve(length);
+    int bit = startBit;
+    for (int k = 0; k < length; ++k) {
+        if (bit < 0 || bit >= used.size() || used.testBit(bit)) {
+            return false;
+        }
+        bits.append(bit);
+        if (!motorola) {
+            ++bit;
+        } else if (bit % 8 == 0) {
+            bit += 15;
+        } else {
+            --bit;
+        }
+    }
+    for (int b : bits) {
+        used.setBit(b);
+    }
+    return true;
+}
+
+/** First-fit from cursor; returns the start bit or -1 when the frame has no room left. */
+int findPlacement(QBitArray &used, int cursor, int length, bool motorola)
+{
+    for (int start = cursor; start < used.size(); ++start) {
+        if (placeSignal(used, start, length, motorola)) {
+            return start;
+        }
+    }
+    return -1;
+}
+
+CanSignal *makeSignal(QRandomGenerator &rng, const DbcGenerator::Options &options, const QStringList &nodes,
+                      int messageIndex, int signalIndex, int length)
+{
+    CanSignal *signal = new CanSignal();
+    signal->setName(QString("SynSig_%1_%2").arg(messageIndex, 4, 10, QLatin1Char('0')).arg(signalIndex, 2, 10, QLatin1Char('0')));
+    signal->setLength(length);
+
+    const bool isSigned = length > 1 && chance(rng, 0.3);
+    const double factor = kFactors[rng.bounded(int(sizeof(kFactors) / sizeof(kFactors[0])))];
+    const double offset = kOffsets[rng.bounded(int(sizeof(kOffsets) / sizeof(kOffsets[0])))];
+    double rawMin = 0.0;
+    double rawMax = double((quint64(1) << length) - 1);
+    if (isSigned) {
+        rawMin = -double(quint64(1) << (length - 1));
+        rawMax = double((quint64(1) << (length - 1)) - 1);
+    }
+    signal->setSigned(isSigned);
+    signal->setFactor(factor);
+    signal->setOffset(offset);
+    signal->setMin(rawMin * factor + offset);
+    signal->setMax(rawMax * factor + offset);
+    signal->setInitialValue(0.0);
+    signal->setUnit(QLatin1String(kUnits[rng.bounded(kUnitCount)]));
+    signal->setReceivers(QStringList(nodes.at(rng.bounded(nodes.size()))));
+    signal->setSendType(QStringLiteral("Cycle"));
+    if (options.commentLength > 0) {
+        signal->setDescription(words(rng, options.commentLength));
+    }
+
+    if (length <= 16 && chance(rng, options.valueTableRatio)) {
+        const int entries = int(qMin<quint64>(quint64(qMax(1, options.valueTableEntries)), quint64(1) << length));
+        QMap<int, QString> table;
+        for (int v = 0; v < entries; ++v) {
+            table.insert(v, QString("State_%1_%2").arg(v).arg(QLatin1String(kWords[rng.bounded(kWordCount)])));
+        }
+        signal->setValueTable(std::move(table));
+    }
+    return signal;
+}
+
+} // namespace
+
+void DbcGenerator::generate(const Options &options, DbcExcelConverter::ImportResult &result)
+{
+    result.clear();
+    result.version = QStringLiteral("1.0");
+    result.busType = QStringLiteral("CAN FD");
+    result.documentTitle = QString("Synthetic_seed%1").arg(options.seed);
+    result.changeHistory.clear();
+    result.nodes.clear();
+    for (int n = 0; n < qMax(1, options.nodeCount); ++n) {
+        result.nodes.append(QString("ECU_%1").arg(n + 1, 2, 10, QLatin1Char('0')));
+    }
+
+    QRandomGenerator rng(options.seed);
+    const int frameBytes = qBound(8, options.frameBytes, 64);
+    const int frameBits = frameBytes * 8;
+    const int signalsPerMessage = qMax(0, options.signalsPerMessage);
+    // Keep the average length such that the requested signal count fits into the frame.
+    const int maxLength = qBound(1, signalsPerMessage > 0 ? frameBits / signalsPerMessage : 32, 32);
+
+    result.messages.reserve(options.messageCount);
+    for (int i = 0; i < options.messageCount; ++i) {
+        CanMessage *message = new CanMessage();
+        const bool extended = i >= 0x600;
+        message->setId(extended ? (0x80000000u | (0x18000000u + quint32(i))) : 0x100u + quint32(i));
+        message->setName(QString("SynMsg_%1").arg(i, 4, 10, QLatin1Char('0')));
+        message->setLength(frameBytes);
+        message->setTransmitter(result.nodes.at(rng.bounded(result.nodes.size())));
+        message->setReceivers(QStringList(result.nodes.at(rng.bounded(result.nodes.size()))));
+        message->setCycleTime(kCycleTimes[rng.bounded(int(sizeof(kCycleTimes) / sizeof(kCycleTimes[0])))]);
+        message->setSendType(QStringLiteral("Cycle"));
+        message->setFrameFormat(extended ? QStringLiteral("ExtendedCAN_FD") : QStringLiteral("StandardCAN_FD"));
+        message->setMessageType(extended ? QStringLiteral("CANFD Extended") : QStringLiteral("CANFD Standard"));
+        if (options.commentLength > 0) {
+            message->setComment(words(rng, options.commentLength));
+        }
+
+        QBitArray used(frameBits);
+        int cursor = 0;
+        for (int s = 0; s < signalsPerMessage; ++s) {
+            int length = 1 + rng.bounded(maxLength);
+            const bool motorola = chance(rng, options.motorolaRatio);
+            int start = findPlacement(used, cursor, length, motorola);
+            if (start < 0) {
+                length = 1;
+                start = findPlacement(used, 0, length, motorola);
+            }
+            if (start < 0) {
+                break; // frame is full
+            }
+            while (cursor < frameBits && used.testBit(cursor)) {
+                ++cursor;
+            }
+            CanSignal *signal = makeSignal(rng, options, result.nodes, i, s, length);
+            signal->setStartBit(start);
+            signal->setByteOrder(motorola ? 0 : 1);
+            message->addSignal(signal);
+        }
+        result.messages.append(message);
+    }
+}
+
+bool DbcGenerator::writeDbc(const QString &filePath, const DbcExcelConverter::ImportResult &database, QString *error)
+{
+    return DbcWriter::write(filePath, database.version, database.busType, database.nodes, database.messages,
+                            QString(), database.documentTitle, database.changeHistory,
+                            DbcWriter::GlobalValueTables(), AttributeStore(), error);
+}
+
+bool DbcGenerator::writeXlsx(const QString &filePath, const DbcExcelConverter::ImportResult &database, QString *error)
+{
+    return DbcExcelConverter::exportToExcel(filePath, database.version, database.busType, database.nodes,
+                                            database.messages, database.documentTitle, database.changeHistory,
+                                            true, DbcExcelConverter::CompressionBalanced, error);
+}
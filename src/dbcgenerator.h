@@ -0,0 +1,39 @@
+#ifndef DBCGENERATOR_H
+#define DBCGENERATOR_H
+
+#include <QString>
+
+#include "dbcexcelconverter.h"
+
+/**
+ * Deterministic synthetic databases for scale testing. The same Options (including seed)
+ * always produce the same messages, so load/validate/export curves can be reproduced.
+ * Generated layouts are CAN FD frames with non-overlapping Intel/Motorola signals and
+ * physical ranges that pass validateMessages().
+ */
+class DbcGenerator
+{
+public:
+    struct Options
+    {
+        quint32 seed = 1;
+        int messageCount = 1000;
+        int signalsPerMessage = 40;
+        int frameBytes = 64;           // 8..64; signals are packed into frameBytes * 8 bits
+        double motorolaRatio = 0.5;    // fraction of signals with @0 (Motorola) byte order
+        double valueTableRatio = 0.2;  // fraction of signals carrying a value table
+        int valueTableEntries = 4;
+        int commentLength = 32;        // characters per message/signal comment (0 = none)
+        int nodeCount = 8;
+    };
+
+    /** Fills result (cleared first) with the generated database; result owns the messages. */
+    static void generate(const Options &options, DbcExcelConverter::ImportResult &result);
+
+    static bool writeDbc(const QString &filePath, const DbcExcelConverter::ImportResult &database,
+                         QString *error = nullptr);
+    static bool writeXlsx(const QString &filePath, const DbcExcelConverter::ImportResult &database,
+                          QString *error = nullptr);
+};
+
+#endif // DBCGENERATOR_H
@@ -0,0 +1,114 @@
+#include "dbcloader.h"
+
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#include "dbcexcelconverter.h"
+#include "dbcparser.h"
+
+DbcLoader::DbcLoader(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &DbcLoader::finished);
+}
+
+DbcLoader::~DbcLoader()
+{
+    if (m_watcher.isRunning()) {
+        cancel();
+        m_watcher.waitForFinished();
+    }
+    if (m_watcher.future().resultCount() > 0) {
+        delete m_watcher.result().parser;
+    }
+}
+
+bool DbcLoader::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void DbcLoader::start(const QString &filePath)
+{
+    if (m_watcher.isRunning()) {
+        return;
+    }
+    m_filePath = filePath;
+    m_cancel = std::make_shared<std::atomic_bool>(false);
+    const std::shared_ptr<std::atomic_bool> cancelFlag = m_cancel;
+    m_watcher.setFuture(QtConcurrent::run([filePath, cancelFlag, this]() {
+        return load(filePath, cancelFlag, this);
+    }));
+}
+
+void DbcLoader::cancel()
+{
+    if (m_cancel) {
+        m_cancel->store(true);
+    }
+}
+
+DbcLoader::Result DbcLoader::takeResult()
+{
+    if (m_watcher.isRunning() || m_watcher.future().resultCount() == 0) {
+        return Result();
+    }
+    const Result result = m_watcher.result();
+    // The watcher keeps its copy; drop it so the parser has a single owner.
+    m_watcher.setFuture(QFuture<Result>());
+    return result;
+}
+
+DbcLoader::Result DbcLoader::load(const QString &filePath, const std::shared_ptr<std::atomic_bool> &cancelFlag,
+                                  DbcLoader *loader)
+{
+    Result result;
+    auto *parser = new DbcParser();
+    int lastPercent = -1;
+    auto report = [&](int percent, const QString &text) -> bool {
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit loader->progressChanged(percent, text);
+        }
+        return !cancelFlag->load();
+    };
+
+    bool ok;
+    if (filePath.endsWith(QStringLiteral(".xlsx"), Qt::CaseInsensitive)) {
+        DbcExcelConverter::ImportResult importResult;
+        ok = DbcExcelConverter::importFromExcel(filePath, importResult,
+            [&](int done, int total, int messagesParsed) {
+                const int percent = total > 0 ? done * 100 / total : 0;
+                return report(percent, QObject::tr("Sheet %1/%2, %3 messages").arg(done).arg(total).arg(messagesParsed));
+            },
+            &result.error);
+        if (ok) {
+            parser->loadFromExcelImport(importResult);
+        }
+    } else {
+        ok = parser->parseFile(filePath, [&](qint64 bytesRead, qint64 totalBytes, int messagesParsed) {
+            const int percent = totalBytes > 0 ? static_cast<int>(qMin<qint64>(bytesRead, totalBytes) * 100 / totalBytes) : 0;
+            return report(percent, QObject::tr("%1 / %2 KB, %3 messages")
+                .arg(bytesRead / 1024).arg(totalBytes / 1024).arg(messagesParsed));
+        });
+        if (!ok && result.error.isEmpty()) {
+            result.error = QObject::tr("Failed to parse DBC file %1").arg(QFileInfo(filePath).fileName());
+        }
+    }
+
+    if (cancelFlag->load()) {
+        delete parser;
+        result.cancelled = true;
+        result.error.clear();
+        return result;
+    }
+    if (!ok) {
+        delete parser;
+        return result;
+    }
+
+    report(100, QObject::tr("Validating %1 messages").arg(parser->getMessages().size()));
+    result.validation = validateMessages(parser->getMessages());
+    result.parser = parser;
+    return result;
+}
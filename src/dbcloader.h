@@ -0,0 +1,58 @@
+#ifndef DBCLOADER_H
+#define DBCLOADER_H
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+#include "dbcvalidator.h"
+
+class DbcParser;
+
+/**
+ * Loads a .dbc or .xlsx file into a fresh DbcParser on the global thread pool and
+ * validates it there. The GUI keeps its current database until finished() and then
+ * swaps the loaded one in, so a failed or cancelled load leaves it untouched.
+ */
+class DbcLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        DbcParser *parser = nullptr; // owned by whoever calls takeResult()
+        ValidationResult validation;
+        QString error;
+        bool cancelled = false;
+    };
+
+    explicit DbcLoader(QObject *parent = nullptr);
+    /** Cancels and waits for a running load. */
+    ~DbcLoader() override;
+
+    bool isRunning() const;
+    QString filePath() const { return m_filePath; }
+    void start(const QString &filePath);
+    /** Asks the worker to stop at its next progress check. */
+    void cancel();
+    Result takeResult();
+
+signals:
+    /** Emitted from the worker thread; connect with the default (queued) connection. */
+    void progressChanged(int percent, const QString &text);
+    void finished();
+
+private:
+    static Result load(const QString &filePath, const std::shared_ptr<std::atomic_bool> &cancelFlag,
+                       DbcLoader *loader);
+
+    QFutureWatcher<Result> m_watcher;
+    std::shared_ptr<std::atomic_bool> m_cancel;
+    QString m_filePath;
+};
+
+#endif // DBCLOADER_H
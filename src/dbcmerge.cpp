@@ -0,0 +1,613 @@
+#include "dbcmerge.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+
+QString toText(const QString &value) { return value; }
+QString toText(int value) { return QString::number(value); }
+QString toText(double value) { return QString::number(value, 'g', 15); }
+QString toText(bool value) { return value ? QStringLiteral("Yes") : QStringLiteral("No"); }
+QString toText(const QStringList &value) { return value.join(QStringLiteral(", ")); }
+QString toText(const AttributeValue &value) { return value.toString(); }
+
+/** Attribute stores of the three inputs and of the result, for resolving values against defaults. */
+struct AttributeSides
+{
+    const AttributeStore *base;
+    const AttributeStore *ours;
+    const AttributeStore *theirs;
+    const AttributeStore *merged;
+};
+
+/** Where conflicts found while merging one message/signal are recorded. */
+struct MergeContext
+{
+    MergeResult *result;
+    const AttributeSides *attributes = nullptr;
+    quint32 messageId = 0;
+    QString messageName;
+    QString signalName;
+
+    void conflict(MergeConflict::Kind kind, const QString &field,
+                  const QString &base, const QString &ours, const QString &theirs) const
+    {
+        MergeConflict c;
+        c.kind = kind;
+        c.messageId = messageId;
+        c.messageName = messageName;
+        c.signalName = signalName;
+        c.field = field;
+        c.base = base;
+        c.ours = ours;
+        c.theirs = theirs;
+        result->conflicts.append(c);
+    }
+};
+
+/**
+ * Three-way rule: equal sides or an unchanged theirs keep ours, an unchanged ours takes
+ * theirs, anything else is a conflict that keeps ours. Returns a reference to ours or theirs.
+ */
+template <typename Value>
+const Value &mergeValue(const MergeContext &context, const QString &field,
+                        const Value &base, const Value &ours, const Value &theirs)
+{
+    if (ours == theirs || theirs == base) {
+        return ours;
+    }
+    if (ours == base) {
+        ++context.result->autoMerged;
+        return theirs;
+    }
+    context.conflict(MergeConflict::FieldConflict, field, toText(base), toText(ours), toText(theirs));
+    return ours;
+}
+
+/** mergeValue() on one field; merged starts as a copy of ours. */
+template <typename Object, typename Value, typename Arg>
+void mergeField(const MergeContext &context, const QString &field,
+                Value (Object::*getter)() const, void (Object::*setter)(Arg),
+                const Object &base, const Object &ours, const Object &theirs, Object &merged)
+{
+    const auto &o = (ours.*getter)();
+    const auto &t = (theirs.*getter)();
+    if (&mergeValue(context, field, (base.*getter)(), o, t) == &t) {
+        (merged.*setter)(t);
+    }
+}
+
+/**
+ * Per-attribute merge of the values set on one object. Each side is resolved against its own
+ * defaults, so a changed default is not taken for an edit, and the result is stored relative
+ * to the merged defaults. Values of definitions the merge dropped are dropped too.
+ */
+AttributeValues mergeAttributeValues(const MergeContext &context, const AttributeValues &base,
+                                     const AttributeValues &ours, const AttributeValues &theirs)
+{
+    QVector<int> ids;
+    ids.reserve(base.size() + ours.size() + theirs.size());
+    for (const AttributeValues *values : {&base, &ours, &theirs}) {
+        for (const AttributeValues::Entry &entry : *values) {
+            ids.append(entry.id);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    const AttributeSides &sides = *context.attributes;
+    AttributeValues merged;
+    for (int id : ids) {
+        if (!sides.merged->contains(id)) {
+            continue;
+        }
+        const AttributeValue o = sides.ours->value(id, ours);
+        const AttributeValue t = sides.theirs->value(id, theirs);
+        const AttributeValue &value = mergeValue(context, QString("Attribute %1").arg(AttributeStore::nameOf(id)),
+                                                 sides.base->value(id, base), o, t);
+        sides.merged->setValue(&merged, id, value);
+    }
+    return merged;
+}
+
+/**
+ * Three-way merge of attribute definitions (declaration and default separately) and network
+ * and node values, keyed by attribute ID. merged starts as a copy of ours.
+ */
+void mergeAttributes(MergeContext context, AttributeStore *merged)
+{
+    const AttributeStore &base = *context.attributes->base;
+    const AttributeStore &ours = *context.attributes->ours;
+    const AttributeStore &theirs = *context.attributes->theirs;
+
+    // Ours order, then definitions only theirs has; base-only ones were deleted on both sides
+    QVector<int> ids;
+    ids.reserve(ours.definitions().size() + theirs.definitions().size());
+    for (const AttributeStore::Definition &definition : ours.definitions()) {
+        ids.append(definition.id);
+    }
+    for (const AttributeStore::Definition &definition : theirs.definitions()) {
+        if (!ours.contains(definition.id)) {
+            ids.append(definition.id);
+        }
+    }
+    for (int id : ids) {
+        if (AttributeStore::isModelAttribute(id)) {
+            continue; // the writer regenerates these; their values are merged as model fields
+        }
+        const AttributeStore::Definition *b = base.definition(id);
+        const AttributeStore::Definition *o = ours.definition(id);
+        const AttributeStore::Definition *t = theirs.definition(id);
+        const QString name = AttributeStore::nameOf(id);
+        const QString oText = o ? ours.formatDefinition(*o) : QString();
+        const QString tText = t ? theirs.formatDefinition(*t) : QString();
+        if (&mergeValue(context, QString("Attribute Definition %1").arg(name),
+                        b ? base.formatDefinition(*b) : QString(), oText, tText) == &tText) {
+            if (!t) {
+                merged->removeDefinition(id);
+                continue;
+            }
+            AttributeStore::Definition definition = *t;
+            if (const AttributeStore::Definition *current = merged->definition(id)) {
+                // The default is merged on its own below
+                definition.hasDefault = current->hasDefault;
+                definition.defaultValue = current->defaultValue;
+            }
+            merged->define(definition);
+        }
+        if (!o || !t || !merged->contains(id)) {
+            continue; // added or deleted as a whole, its default came with it
+        }
+        const QString field = QString("Attribute Default %1").arg(name);
+        const AttributeValue od = ours.value(id, AttributeValues());
+        const AttributeValue td = theirs.value(id, AttributeValues());
+        if (!b) {
+            // Added on both sides
+            if (od != td) {
+                context.conflict(MergeConflict::FieldConflict, field, QString(), toText(od), toText(td));
+            }
+        } else if (&mergeValue(context, field, base.value(id, AttributeValues()), od, td) == &td) {
+            merged->setDefault(id, td);
+        }
+    }
+
+    merged->setNetworkValues(mergeAttributeValues(context, base.networkValues(), ours.networkValues(),
+                                                  theirs.networkValues()));
+    QSet<QString> nodes;
+    for (const AttributeStore *store : {&base, &ours, &theirs}) {
+        for (auto it = store->nodeValues().constBegin(); it != store->nodeValues().constEnd(); ++it) {
+            nodes.insert(it.key());
+        }
+    }
+    for (const QString &node : nodes) {
+        context.signalName = QString("Node %1").arg(node);
+        merged->setNodeValues(node, mergeAttributeValues(context, base.nodeValues().value(node),
+                                                         ours.nodeValues().value(node),
+                                                         theirs.nodeValues().value(node)));
+    }
+}
+
+QMap<int, QString> mergeValueTable(const MergeContext &context, const QMap<int, QString> &base,
+                                   const QMap<int, QString> &ours, const QMap<int, QString> &theirs)
+{
+    if (ours == theirs || theirs == base) {
+        return ours;
+    }
+    if (ours == base) {
+        ++context.result->autoMerged;
+        return theirs;
+    }
+    QVector<int> keys;
+    keys.reserve(base.size() + ours.size() + theirs.size());
+    for (const QMap<int, QString> *map : {&base, &ours, &theirs}) {
+        for (auto it = map->constBegin(); it != map->constEnd(); ++it) {
+            keys.append(it.key());
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    QMap<int, QString> merged = ours;
+    for (int key : keys) {
+        const bool inBase = base.contains(key);
+        const bool inOurs = ours.contains(key);
+        const bool inTheirs = theirs.contains(key);
+        const QString b = base.value(key);
+        const QString o = ours.value(key);
+        const QString t = theirs.value(key);
+        if ((inOurs == inTheirs && o == t) || (inTheirs == inBase && t == b)) {
+            continue;
+        }
+        if (inOurs == inBase && o == b) {
+            if (inTheirs) {
+                merged.insert(key, t);
+            } else {
+                merged.remove(key);
+            }
+            ++context.result->autoMerged;
+            continue;
+        }
+        context.conflict(MergeConflict::FieldConflict, QString("Value %1").arg(key),
+                         inBase ? b : QString(), inOurs ? o : QString(), inTheirs ? t : QString());
+    }
+    return merged;
+}
+
+/** Set-style merge of name lists: additions and removals from both sides are applied. */
+QStringList mergeNameList(const QStringList &base, const QStringList &ours, const QStringList &theirs, int *autoMerged)
+{
+    if (ours == theirs || theirs == base) {
+        return ours;
+    }
+    if (ours == base) {
+        ++*autoMerged;
+        return theirs;
+    }
+    QSet<QString> baseSet;
+    QSet<QString> theirSet;
+    for (const QString &name : base) {
+        baseSet.insert(name);
+    }
+    for (const QString &name : theirs) {
+        theirSet.insert(name);
+    }
+    QStringList merged;
+    for (const QString &name : ours) {
+        // Keep unless theirs removed it.
+        if (!baseSet.contains(name) || theirSet.contains(name)) {
+            merged.append(name);
+        }
+    }
+    for (const QString &name : theirs) {
+        if (!baseSet.contains(name) && !merged.contains(name)) {
+            merged.append(name);
+        }
+    }
+    ++*autoMerged;
+    return merged;
+}
+
+CanSignal mergeSignal(const MergeContext &context, const CanSignal &base, const CanSignal &ours, const CanSignal &theirs)
+{
+    if (ours == theirs || theirs == base) {
+        return ours;
+    }
+    if (ours == base) {
+        ++context.result->autoMerged;
+        return theirs;
+    }
+    CanSignal merged = ours;
+    mergeField(context, "Start Bit", &CanSignal::getStartBit, &CanSignal::setStartBit, base, ours, theirs, merged);
+    mergeField(context, "Length", &CanSignal::getLength, &CanSignal::setLength, base, ours, theirs, merged);
+    mergeField(context, "Byte Order", &CanSignal::getByteOrder, &CanSignal::setByteOrder, base, ours, theirs, merged);
+    mergeField(context, "Signed", &CanSignal::isSigned, &CanSignal::setSigned, base, ours, theirs, merged);
+    mergeField(context, "Factor", &CanSignal::getFactor, &CanSignal::setFactor, base, ours, theirs, merged);
+    mergeField(context, "Offset", &CanSignal::getOffset, &CanSignal::setOffset, base, ours, theirs, merged);
+    mergeField(context, "Min", &CanSignal::getMin, &CanSignal::setMin, base, ours, theirs, merged);
+    mergeField(context, "Max", &CanSignal::getMax, &CanSignal::setMax, base, ours, theirs, merged);
+    mergeField(context, "Unit", &CanSignal::getUnit, &CanSignal::setUnit, base, ours, theirs, merged);
+    mergeField(context, "Description", &CanSignal::getDescription, &CanSignal::setDescription, base, ours, theirs, merged);
+    mergeField(context, "Send Type", &CanSignal::getSendType, &CanSignal::setSendType, base, ours, theirs, merged);
+    mergeField(context, "Initial Value", &CanSignal::getInitialValue, &CanSignal::setInitialValue, base, ours, theirs, merged);
+    mergeField(context, "Invalid Value", &CanSignal::getInvalidValueHex, &CanSignal::setInvalidValueHex, base, ours, theirs, merged);
+    mergeField(context, "Inactive Value", &CanSignal::getInactiveValueHex, &CanSignal::setInactiveValueHex, base, ours, theirs, merged);
+    merged.setAttributes(mergeAttributeValues(context, base.getAttributes(), ours.getAttributes(), theirs.getAttributes()));
+    merged.setReceivers(mergeNameList(base.getReceivers(), ours.getReceivers(), theirs.getReceivers(),
+                                      &context.result->autoMerged));
+    merged.setValueTable(mergeValueTable(context, base.getValueTable(), ours.getValueTable(), theirs.getValueTable()));
+
+    auto rawRange = [](const CanSignal &s) {
+        return s.hasRawRange() ? QString("%1..%2").arg(toText(s.getRawMin()), toText(s.getRawMax())) : QString();
+    };
+    const QString b = rawRange(base);
+    const QString o = rawRange(ours);
+    const QString t = rawRange(theirs);
+    if (o != t && t != b) {
+        if (o == b) {
+            if (theirs.hasRawRange()) {
+                merged.setRawRange(theirs.getRawMin(), theirs.getRawMax());
+            } else {
+                merged.clearRawRange();
+            }
+            ++context.result->autoMerged;
+        } else {
+            context.conflict(MergeConflict::FieldConflict, "Raw Range", b, o, t);
+        }
+    }
+    return merged;
+}
+
+CanMessage mergeMessageFields(const MergeContext &context, const CanMessage &base,
+                              const CanMessage &ours, const CanMessage &theirs)
+{
+    if (ours.hasSameFields(theirs) || theirs.hasSameFields(base)) {
+        return ours;
+    }
+    if (ours.hasSameFields(base)) {
+        ++context.result->autoMerged;
+        return theirs;
+    }
+    CanMessage merged = ours.fieldsOnly();
+    mergeField(context, "Name", &CanMessage::getName, &CanMessage::setName, base, ours, theirs, merged);
+    mergeField(context, "Length", &CanMessage::getLength, &CanMessage::setLength, base, ours, theirs, merged);
+    mergeField(context, "Transmitter", &CanMessage::getTransmitter, &CanMessage::setTransmitter, base, ours, theirs, merged);
+    mergeField(context, "Cycle Time", &CanMessage::getCycleTime, &CanMessage::setCycleTime, base, ours, theirs, merged);
+    mergeField(context, "Frame Format", &CanMessage::getFrameFormat, &CanMessage::setFrameFormat, base, ours, theirs, merged);
+    mergeField(context, "Send Type", &CanMessage::getSendType, &CanMessage::setSendType, base, ours, theirs, merged);
+    mergeField(context, "Cycle Time Fast", &CanMessage::getCycleTimeFast, &CanMessage::setCycleTimeFast, base, ours, theirs, merged);
+    mergeField(context, "Nr Of Repetitions", &CanMessage::getNrOfRepetitions, &CanMessage::setNrOfRepetitions, base, ours, theirs, merged);
+    mergeField(context, "Delay Time", &CanMessage::getDelayTime, &CanMessage::setDelayTime, base, ours, theirs, merged);
+    mergeField(context, "Comment", &CanMessage::getComment, &CanMessage::setComment, base, ours, theirs, merged);
+    mergeField(context, "Message Type", &CanMessage::getMessageType, &CanMessage::setMessageType, base, ours, theirs, merged);
+    merged.setAttributes(mergeAttributeValues(context, base.getAttributes(), ours.getAttributes(), theirs.getAttributes()));
+    merged.setReceivers(mergeNameList(base.getReceivers(), ours.getReceivers(), theirs.getReceivers(),
+                                      &context.result->autoMerged));
+    return merged;
+}
+
+/** Name -> first index; later duplicate names are never matched. */
+QHash<QString, int> indexByName(const QVector<CanSignal> &list)
+{
+    QHash<QString, int> index;
+    index.reserve(list.size());
+    for (int i = list.size() - 1; i >= 0; --i) {
+        index.insert(list.at(i).getName(), i);
+    }
+    return index;
+}
+
+QVector<CanSignal> mergeSignalLists(MergeContext context, const QVector<CanSignal> &base,
+                                    const QVector<CanSignal> &ours, const QVector<CanSignal> &theirs)
+{
+    const QHash<QString, int> baseIndex = indexByName(base);
+    const QHash<QString, int> oursIndex = indexByName(ours);
+    const QHash<QString, int> theirIndex = indexByName(theirs);
+
+    QVector<CanSignal> merged;
+    merged.reserve(qMax(ours.size(), theirs.size()));
+    for (int i = 0; i < ours.size(); ++i) {
+        const CanSignal &o = ours.at(i);
+        context.signalName = o.getName();
+        const int b = oursIndex.value(o.getName()) == i ? baseIndex.value(o.getName(), -1) : -1;
+        const int t = oursIndex.value(o.getName()) == i ? theirIndex.value(o.getName(), -1) : -1;
+        if (b >= 0 && t >= 0) {
+            merged.append(mergeSignal(context, base.at(b), o, theirs.at(t)));
+        } else if (b >= 0) {
+            // Deleted by theirs: drop unless ours changed it.
+            if (o != base.at(b)) {
+                context.conflict(MergeConflict::ModifyDelete, "Signal", QString(), "modified", "deleted");
+                merged.append(o);
+            } else {
+                ++context.result->autoMerged;
+            }
+        } else if (t >= 0) {
+            // Added on both sides: merge against an empty signal.
+            CanSignal empty;
+            empty.setName(o.getName());
+            merged.append(mergeSignal(context, empty, o, theirs.at(t)));
+        } else {
+            merged.append(o);
+        }
+    }
+    for (int i = 0; i < theirs.size(); ++i) {
+        const CanSignal &t = theirs.at(i);
+        if (oursIndex.contains(t.getName())) {
+            continue;
+        }
+        context.signalName = t.getName();
+        const int b = theirIndex.value(t.getName()) == i ? baseIndex.value(t.getName(), -1) : -1;
+        if (b >= 0) {
+            // Deleted by ours: drop unless theirs changed it.
+            if (t != base.at(b)) {
+                context.conflict(MergeConflict::ModifyDelete, "Signal", QString(), "deleted", "modified");
+                merged.append(t);
+            }
+        } else {
+            merged.append(t);
+            ++context.result->autoMerged;
+        }
+    }
+    return merged;
+}
+
+MessageSnapshot mergeMessage(MergeContext context, const MessageSnapshot &base,
+                             const MessageSnapshot &ours, const MessageSnapshot &theirs)
+{
+    if (ours == theirs || theirs == base) {
+        return ours;
+    }
+    if (ours == base) {
+        ++context.result->autoMerged;
+        return theirs;
+    }
+    MessageSnapshot merged;
+    merged.setMessage(mergeMessageFields(context, base.message(), ours.message(), theirs.message()));
+    merged.setSignalList(mergeSignalLists(context, base.signalList(), ours.signalList(), theirs.signalList()));
+    return merged;
+}
+
+QHash<quint32, int> indexById(const QVector<MessageSnapshot> &messages)
+{
+    QHash<quint32, int> index;
+    index.reserve(messages.size());
+    for (int i = messages.size() - 1; i >= 0; --i) {
+        index.insert(messages.at(i).message().getId(), i);
+    }
+    return index;
+}
+
+void mergeScalar(MergeResult &result, const QString &field, const QString &base, const QString &ours,
+                 const QString &theirs, QString *merged)
+{
+    *merged = ours;
+    if (ours == theirs || theirs == base) {
+        return;
+    }
+    if (ours == base) {
+        *merged = theirs;
+        ++result.autoMerged;
+        return;
+    }
+    MergeContext context{&result};
+    context.conflict(MergeConflict::FieldConflict, field, base, ours, theirs);
+}
+
+} // namespace
+
+QString MergeConflict::description() const
+{
+    QString where = messageName.isEmpty() ? QStringLiteral("Database")
+                                          : QString("0x%1 %2").arg(QString::number(messageId, 16).toUpper(), messageName);
+    if (!signalName.isEmpty()) {
+        where += QString(" / %1").arg(signalName);
+    }
+    if (kind == ModifyDelete) {
+        return QString("%1: %2 %3 in ours, %4 in theirs").arg(where, field.toLower(), ours, theirs);
+    }
+    return QString("%1: %2: base \"%3\", ours \"%4\", theirs \"%5\"").arg(where, field, base, ours, theirs);
+}
+
+MergeResult DbcMerger::merge(const DbcSnapshot &base, const DbcSnapshot &ours, const DbcSnapshot &theirs)
+{
+    MergeResult result;
+    DbcSnapshot &merged = result.merged;
+    mergeScalar(result, "Version", base.version, ours.version, theirs.version, &merged.version);
+    mergeScalar(result, "Bus Type", base.busType, ours.busType, theirs.busType, &merged.busType);
+    mergeScalar(result, "Document Title", base.documentTitle, ours.documentTitle, theirs.documentTitle,
+                &merged.documentTitle);
+    merged.nodes = mergeNameList(base.nodes, ours.nodes, theirs.nodes, &result.autoMerged);
+    // Attributes first: message and signal values are resolved against the merged defaults
+    merged.attributes = ours.attributes;
+    const AttributeSides sides{&base.attributes, &ours.attributes, &theirs.attributes, &merged.attributes};
+    mergeAttributes(MergeContext{&result, &sides}, &merged.attributes);
+
+    // Change history only grows: keep ours, then append rows theirs added.
+    merged.changeHistory = ours.changeHistory;
+    QSet<QString> knownRows;
+    for (const auto &entry : base.changeHistory + ours.changeHistory) {
+        knownRows.insert(entry.serialNumber + QLatin1Char('\t') + entry.changeContent);
+    }
+    for (const auto &entry : theirs.changeHistory) {
+        if (!knownRows.contains(entry.serialNumber + QLatin1Char('\t') + entry.changeContent)) {
+            merged.changeHistory.append(entry);
+            ++result.autoMerged;
+        }
+    }
+
+    // Global value tables: whole-table three-way merge by name.
+    {
+        QHash<QString, QMap<int, QString>> baseTables;
+        QHash<QString, QMap<int, QString>> theirTables;
+        QSet<QString> ourNames;
+        for (const auto &table : base.globalValueTables) baseTables.insert(table.first, table.second);
+        for (const auto &table : theirs.globalValueTables) theirTables.insert(table.first, table.second);
+        MergeContext context{&result};
+        for (const auto &table : ours.globalValueTables) {
+            ourNames.insert(table.first);
+            const bool inBase = baseTables.contains(table.first);
+            const bool inTheirs = theirTables.contains(table.first);
+            if (inTheirs) {
+                context.signalName = QString("Value Table %1").arg(table.first);
+                merged.globalValueTables.append(qMakePair(table.first,
+                    mergeValueTable(context, baseTables.value(table.first), table.second, theirTables.value(table.first))));
+            } else if (!inBase || table.second != baseTables.value(table.first)) {
+                if (inBase) {
+                    context.conflict(MergeConflict::ModifyDelete, QString("Value Table %1").arg(table.first),
+                                     QString(), "modified", "deleted");
+                }
+                merged.globalValueTables.append(table);
+            }
+        }
+        for (const auto &table : theirs.globalValueTables) {
+            if (ourNames.contains(table.first)) {
+                continue;
+            }
+            if (!baseTables.contains(table.first)) {
+                merged.globalValueTables.append(table);
+            } else if (table.second != baseTables.value(table.first)) {
+                context.conflict(MergeConflict::ModifyDelete, QString("Value Table %1").arg(table.first),
+                                 QString(), "deleted", "modified");
+                merged.globalValueTables.append(table);
+            }
+        }
+    }
+
+    const QHash<quint32, int> baseIndex = indexById(base.messages);
+    const QHash<quint32, int> oursIndex = indexById(ours.messages);
+    const QHash<quint32, int> theirIndex = indexById(theirs.messages);
+    merged.messages.reserve(qMax(ours.messages.size(), theirs.messages.size()));
+    for (int i = 0; i < ours.messages.size(); ++i) {
+        const MessageSnapshot &o = ours.messages.at(i);
+        const quint32 id = o.message().getId();
+        MergeContext context{&result, &sides, id, o.message().getName()};
+        const bool first = oursIndex.value(id) == i;
+        const int b = first ? baseIndex.value(id, -1) : -1;
+        const int t = first ? theirIndex.value(id, -1) : -1;
+        if (b >= 0 && t >= 0) {
+            merged.messages.append(mergeMessage(context, base.messages.at(b), o, theirs.messages.at(t)));
+        } else if (b >= 0) {
+            if (o != base.messages.at(b)) {
+                context.conflict(MergeConflict::ModifyDelete, "Message", QString(), "modified", "deleted");
+                merged.messages.append(o);
+            } else {
+                ++result.autoMerged;
+            }
+        } else if (t >= 0) {
+            // Added on both sides with the same ID: merge against an empty message.
+            MessageSnapshot empty;
+            CanMessage emptyMessage;
+            emptyMessage.setId(id);
+            empty.setMessage(emptyMessage);
+            merged.messages.append(mergeMessage(context, empty, o, theirs.messages.at(t)));
+        } else {
+            merged.messages.append(o);
+        }
+    }
+    for (int i = 0; i < theirs.messages.size(); ++i) {
+        const MessageSnapshot &t = theirs.messages.at(i);
+        const quint32 id = t.message().getId();
+        const bool first = theirIndex.value(id) == i;
+        if (oursIndex.contains(id)) {
+            continue;
+        }
+        MergeContext context{&result, &sides, id, t.message().getName()};
+        const int b = first ? baseIndex.value(id, -1) : -1;
+        if (b >= 0) {
+            if (t != base.messages.at(b)) {
+                context.conflict(MergeConflict::ModifyDelete, "Message", QString(), "deleted", "modified");
+                merged.messages.append(t);
+            }
+        } else {
+            merged.messages.append(t);
+            ++result.autoMerged;
+        }
+    }
+    return result;
+}
+
+QJsonArray DbcMerger::conflictsToJson(const QList<MergeConflict> &conflicts)
+{
+    QJsonArray array;
+    for (const MergeConflict &c : conflicts) {
+        QJsonObject object;
+        object.insert("kind", c.kind == MergeConflict::ModifyDelete ? "modify/delete" : "field");
+        if (!c.messageName.isEmpty()) {
+            object.insert("messageId", static_cast<qint64>(c.messageId));
+            object.insert("message", c.messageName);
+        }
+        if (!c.signalName.isEmpty()) {
+            object.insert("signal", c.signalName);
+        }
+        object.insert("field", c.field);
+        object.insert("base", c.base);
+        object.insert("ours", c.ours);
+        object.insert("theirs", c.theirs);
+        array.append(object);
+    }
+    return array;
+}
@@ -0,0 +1,53 @@
+#ifndef DBCMERGE_H
+#define DBCMERGE_H
+
+#include <QJsonArray>
+#include <QList>
+#include <QString>
+
+#include "dbcsnapshot.h"
+
+/** A change both sides made differently; the merged result keeps "ours" (or the modified side). */
+struct MergeConflict
+{
+    enum Kind
+    {
+        FieldConflict,  // both sides changed the same field to different values
+        ModifyDelete,   // one side modified, the other deleted
+    };
+
+    Kind kind = FieldConflict;
+    quint32 messageId = 0;
+    QString messageName;  // empty for database-level conflicts
+    QString signalName;   // empty for message-level conflicts
+    QString field;        // field name; for ModifyDelete, "Message" or "Signal"
+    QString base;
+    QString ours;
+    QString theirs;
+
+    QString description() const;
+};
+
+struct MergeResult
+{
+    DbcSnapshot merged;
+    QList<MergeConflict> conflicts;
+    int autoMerged = 0; // fields/entries taken from theirs without conflict
+
+    bool isClean() const { return conflicts.isEmpty(); }
+};
+
+/**
+ * Three-way merge of parsed databases. Messages are matched by CAN ID and signals by name
+ * (hash lookups); each field, value-table entry, attribute, node and change-history row is
+ * merged independently, so edits to different fields of the same signal never conflict.
+ * Merged order follows ours, with messages/signals only added by theirs appended.
+ */
+class DbcMerger
+{
+public:
+    static MergeResult merge(const DbcSnapshot &base, const DbcSnapshot &ours, const DbcSnapshot &theirs);
+    static QJsonArray conflictsToJson(const QList<MergeConflict> &conflicts);
+};
+
+#endif // DBCMERGE_H
@@ -1,10 +1,13 @@
 #include "dbcparser.h"
 #include "dbcexcelconverter.h"
+#include "trace.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QRegularExpression>
 #include <QRegularExpressionMatchIterator>
+#include <QSet>
 #include <QTextStream>
 
 namespace {
@@ -34,10 +37,52 @@ QString normalizeFrameFormat(const QString &format)
 namespace {
 /** Vector CANdb++ virtual message ID for "independent" (unassigned) signals. Skipped when loading. */
 const quint32 kVectorIndependentSigMsgId = 3221225472U;  // 0xC0000000
+
+/** Report key for lines whose keyword is not a DBC keyword. */
+const QString kUnknownRecord = QStringLiteral("(unknown)");
+
+/** DBC keywords this model does not import; reported as "not imported" instead of unknown. */
+const QSet<QString> kIgnoredKeywords = {
+    QStringLiteral("NS_"), QStringLiteral("NS_DESC_"), QStringLiteral("BS_"), QStringLiteral("BU_SG_REL_"),
+    QStringLiteral("BU_EV_REL_"), QStringLiteral("BU_BO_REL_"),
+    QStringLiteral("BA_DEF_REL_"), QStringLiteral("BA_DEF_DEF_REL_"), QStringLiteral("BA_REL_"),
+    QStringLiteral("BA_DEF_SGTYPE_"), QStringLiteral("BA_SGTYPE_"), QStringLiteral("EV_"),
+    QStringLiteral("ENVVAR_DATA_"), QStringLiteral("SGTYPE_"), QStringLiteral("SGTYPE_VAL_"),
+    QStringLiteral("SIG_GROUP_"), QStringLiteral("SIG_VALTYPE_"), QStringLiteral("SIG_TYPE_REF_"),
+    QStringLiteral("SG_MUL_VAL_"), QStringLiteral("CAT_DEF_"), QStringLiteral("CAT_"), QStringLiteral("FILTER"),
+};
+
+const QSet<QString> kParsedKeywords = {
+    QStringLiteral("VERSION"), QStringLiteral("BU_"), QStringLiteral("BO_TX_BU_"), QStringLiteral("CM_"),
+    QStringLiteral("BA_DEF_"), QStringLiteral("BA_DEF_DEF_"), QStringLiteral("BA_"), QStringLiteral("VAL_TABLE_"), QStringLiteral("VAL_"),
+    QStringLiteral("BO_"), QStringLiteral("SG_"),
+};
+
+/** Leading identifier of a trimmed record line ("BU_:" -> "BU_"). */
+QString recordKeyword(const QString &line)
+{
+    int end = 0;
+    while (end < line.size() && (line.at(end).isLetterOrNumber() || line.at(end) == QLatin1Char('_'))) {
+        ++end;
+    }
+    return line.left(end);
+}
+
+int leadingWhitespace(const QString &line)
+{
+    int count = 0;
+    while (count < line.size() && line.at(count).isSpace()) {
+        ++count;
+    }
+    return count;
+}
 }
 
 DbcParser::DbcParser()
-    : m_skipSignalsForCurrentMessage(false)
+    : m_messageIndexStale(false)
+    , m_skipSignalsForCurrentMessage(false)
+    , m_lineNumber(0)
+    , m_lineColumn(0)
 {
 }
 
@@ -57,18 +102,24 @@ void DbcParser::clear()
     }
     m_messages.clear();
     m_messageMap.clear();
+    m_messageIndex = MessageIndex();
+    m_messageIndexStale = false;
     m_nodes.clear();
     m_version.clear();
     m_busType.clear();
     m_documentTitle.clear();
     m_changeHistory.clear();
-    m_messageAttributeEnums.clear();
-    m_signalAttributeEnums.clear();
+    m_attributes.clear();
     m_globalValueTables.clear();
+    m_report.clear();
+    m_lineNumber = 0;
+    m_lineColumn = 0;
+    m_currentKeyword.clear();
 }
 
-bool DbcParser::parseFile(const QString &filePath)
+bool DbcParser::parseFile(const QString &filePath, const ProgressCallback &progress)
 {
+    DBC_TRACE_SCOPE("DbcParser::parseFile");
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qWarning() << "Failed to open" << filePath;
@@ -77,13 +128,46 @@ bool DbcParser::parseFile(const QString &filePath)
 
     clear();
 
+    const qint64 totalBytes = file.size();
+    m_report.filePath = filePath;
+    m_report.bytes = totalBytes;
+    QElapsedTimer timer;
+    timer.start();
+    qint64 recordStartNs = 0;
+    bool inNamespaceBlock = false;
     QTextStream in(&file);
     QString line;
     while (in.readLineInto(&line)) {
-        if (!parseLine(line.trimmed())) {
-            qWarning() << "Failed to parse line:" << line;
+        ++m_lineNumber;
+        const QString trimmed = line.trimmed();
+        // NS_ 块内缩进列出的只是关键字名，不是记录
+        const bool namespaceEntry = inNamespaceBlock && !trimmed.isEmpty() && line.at(0).isSpace();
+        inNamespaceBlock = namespaceEntry || (inNamespaceBlock && trimmed.isEmpty());
+        if (!trimmed.isEmpty() && !trimmed.startsWith(QLatin1String("//")) && !namespaceEntry) {
+            m_currentKeyword = recordKeyword(trimmed);
+            m_lineColumn = leadingWhitespace(line) + 1;
+            if (!parseLine(trimmed)) {
+                reportIssue(ParseReport::Malformed, QStringLiteral("%1 record does not match the expected syntax")
+                                                        .arg(m_currentKeyword), trimmed);
+            }
+            inNamespaceBlock = m_currentKeyword == QLatin1String("NS_");
+
+            const qint64 nowNs = timer.nsecsElapsed();
+            ParseReport::RecordStats &stats = m_report.records[kParsedKeywords.contains(m_currentKeyword)
+                                                                   || kIgnoredKeywords.contains(m_currentKeyword)
+                                                               ? m_currentKeyword : kUnknownRecord];
+            ++stats.count;
+            stats.nanoseconds += nowNs - recordStartNs;
+            recordStartNs = nowNs;
+        }
+        // file.pos() runs ahead of the stream by its read buffer; close enough for progress.
+        if (progress && (m_lineNumber & 0x3ff) == 0
+            && !progress(file.pos(), totalBytes, m_messages.size())) {
+            clear();
+            return false;
         }
     }
+    m_report.lineCount = m_lineNumber;
     for (CanMessage *message : m_messages) {
         if (!message || !message->getReceivers().isEmpty()) {
             continue;
@@ -98,12 +182,38 @@ bool DbcParser::parseFile(const QString &filePath)
             }
         }
         if (!merged.isEmpty()) {
-            message->setReceivers(merged);
+            message->setReceivers(std::move(merged));
         }
     }
+    m_messageIndex = MessageIndex(m_messages);
+    m_messageIndexStale = false;
+    m_report.totalNanoseconds = timer.nsecsElapsed();
+    if (progress) {
+        progress(totalBytes, totalBytes, m_messages.size());
+    }
     return true;
 }
 
+void DbcParser::swap(DbcParser &other)
+{
+    qSwap(m_version, other.m_version);
+    qSwap(m_busType, other.m_busType);
+    qSwap(m_documentTitle, other.m_documentTitle);
+    qSwap(m_changeHistory, other.m_changeHistory);
+    qSwap(m_nodes, other.m_nodes);
+    qSwap(m_messages, other.m_messages);
+    qSwap(m_messageMap, other.m_messageMap);
+    qSwap(m_messageIndex, other.m_messageIndex);
+    qSwap(m_messageIndexStale, other.m_messageIndexStale);
+    qSwap(m_skipSignalsForCurrentMessage, other.m_skipSignalsForCurrentMessage);
+    qSwap(m_attributes, other.m_attributes);
+    qSwap(m_globalValueTables, other.m_globalValueTables);
+    qSwap(m_report, other.m_report);
+    qSwap(m_lineNumber, other.m_lineNumber);
+    qSwap(m_lineColumn, other.m_lineColumn);
+    qSwap(m_currentKeyword, other.m_currentKeyword);
+}
+
 bool DbcParser::loadFromExcelImport(DbcExcelConverter::ImportResult &result)
 {
     clear();
@@ -117,6 +227,8 @@ bool DbcParser::loadFromExcelImport(DbcExcelConverter::ImportResult &result)
     for (CanMessage *msg : m_messages) {
         m_messageMap[msg->getId()] = msg;
     }
+    m_messageIndex = MessageIndex(m_messages);
+    m_messageIndexStale = false;
     return true;
 }
 
@@ -129,6 +241,17 @@ void DbcParser::addMessage(CanMessage *message)
         m_messages.append(message);
     }
     m_messageMap[message->getId()] = message;
+    m_messageIndexStale = true;
+}
+
+void DbcParser::insertMessage(int index, CanMessage *message)
+{
+    if (!message || m_messages.contains(message)) {
+        return;
+    }
+    m_messages.insert(qBound(0, index, m_messages.size()), message);
+    m_messageMap[message->getId()] = message;
+    m_messageIndexStale = true;
 }
 
 void DbcParser::removeMessage(CanMessage *message)
@@ -138,16 +261,30 @@ void DbcParser::removeMessage(CanMessage *message)
     }
     m_messages.removeAll(message);
     m_messageMap.remove(message->getId());
+    m_messageIndexStale = true;
     delete message;
 }
 
-bool DbcParser::parseLine(const QString &line)
+int DbcParser::takeMessage(CanMessage *message)
 {
-    if (line.isEmpty() || line.startsWith("//")) {
-        return true;
+    const int index = m_messages.indexOf(message);
+    if (index < 0) {
+        return -1;
+    }
+    m_messages.removeAt(index);
+    if (m_messageMap.value(message->getId()) == message) {
+        m_messageMap.remove(message->getId());
     }
+    m_messageIndexStale = true;
+    return index;
+}
+
+bool DbcParser::parseLine(const QString &line)
+{
+    DBC_TRACE_SCOPE("DbcParser::parseLine");
+    const QString &keyword = m_currentKeyword;
 
-    if (line.startsWith("VERSION")) {
+    if (keyword == QLatin1String("VERSION")) {
         QRegularExpression regex = makeRegex("VERSION\\s+\"([^\"]*)\"");
         const QRegularExpressionMatch match = regex.match(line);
         if (match.hasMatch()) {
@@ -156,7 +293,7 @@ bool DbcParser::parseLine(const QString &line)
         return true;
     }
 
-    if (line.startsWith("BU_:")) {
+    if (keyword == QLatin1String("BU_")) {
         const QString nodesPart = line.section(':', 1).trimmed();
         const QStringList nodes = nodesPart.split(QRegularExpression(QStringLiteral("\\s+")), QString::SkipEmptyParts);
         for (const QString &node : nodes) {
@@ -167,42 +304,50 @@ bool DbcParser::parseLine(const QString &line)
         return true;
     }
 
-    if (line.startsWith("BO_TX_BU_")) {
+    if (keyword == QLatin1String("BO_TX_BU_")) {
         return parseBoTxBu(line);
     }
 
-    if (line.startsWith("CM_")) {
+    if (keyword == QLatin1String("CM_")) {
         return parseComment(line);
     }
 
-    if (line.startsWith("BA_DEF_")) {
+    if (keyword == QLatin1String("BA_DEF_")) {
         return parseAttributeDefinition(line);
     }
 
-    if (line.startsWith("BA_DEF_DEF_")) {
-        return true;
+    if (keyword == QLatin1String("BA_DEF_DEF_")) {
+        return parseAttributeDefault(line);
     }
 
-    if (line.startsWith("BA_")) {
+    if (keyword == QLatin1String("BA_")) {
         return parseAttribute(line);
     }
 
-    if (line.startsWith("VAL_TABLE_")) {
+    if (keyword == QLatin1String("VAL_TABLE_")) {
         return parseGlobalValueTable(line);
     }
 
-    if (line.startsWith("VAL_")) {
+    if (keyword == QLatin1String("VAL_")) {
         return parseValueTable(line);
     }
 
-    if (line.startsWith("BO_")) {
+    if (keyword == QLatin1String("BO_")) {
         return parseMessage(line);
     }
 
-    if (line.startsWith("SG_")) {
+    if (keyword == QLatin1String("SG_")) {
         return parseSignal(line);
     }
 
+    if (kIgnoredKeywords.contains(keyword)) {
+        m_report.records[keyword].ignored = true;
+    } else {
+        reportIssue(ParseReport::Unknown,
+                    keyword.isEmpty() ? QStringLiteral("Line does not start with a keyword (continuation of a multi-line record?)")
+                                      : QStringLiteral("Unknown keyword %1").arg(keyword),
+                    line);
+    }
     return true;
 }
 
@@ -244,7 +389,8 @@ bool DbcParser::parseSignal(const QString &line)
         return true;
     }
     if (m_messages.isEmpty()) {
-        return false;
+        reportIssue(ParseReport::Dropped, QStringLiteral("Signal %1 appears before any BO_").arg(match.captured(1)), line);
+        return true;
     }
 
     auto *signal = new CanSignal();
@@ -261,8 +407,7 @@ bool DbcParser::parseSignal(const QString &line)
 
     QString receiversStr = match.captured(11).trimmed();
     receiversStr.remove(';');
-    const QStringList receivers = receiversStr.split(QRegularExpression(QStringLiteral("[\\s,]+")), QString::SkipEmptyParts);
-    signal->setReceivers(receivers);
+    signal->setReceivers(receiversStr.split(QRegularExpression(QStringLiteral("[\\s,]+")), QString::SkipEmptyParts));
 
     m_messages.last()->addSignal(signal);
     return true;
@@ -278,12 +423,15 @@ bool DbcParser::parseValueTable(const QString &line)
 
     CanMessage *message = getMessage(match.captured(1).toUInt());
     if (!message) {
-        return false;
+        reportIssue(ParseReport::Dropped, QStringLiteral("VAL_ target message %1 not found").arg(match.captured(1)), line);
+        return true;
     }
 
     CanSignal *signal = message->getSignal(match.captured(2));
     if (!signal) {
-        return false;
+        reportIssue(ParseReport::Dropped, QStringLiteral("VAL_ target signal %1 not found in %2")
+                                              .arg(match.captured(2), message->getName()), line);
+        return true;
     }
 
     QMap<int, QString> valueTable;
@@ -293,150 +441,244 @@ bool DbcParser::parseValueTable(const QString &line)
         const QRegularExpressionMatch valueMatch = it.next();
         valueTable[valueMatch.captured(1).toInt()] = valueMatch.captured(2);
     }
-    signal->setValueTable(valueTable);
+    signal->setValueTable(std::move(valueTable));
     return true;
 }
 
 bool DbcParser::parseAttribute(const QString &line)
 {
-    QRegularExpression docTitleRegex = makeRegex("BA_\\s+\"DocumentTitle\"\\s+\"([^\"]*)\"");
-    const QRegularExpressionMatch docTitleMatch = docTitleRegex.match(line);
-    if (docTitleMatch.hasMatch()) {
-        QString value = docTitleMatch.captured(1);
-        value.replace(QLatin1String("\\\\"), QLatin1String("\\"));
-        value.replace(QLatin1String("\\n"), QLatin1String("\n"));
-        value.replace(QLatin1String("\\\""), QLatin1String("\""));
-        m_documentTitle = value;
-        return true;
-    }
-
-    QRegularExpression changeHistoryRegex = makeRegex("BA_\\s+\"ChangeHistory\"\\s+\"([^\"]*)\"");
-    const QRegularExpressionMatch changeHistoryMatch = changeHistoryRegex.match(line);
-    if (changeHistoryMatch.hasMatch()) {
-        QString value = changeHistoryMatch.captured(1);
-        value.replace(QLatin1String("\\\\"), QLatin1String("\\"));
-        value.replace(QLatin1String("\\n"), QLatin1String("\n"));
-        value.replace(QLatin1String("\\t"), QLatin1String("\t"));
-        value.replace(QLatin1String("\\\""), QLatin1String("\""));
-        const QStringList records = value.split(QLatin1Char('\n'), QString::SkipEmptyParts);
-        for (const QString &record : records) {
-            const QStringList fields = record.split(QLatin1Char('\t'));
-            if (fields.size() >= 6) {
-                const QString col1 = fields.at(0).trimmed();
-                const QString col2 = fields.at(1).trimmed();
-                if (col1 == QStringLiteral("序号") && col2 == QStringLiteral("协议版本")) {
-                    continue;
-                }
-                DbcExcelConverter::ChangeHistoryEntry e;
-                e.serialNumber = col1;
-                e.protocolVersion = col2;
-                e.changeContent = fields.at(2).trimmed();
-                e.changer = fields.at(3).trimmed();
-                e.changeDate = fields.at(4).trimmed();
-                e.reviewer = fields.at(5).trimmed();
-                m_changeHistory.append(e);
-            }
-        }
-        return true;
+    QRegularExpression regex = makeRegex("BA_\\s+\"([^\"]+)\"\\s+(?:(BU_|EV_)\\s+([^\\s]+)\\s+|BO_\\s+(\\d+)\\s+"
+                                         "|SG_\\s+(\\d+)\\s+([^\\s]+)\\s+)?(.*?)\\s*;?\\s*$");
+    const QRegularExpressionMatch match = regex.match(line);
+    if (!match.hasMatch() || match.captured(7).isEmpty()) {
+        return false;
     }
-
-    QRegularExpression busTypeRegex = makeRegex("BA_\\s+\"BusType\"\\s+\"([^\"]+)\"");
-    const QRegularExpressionMatch busMatch = busTypeRegex.match(line);
-    if (busMatch.hasMatch()) {
-        m_busType = busMatch.captured(1);
+    const QString attrName = match.captured(1);
+    const int attrId = AttributeStore::nameId(attrName);
+    const AttributeStore::ModelField field = AttributeStore::modelField(attrId);
+    const QString valueToken = match.captured(7);
+    const QString objectScope = match.captured(2);
+    const bool isMessage = match.capturedLength(4) > 0;
+    const bool isSignal = match.capturedLength(5) > 0;
+
+    if (objectScope == QLatin1String("EV_")) {
+        // Environment variables are not modelled
+        ++m_report.ignoredAttributes[attrName];
         return true;
     }
 
-    QRegularExpression msgRegex = makeRegex("BA_\\s+\"([^\"]+)\"\\s+BO_\\s+(\\d+)\\s+([^;]+);");
-    const QRegularExpressionMatch msgMatch = msgRegex.match(line);
-    if (msgMatch.hasMatch()) {
-        const QString attrName = msgMatch.captured(1);
-        CanMessage *message = getMessage(msgMatch.captured(2).toUInt());
+    CanMessage *message = nullptr;
+    CanSignal *signal = nullptr;
+    if (isMessage || isSignal) {
+        const QString messageId = match.captured(isMessage ? 4 : 5);
+        message = getMessage(messageId.toUInt());
         if (!message) {
+            reportIssue(ParseReport::Dropped, QStringLiteral("Attribute %1 for unknown message %2")
+                                                  .arg(attrName, messageId), line);
             return true;
         }
-
-        QString valuePart = msgMatch.captured(3).trimmed();
-        if (valuePart.startsWith('"') && valuePart.endsWith('"')) {
-            valuePart = valuePart.mid(1, valuePart.size() - 2);
-        }
-
-        if (attrName == "GenMsgCycleTime") {
-            message->setCycleTime(valuePart.toInt());
-        } else if (attrName == "GenMsgSendType") {
-            const QString mapped = enumValueLookup(m_messageAttributeEnums, attrName, valuePart.toInt());
-            message->setSendType(mapped.isEmpty() ? valuePart : mapped);
-        } else if (attrName == "VFrameFormat") {
-            const QString mapped = enumValueLookup(m_messageAttributeEnums, attrName, valuePart.toInt());
-            message->setFrameFormat(mapped.isEmpty() ? valuePart : mapped);
-            message->setMessageType(normalizeFrameFormat(message->getFrameFormat()));
-        } else if (attrName == "GenMsgNrOfRepetitions" || attrName == "GenMsgNrOfRepetition") {
-            message->setNrOfRepetitions(valuePart.toInt());
-        } else if (attrName == "GenMsgDelayTime") {
-            message->setDelayTime(valuePart.toInt());
-        } else if (attrName == "GenMsgCycleTimeFast") {
-            message->setCycleTimeFast(valuePart.toInt());
-        }
-        return true;
     }
-
-    QRegularExpression sigRegex = makeRegex("BA_\\s+\"([^\"]+)\"\\s+SG_\\s+(\\d+)\\s+([^\\s]+)\\s+([^;]+);");
-    const QRegularExpressionMatch sigMatch = sigRegex.match(line);
-    if (sigMatch.hasMatch()) {
-        const QString attrName = sigMatch.captured(1);
-        CanMessage *message = getMessage(sigMatch.captured(2).toUInt());
-        if (!message) {
-            return true;
-        }
-
-        CanSignal *signal = message->getSignal(sigMatch.captured(3));
+    if (isSignal) {
+        signal = message->getSignal(match.captured(6));
         if (!signal) {
+            reportIssue(ParseReport::Dropped, QStringLiteral("Attribute %1 for unknown signal %2 in %3")
+                                                  .arg(attrName, match.captured(6), message->getName()), line);
             return true;
         }
+    }
 
-        QString valuePart = sigMatch.captured(4).trimmed();
-        if (valuePart.startsWith('"') && valuePart.endsWith('"')) {
-            valuePart = valuePart.mid(1, valuePart.size() - 2);
+    QString valuePart = valueToken;
+    if (valuePart.size() >= 2 && valuePart.startsWith('"') && valuePart.endsWith('"')) {
+        valuePart = valuePart.mid(1, valuePart.size() - 2);
+    }
+
+    // Attributes backed by model fields; the writer regenerates them from those fields.
+    if (field != AttributeStore::NoModelField) {
+        if (!message && objectScope.isEmpty()) {
+            switch (field) {
+            case AttributeStore::DocumentTitleField:
+                valuePart.replace(QLatin1String("\\\\"), QLatin1String("\\"));
+                valuePart.replace(QLatin1String("\\n"), QLatin1String("\n"));
+                valuePart.replace(QLatin1String("\\\""), QLatin1String("\""));
+                m_documentTitle = valuePart;
+                return true;
+            case AttributeStore::ChangeHistoryField:
+                parseChangeHistory(valuePart);
+                return true;
+            case AttributeStore::BusTypeField:
+                m_busType = valuePart;
+                return true;
+            default:
+                break;
+            }
+        } else if (message && !signal) {
+            switch (field) {
+            case AttributeStore::CycleTimeField:
+                message->setCycleTime(valuePart.toInt());
+                return true;
+            case AttributeStore::MessageSendTypeField:
+                message->setSendType(enumText(attrId, valuePart));
+                return true;
+            case AttributeStore::FrameFormatField:
+                message->setFrameFormat(enumText(attrId, valuePart));
+                message->setMessageType(normalizeFrameFormat(message->getFrameFormat()));
+                return true;
+            case AttributeStore::RepetitionsField:
+                message->setNrOfRepetitions(valuePart.toInt());
+                return true;
+            case AttributeStore::DelayTimeField:
+                message->setDelayTime(valuePart.toInt());
+                return true;
+            case AttributeStore::CycleTimeFastField:
+                message->setCycleTimeFast(valuePart.toInt());
+                return true;
+            default:
+                break;
+            }
+        } else if (signal) {
+            switch (field) {
+            case AttributeStore::SignalSendTypeField:
+                signal->setSendType(enumText(attrId, valuePart));
+                return true;
+            case AttributeStore::StartValueField:
+                signal->setInitialValue(valuePart.toDouble());
+                return true;
+            case AttributeStore::SnaField:
+                signal->setInactiveValueHex(valuePart);
+                return true;
+            default:
+                break;
+            }
         }
+    }
 
-        if (attrName == "GenSigSendType") {
-            const QString mapped = enumValueLookup(m_signalAttributeEnums, attrName, valuePart.toInt());
-            signal->setSendType(mapped.isEmpty() ? valuePart : mapped);
-        } else if (attrName == "GenSigStartValue") {
-            signal->setInitialValue(valuePart.toDouble());
-        } else if (attrName == "GenSigSNA") {
-            signal->setInactiveValueHex(valuePart);
-        }
+    const AttributeStore::Definition *definition = m_attributes.definition(attrId);
+    if (!definition) {
+        ++m_report.ignoredAttributes[attrName];
+        return true;
+    }
+    const AttributeStore::Scope scope = signal ? AttributeStore::Signal
+                                        : message ? AttributeStore::Message
+                                        : objectScope.isEmpty() ? AttributeStore::Network : AttributeStore::Node;
+    if (definition->scope != scope) {
+        reportIssue(ParseReport::Dropped, QStringLiteral("Attribute %1 is not defined for this object type").arg(attrName), line);
+        return true;
+    }
+    AttributeValue value;
+    QString error;
+    if (!m_attributes.parseValue(attrId, valueToken, &value, &error)) {
+        reportIssue(ParseReport::Dropped, error, line);
         return true;
     }
 
+    switch (scope) {
+    case AttributeStore::Network:
+        m_attributes.setNetworkValue(attrId, value);
+        break;
+    case AttributeStore::Node:
+        m_attributes.setNodeValue(match.captured(3), attrId, value);
+        break;
+    case AttributeStore::Message: {
+        AttributeValues values = message->getAttributes();
+        m_attributes.setValue(&values, attrId, value);
+        message->setAttributes(std::move(values));
+        break;
+    }
+    case AttributeStore::Signal: {
+        AttributeValues values = signal->getAttributes();
+        m_attributes.setValue(&values, attrId, value);
+        signal->setAttributes(std::move(values));
+        break;
+    }
+    case AttributeStore::EnvironmentVariable:
+        break;
+    }
     return true;
 }
 
+void DbcParser::parseChangeHistory(QString value)
+{
+    value.replace(QLatin1String("\\\\"), QLatin1String("\\"));
+    value.replace(QLatin1String("\\n"), QLatin1String("\n"));
+    value.replace(QLatin1String("\\t"), QLatin1String("\t"));
+    value.replace(QLatin1String("\\\""), QLatin1String("\""));
+    const QStringList records = value.split(QLatin1Char('\n'), QString::SkipEmptyParts);
+    for (const QString &record : records) {
+        const QStringList fields = record.split(QLatin1Char('\t'));
+        if (fields.size() >= 6) {
+            const QString col1 = fields.at(0).trimmed();
+            const QString col2 = fields.at(1).trimmed();
+            if (col1 == QStringLiteral("序号") && col2 == QStringLiteral("协议版本")) {
+                continue;
+            }
+            DbcExcelConverter::ChangeHistoryEntry e;
+            e.serialNumber = col1;
+            e.protocolVersion = col2;
+            e.changeContent = fields.at(2).trimmed();
+            e.changer = fields.at(3).trimmed();
+            e.changeDate = fields.at(4).trimmed();
+            e.reviewer = fields.at(5).trimmed();
+            m_changeHistory.append(e);
+        }
+    }
+}
+
 bool DbcParser::parseAttributeDefinition(const QString &line)
 {
-    QRegularExpression enumRegex = makeRegex("BA_DEF_\\s+(BO_|SG_)\\s+\"([^\"]+)\"\\s+ENUM\\s+(.+);");
-    const QRegularExpressionMatch match = enumRegex.match(line);
+    QRegularExpression regex = makeRegex("BA_DEF_\\s+(?:(BU_|BO_|SG_|EV_)\\s+)?\"([^\"]+)\"\\s+"
+                                         "(INT|HEX|FLOAT|STRING|ENUM)\\b\\s*(.*?)\\s*;?\\s*$");
+    const QRegularExpressionMatch match = regex.match(line);
     if (!match.hasMatch()) {
-        return true;
+        return false;
     }
 
     const QString scope = match.captured(1);
-    const QString attrName = match.captured(2);
-    const QString valuesPart = match.captured(3);
-
-    QStringList values;
-    QRegularExpression valueRegex = makeRegex("\"([^\"]*)\"");
-    QRegularExpressionMatchIterator it = valueRegex.globalMatch(valuesPart);
-    while (it.hasNext()) {
-        values.append(it.next().captured(1));
+    const QString type = match.captured(3);
+    const QString params = match.captured(4);
+    AttributeStore::Definition definition;
+    definition.id = AttributeStore::nameId(match.captured(2));
+    definition.scope = scope == QLatin1String("BU_") ? AttributeStore::Node
+                       : scope == QLatin1String("BO_") ? AttributeStore::Message
+                       : scope == QLatin1String("SG_") ? AttributeStore::Signal
+                       : scope == QLatin1String("EV_") ? AttributeStore::EnvironmentVariable
+                                                       : AttributeStore::Network;
+    if (type == QLatin1String("ENUM")) {
+        definition.type = AttributeStore::Enum;
+        QRegularExpression valueRegex = makeRegex("\"([^\"]*)\"");
+        QRegularExpressionMatchIterator it = valueRegex.globalMatch(params);
+        while (it.hasNext()) {
+            definition.enumValues.append(it.next().captured(1));
+        }
+    } else if (type == QLatin1String("STRING")) {
+        definition.type = AttributeStore::String;
+    } else {
+        definition.type = type == QLatin1String("INT") ? AttributeStore::Int
+                          : type == QLatin1String("HEX") ? AttributeStore::Hex : AttributeStore::Float;
+        const QStringList range = params.split(QRegularExpression(QStringLiteral("\\s+")), QString::SkipEmptyParts);
+        if (range.size() >= 2) {
+            definition.minimum = parseDouble(range.at(0));
+            definition.maximum = parseDouble(range.at(1));
+        }
     }
+    m_attributes.define(definition);
+    return true;
+}
 
-    if (scope == "BO_") {
-        m_messageAttributeEnums[attrName] = values;
-    } else if (scope == "SG_") {
-        m_signalAttributeEnums[attrName] = values;
+bool DbcParser::parseAttributeDefault(const QString &line)
+{
+    QRegularExpression regex = makeRegex("BA_DEF_DEF_\\s+\"([^\"]+)\"\\s+(.*?)\\s*;?\\s*$");
+    const QRegularExpressionMatch match = regex.match(line);
+    if (!match.hasMatch() || match.captured(2).isEmpty()) {
+        return false;
+    }
+    const int attrId = AttributeStore::nameId(match.captured(1));
+    AttributeValue value;
+    QString error;
+    if (!m_attributes.parseValue(attrId, match.captured(2), &value, &error)) {
+        reportIssue(ParseReport::Dropped, error, line);
+        return true;
     }
+    m_attributes.setDefault(attrId, value);
     return true;
 }
 
@@ -448,6 +690,8 @@ bool DbcParser::parseComment(const QString &line)
         CanMessage *message = getMessage(msgMatch.captured(1).toUInt());
         if (message) {
             message->setComment(msgMatch.captured(2));
+        } else {
+            reportIssue(ParseReport::Dropped, QStringLiteral("Comment for unknown message %1").arg(msgMatch.captured(1)), line);
         }
         return true;
     }
@@ -457,14 +701,23 @@ bool DbcParser::parseComment(const QString &line)
     if (sigMatch.hasMatch()) {
         CanMessage *message = getMessage(sigMatch.captured(1).toUInt());
         if (!message) {
+            reportIssue(ParseReport::Dropped, QStringLiteral("Comment for unknown message %1").arg(sigMatch.captured(1)), line);
             return true;
         }
         CanSignal *signal = message->getSignal(sigMatch.captured(2));
         if (signal) {
             signal->setDescription(sigMatch.captured(3));
+        } else {
+            reportIssue(ParseReport::Dropped, QStringLiteral("Comment for unknown signal %1 in %2")
+                                                  .arg(sigMatch.captured(2), message->getName()), line);
         }
         return true;
     }
+    if (!line.endsWith(QLatin1Char(';'))) {
+        reportIssue(ParseReport::Malformed, QStringLiteral("Multi-line comment is not supported"), line);
+    } else {
+        reportIssue(ParseReport::Dropped, QStringLiteral("Only BO_ and SG_ comments are imported"), line);
+    }
     return true;
 }
 
@@ -482,7 +735,9 @@ bool DbcParser::parseBoTxBu(const QString &line)
 
     CanMessage *message = getMessage(match.captured(1).toUInt());
     if (message) {
-        message->setReceivers(receivers);
+        message->setReceivers(std::move(receivers));
+    } else {
+        reportIssue(ParseReport::Dropped, QStringLiteral("BO_TX_BU_ for unknown message %1").arg(match.captured(1)), line);
     }
     return true;
 }
@@ -508,6 +763,24 @@ bool DbcParser::parseGlobalValueTable(const QString &line)
     return true;
 }
 
+void DbcParser::rebuildMessageIndex()
+{
+    m_messageMap.clear();
+    for (CanMessage *message : m_messages) {
+        m_messageMap[message->getId()] = message;
+    }
+    m_messageIndexStale = true;
+}
+
+const MessageIndex &DbcParser::messageIndex() const
+{
+    if (m_messageIndexStale) {
+        m_messageIndex = MessageIndex(m_messages);
+        m_messageIndexStale = false;
+    }
+    return m_messageIndex;
+}
+
 CanMessage *DbcParser::getMessage(quint32 id) const
 {
     return m_messageMap.value(id, nullptr);
@@ -527,11 +800,19 @@ int DbcParser::parseInt(const QString &str)
     return ok ? value : 0;
 }
 
-QString DbcParser::enumValueLookup(const QMap<QString, QStringList> &map, const QString &attrName, int index) const
+QString DbcParser::enumText(int attributeId, const QString &value) const
 {
-    const QStringList values = map.value(attrName);
-    if (index < 0 || index >= values.size()) {
-        return QString();
+    // Enum attributes hold an index into the BA_DEF_ list; keep the raw text when it does not resolve
+    const AttributeStore::Definition *definition = m_attributes.definition(attributeId);
+    if (!definition || definition->type != AttributeStore::Enum) {
+        return value;
     }
-    return values.at(index);
+    bool ok = false;
+    const int index = value.toInt(&ok);
+    return ok && index >= 0 && index < definition->enumValues.size() ? definition->enumValues.at(index) : value;
+}
+
+void DbcParser::reportIssue(ParseReport::IssueKind kind, const QString &message, const QString &line)
+{
+    m_report.addIssue(kind, m_lineNumber, m_lineColumn, m_currentKeyword, message, line);
 }
@@ -6,8 +6,14 @@
 #include <QList>
 #include <QMap>
 #include <QtGlobal>
+
+#include <functional>
+
+#include "attributestore.h"
 #include "canmessage.h"
 #include "dbcexcelconverter.h"
+#include "messageindex.h"
+#include "parsereport.h"
 
 class DbcParser
 {
@@ -15,13 +21,29 @@ public:
     DbcParser();
     ~DbcParser();
 
-    bool parseFile(const QString &filePath);
+    /**
+     * Parse progress: bytes consumed, file size, messages parsed so far.
+     * Return false to cancel; parseFile then clears the parser and returns false.
+     */
+    using ProgressCallback = std::function<bool(qint64 bytesRead, qint64 totalBytes, int messagesParsed)>;
+
+    bool parseFile(const QString &filePath, const ProgressCallback &progress = ProgressCallback());
     bool loadFromExcelImport(DbcExcelConverter::ImportResult &result);
     const QList<CanMessage*> &getMessages() const { return m_messages; }
     QList<CanMessage*> &messages() { return m_messages; }
     void addMessage(CanMessage *message);
+    void insertMessage(int index, CanMessage *message);
     void removeMessage(CanMessage *message);
+    /** Detaches the message without deleting it; returns its former index or -1. */
+    int takeMessage(CanMessage *message);
     CanMessage* getMessage(quint32 id) const;
+    /**
+     * Read-optimised ID -> ordinal (index into getMessages()) lookup for frame dispatch. Built
+     * after loading; add/insert/remove/takeMessage only mark it stale and it is rebuilt on the
+     * next call. Call rebuildMessageIndex() after changing a message ID in place.
+     */
+    const MessageIndex &messageIndex() const;
+    void rebuildMessageIndex();
     QString getVersion() const { return m_version; }
     QString getBusType() const { return m_busType; }
     QString getDocumentTitle() const { return m_documentTitle; }
@@ -29,8 +51,18 @@ public:
     QStringList getNodes() const { return m_nodes; }
     /** Global named value tables (VAL_TABLE_ name val "desc" ...). Order preserved. */
     QList<QPair<QString, QMap<int, QString>>> getGlobalValueTables() const { return m_globalValueTables; }
+    /**
+     * Attribute definitions, defaults and network/node values (BA_DEF_, BA_DEF_DEF_, BA_).
+     * Message and signal values are on the objects; attributes mapped onto model fields
+     * (GenMsgCycleTime, GenSigSendType, ...) are only kept in those fields.
+     */
+    const AttributeStore &attributes() const { return m_attributes; }
+    /** Statistics and issues of the last parseFile() (empty after an Excel import). */
+    const ParseReport &parseReport() const { return m_report; }
 
     void clear();
+    /** Exchanges the whole database with other (used to publish a database loaded off-thread). */
+    void swap(DbcParser &other);
 
 private:
     QString m_version;
@@ -40,12 +72,19 @@ private:
     QStringList m_nodes;
     QList<CanMessage*> m_messages;
     QMap<quint32, CanMessage*> m_messageMap;
+    mutable MessageIndex m_messageIndex;
+    mutable bool m_messageIndexStale;
     /** When true, current BO_ is VECTOR__INDEPENDENT_SIG_MSG; skip adding it and its SG_ lines. */
     bool m_skipSignalsForCurrentMessage;
-    QMap<QString, QStringList> m_messageAttributeEnums;
-    QMap<QString, QStringList> m_signalAttributeEnums;
+    AttributeStore m_attributes;
     QList<QPair<QString, QMap<int, QString>>> m_globalValueTables;
+    ParseReport m_report;
+    // Position of the record being parsed, for report issues
+    int m_lineNumber;
+    int m_lineColumn;
+    QString m_currentKeyword;
 
+    /** Dispatches on m_currentKeyword; returns false when the record is malformed. */
     bool parseLine(const QString &line);
     bool parseMessage(const QString &line);
     bool parseSignal(const QString &line);
@@ -53,13 +92,16 @@ private:
     bool parseGlobalValueTable(const QString &line);
     bool parseAttribute(const QString &line);
     bool parseAttributeDefinition(const QString &line);
+    bool parseAttributeDefault(const QString &line);
+    void parseChangeHistory(QString value);
     bool parseComment(const QString &line);
     bool parseBoTxBu(const QString &line);
     
     QStringList splitDbcLine(const QString &line);
     double parseDouble(const QString &str);
     int parseInt(const QString &str);
-    QString enumValueLookup(const QMap<QString, QStringList> &map, const QString &attrName, int index) const;
+    QString enumText(int attributeId, const QString &value) const;
+    void reportIssue(ParseReport::IssueKind kind, const QString &message, const QString &line);
 };
 
 #endif // DBCPARSER_H
@@ -0,0 +1,109 @@
+#include "dbcsnapshot.h"
+
+#include "dbcparser.h"
+
+MessageSnapshot::MessageSnapshot(const CanMessage &live)
+    : m_message(live.fieldsOnly())
+{
+    setSignalList(live.getSignals());
+}
+
+void MessageSnapshot::setSignal(int index, const CanSignal &signal)
+{
+    if (index >= 0 && index < m_signals.size()) {
+        m_signals[index] = signal;
+    }
+}
+
+void MessageSnapshot::setSignalList(const QList<CanSignal *> &liveSignals)
+{
+    m_signals.clear();
+    m_signals.reserve(liveSignals.size());
+    for (const CanSignal *signal : liveSignals) {
+        if (signal) {
+            m_signals.append(*signal);
+        }
+    }
+}
+
+bool MessageSnapshot::operator==(const MessageSnapshot &other) const
+{
+    if (!m_message.hasSameFields(other.m_message) || m_signals.size() != other.m_signals.size()) {
+        return false;
+    }
+    for (int i = 0; i < m_signals.size(); ++i) {
+        if (m_signals.at(i) != other.m_signals.at(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DbcSnapshot snapshotOf(const DbcParser &parser)
+{
+    DbcSnapshot snapshot;
+    snapshot.version = parser.getVersion();
+    snapshot.busType = parser.getBusType();
+    snapshot.nodes = parser.getNodes();
+    snapshot.documentTitle = parser.getDocumentTitle();
+    snapshot.changeHistory = parser.getChangeHistory();
+    snapshot.globalValueTables = parser.getGlobalValueTables();
+    snapshot.attributes = parser.attributes();
+    snapshot.messages.reserve(parser.getMessages().size());
+    for (const CanMessage *message : parser.getMessages()) {
+        snapshot.messages.append(MessageSnapshot(*message));
+    }
+    return snapshot;
+}
+
+QList<CanMessage *> createMessages(const DbcSnapshot &snapshot)
+{
+    QList<CanMessage *> messages;
+    messages.reserve(snapshot.messages.size());
+    for (const MessageSnapshot &entry : snapshot.messages) {
+        CanMessage *message = new CanMessage(entry.message().fieldsOnly());
+        for (const CanSignal &signal : entry.signalList()) {
+            message->addSignal(new CanSignal(signal));
+        }
+        messages.append(message);
+    }
+    return messages;
+}
+
+void DbcSnapshotTracker::reset(const DbcParser &parser)
+{
+    m_current = snapshotOf(parser);
+}
+
+void DbcSnapshotTracker::messageChanged(int row, const CanMessage &message)
+{
+    if (row >= 0 && row < m_current.messages.size()) {
+        m_current.messages[row].setMessage(message);
+    }
+}
+
+void DbcSnapshotTracker::signalChanged(int row, int signalRow, const CanSignal &signal)
+{
+    if (row >= 0 && row < m_current.messages.size()) {
+        m_current.messages[row].setSignal(signalRow, signal);
+    }
+}
+
+void DbcSnapshotTracker::signalListChanged(int row, const CanMessage &message)
+{
+    if (row >= 0 && row < m_current.messages.size()) {
+        m_current.messages[row].setSignalList(message.getSignals());
+    }
+}
+
+void DbcSnapshotTracker::messageInserted(int row, const CanMessage &message)
+{
+    m_current.messages.insert(qBound(0, row, m_current.messages.size()), MessageSnapshot(message));
+}
+
+void DbcSnapshotTracker::messageRemoved(int row)
+{
+    if (row >= 0 && row < m_current.messages.size()) {
+        m_current.messages.remove(row);
+    }
+}
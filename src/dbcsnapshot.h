@@ -0,0 +1,94 @@
+#ifndef DBCSNAPSHOT_H
+#define DBCSNAPSHOT_H
+
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "attributestore.h"
+#include "canmessage.h"
+#include "dbcexcelconverter.h"
+
+class DbcParser;
+
+/**
+ * Immutable copy of one message and its signals. Field data is shared with the live
+ * CanMessage/CanSignal objects until one side is modified, so unchanged messages cost a
+ * few pointers per snapshot.
+ */
+class MessageSnapshot
+{
+public:
+    MessageSnapshot() = default;
+    explicit MessageSnapshot(const CanMessage &live);
+
+    /** Message fields; its getSignals() is empty, see signalList(). */
+    const CanMessage &message() const { return m_message; }
+    const QVector<CanSignal> &signalList() const { return m_signals; }
+
+    void setMessage(const CanMessage &live) { m_message = live.fieldsOnly(); }
+    void setSignal(int index, const CanSignal &signal);
+    void setSignalList(const QList<CanSignal *> &liveSignals);
+    void setSignalList(const QVector<CanSignal> &signalList) { m_signals = signalList; }
+
+    /** Field-wise equality; shared (unmodified) data compares in O(1) per node. */
+    bool operator==(const MessageSnapshot &other) const;
+    bool operator!=(const MessageSnapshot &other) const { return !(*this == other); }
+
+private:
+    CanMessage m_message;
+    QVector<CanSignal> m_signals;
+};
+
+/** Whole-database snapshot. All members are implicitly shared, so copying is O(1). */
+struct DbcSnapshot
+{
+    QString version;
+    QString busType;
+    QStringList nodes;
+    QString documentTitle;
+    QList<DbcExcelConverter::ChangeHistoryEntry> changeHistory;
+    QList<QPair<QString, QMap<int, QString>>> globalValueTables;
+    QVector<MessageSnapshot> messages;
+    AttributeStore attributes; // definitions and network/node values; message/signal values are on the messages
+};
+
+struct DbcCheckpoint
+{
+    QString name;
+    QDateTime created;
+    DbcSnapshot snapshot;
+};
+
+/** Snapshot of a whole parsed database (O(messages + signals), no field data is copied). */
+DbcSnapshot snapshotOf(const DbcParser &parser);
+/** New live messages/signals from a snapshot (e.g. a merge result); the caller owns them. */
+QList<CanMessage *> createMessages(const DbcSnapshot &snapshot);
+
+/**
+ * Keeps a DbcSnapshot in step with the live database one edit at a time, so current()
+ * is an O(1) copy. After a snapshot is taken, the next edit copies the message handle
+ * array once (Qt implicit sharing); field data is only copied for the edited node.
+ */
+class DbcSnapshotTracker
+{
+public:
+    /** Rebuilds from the parser (after load/swap). */
+    void reset(const DbcParser &parser);
+    void messageChanged(int row, const CanMessage &message);
+    void signalChanged(int row, int signalRow, const CanSignal &signal);
+    void signalListChanged(int row, const CanMessage &message);
+    void messageInserted(int row, const CanMessage &message);
+    void messageRemoved(int row);
+
+    const DbcSnapshot &current() const { return m_current; }
+
+private:
+    DbcSnapshot m_current;
+};
+
+#endif // DBCSNAPSHOT_H
@@ -1,12 +1,14 @@
 #include "dbcvalidator.h"
 #include "canmessage.h"
 #include "cansignal.h"
+#include "signalcolumns.h"
+#include "trace.h"
 
+#include <QVector>
+#include <QtAlgorithms>
 #include <QtGlobal>
 #include <cmath>
 #include <limits>
-#include <set>
-#include <utility>
 
 namespace
 {
@@ -90,7 +92,7 @@ bool rawInUnsignedRange(quint64 raw, int length)
 void validateSignalValues(const CanMessage *message, const CanSignal *signal, ValidationResult &result)
 {
     const QString msgName = message ? message->getName() : QString();
-    const QString sigName = signal->getName();
+    const QString &sigName = signal->getName();
     const int length = signal->getLength();
     const double factor = signal->getFactor();
     const double offset = signal->getOffset();
@@ -264,104 +266,96 @@ void validateSignalValues(const CanMessage *message, const CanSignal *signal, Va
     }
 }
 
-using Cell = std::pair<int, int>;
-
 // DBC 约定：@0 = Motorola（大端，startBit 为 MSB），@1 = Intel（小端，startBit 为 LSB）
-// 重叠判断使用“物理位”(byte, bit_in_byte)，其中 bit_in_byte 统一为 0=LSB..7=MSB（与帧内线性编号 bit 0..7, 8..15 一致）
-static int bitIndexToByte(int bitIndex) { return bitIndex / 8; }
-static int bitIndexToBitInByte(int bitIndex) { return bitIndex % 8; }
-
+// 重叠判断使用“物理位”(byte, bit_in_byte)，其中 bit_in_byte 统一为 0=LSB..7=MSB（与帧内线性编号 bit 0..7, 8..15 一致）。
+// 每个信号占用的位记为位图（cell = byte * 8 + bit_in_byte），两两重叠只需按字做与运算。
 // Motorola：MSB 在 startBit，先向低位延伸（7,6,...,0），再跳到下一字节高位（15,14,...,8）
-static QList<Cell> signalCellsMotorola(int startBit, int length, int messageLengthBytes)
+// Intel：LSB 在 startBit，向高位延伸 startBit, startBit+1, ...
+int signalMask(int startBit, int length, bool motorola, int messageLengthBytes, quint64 *words)
 {
-    QList<Cell> cells;
+    int inFrame = 0;
     int bitIndex = startBit;
     for (int k = 0; k < length; ++k) {
-        int byteIdx = bitIndexToByte(bitIndex);
-        int bitInByte = bitIndexToBitInByte(bitIndex);
-        if (byteIdx >= 0 && byteIdx < messageLengthBytes && bitInByte >= 0 && bitInByte < 8) {
-            cells.append(std::make_pair(byteIdx, bitInByte));
+        const int byteIdx = bitIndex / 8;
+        const int bitInByte = bitIndex % 8;
+        if (byteIdx >= 0 && byteIdx < messageLengthBytes && bitInByte >= 0) {
+            const int cell = byteIdx * 8 + bitInByte;
+            words[cell >> 6] |= quint64(1) << (cell & 63);
+            ++inFrame;
         }
-        if (bitIndex % 8 == 0) {
+        if (!motorola) {
+            ++bitIndex;
+        } else if (bitIndex % 8 == 0) {
             bitIndex += 15;
         } else {
             bitIndex -= 1;
         }
     }
-    return cells;
+    return inFrame;
 }
 
-// Intel：LSB 在 startBit，向高位延伸 startBit, startBit+1, ...
-static QList<Cell> signalCellsIntel(int startBit, int length, int messageLengthBytes)
+void validateMessageOverlap(const CanMessage *message, const SignalColumns &columns, int ordinal,
+                            ValidationResult &result)
 {
-    QList<Cell> cells;
-    for (int k = 0; k < length; ++k) {
-        const int bitIndex = startBit + k;
-        const int byteIdx = bitIndexToByte(bitIndex);
-        const int bitInByte = bitIndexToBitInByte(bitIndex);
-        if (byteIdx >= 0 && byteIdx < messageLengthBytes && bitInByte >= 0 && bitInByte < 8) {
-            cells.append(std::make_pair(byteIdx, bitInByte));
-        }
-    }
-    return cells;
-}
+    const QString &msgName = message->getName();
+    const int msgLenBytes = columns.messageLengths().at(ordinal);
+    const int begin = columns.signalBegin(ordinal);
+    const int count = columns.signalBegin(ordinal + 1) - begin;
+    const int *startBits = columns.startBits().constData() + begin;
+    const int *lengths = columns.lengths().constData() + begin;
+    const quint8 *motorola = columns.motorola().constData() + begin;
+    auto nameOf = [&](int i) { return columns.signalAt(begin + i)->getName(); };
 
-QList<Cell> signalCells(const CanSignal *signal, int messageLengthBytes)
-{
-    const int startBit = signal->getStartBit();
-    const int length = signal->getLength();
-    const bool motorola = (signal->getByteOrder() == 0);
-    return motorola ? signalCellsMotorola(startBit, length, messageLengthBytes)
-                    : signalCellsIntel(startBit, length, messageLengthBytes);
-}
-
-void validateMessageOverlap(const CanMessage *message, ValidationResult &result)
-{
-    const QString msgName = message->getName();
-    const int msgLenBytes = message->getLength();
-    const QList<CanSignal *> signals = message->getSignals();
-
-    for (int i = 0; i < signals.size(); ++i) {
-        const CanSignal *sig = signals.at(i);
-        const int startBit = sig->getStartBit();
-        const int length = sig->getLength();
+    for (int i = 0; i < count; ++i) {
+        const int startBit = startBits[i];
+        const int length = lengths[i];
         if (length <= 0) {
-            addError(result, msgName, sig->getName(), QStringLiteral("信号长度必须大于0"));
+            addError(result, msgName, nameOf(i), QStringLiteral("信号长度必须大于0"));
             continue;
         }
         if (startBit < 0) {
-            addError(result, msgName, sig->getName(), QStringLiteral("起始位不能为负"));
+            addError(result, msgName, nameOf(i), QStringLiteral("起始位不能为负"));
             continue;
         }
-        const bool motorola = (sig->getByteOrder() == 0);
-        if (!motorola) {
+        if (!motorola[i]) {
             const int maxBit = msgLenBytes * 8 - 1;
             if (startBit + length - 1 > maxBit) {
-                addError(result, msgName, sig->getName(),
+                addError(result, msgName, nameOf(i),
                          QStringLiteral("信号位范围 [%1, %2] 超出报文长度（报文 %3 字节，有效位 0..%4）")
                              .arg(startBit).arg(startBit + length - 1).arg(msgLenBytes).arg(maxBit));
             }
         }
     }
 
-    for (int i = 0; i < signals.size(); ++i) {
-        QList<Cell> setI = signalCells(signals.at(i), msgLenBytes);
-        if (setI.size() < signals.at(i)->getLength()) {
-            addError(result, msgName, signals.at(i)->getName(),
+    const int words = (qMax(0, msgLenBytes) * 8 + 63) / 64;
+    QVector<quint64> masks(count * words, 0);
+    QVector<int> inFrame(count);
+    for (int i = 0; i < count; ++i) {
+        inFrame[i] = signalMask(startBits[i], lengths[i], motorola[i], msgLenBytes, masks.data() + i * words);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const quint64 *maskI = masks.constData() + i * words;
+        if (inFrame[i] < lengths[i]) {
+            addError(result, msgName, nameOf(i),
                      QStringLiteral("信号位范围超出报文长度（报文 %1 字节）").arg(msgLenBytes));
         }
-        std::set<Cell> uniqueI(setI.begin(), setI.end());
-        if (uniqueI.size() != setI.size()) {
-            addError(result, msgName, signals.at(i)->getName(), QStringLiteral("信号内部位重叠（起始位/长度与字节序不一致）"));
+        int unique = 0;
+        for (int w = 0; w < words; ++w) {
+            unique += qPopulationCount(maskI[w]);
         }
-        for (int j = i + 1; j < signals.size(); ++j) {
-            QList<Cell> setJ = signalCells(signals.at(j), msgLenBytes);
-            for (const Cell &c : setJ) {
-                if (uniqueI.count(c)) {
-                    addError(result, msgName, QString(),
-                             QStringLiteral("信号 \"%1\" 与 \"%2\" 位重叠").arg(signals.at(i)->getName(), signals.at(j)->getName()));
-                    break;
-                }
+        if (unique != inFrame[i]) {
+            addError(result, msgName, nameOf(i), QStringLiteral("信号内部位重叠（起始位/长度与字节序不一致）"));
+        }
+        for (int j = i + 1; j < count; ++j) {
+            const quint64 *maskJ = masks.constData() + j * words;
+            quint64 shared = 0;
+            for (int w = 0; w < words; ++w) {
+                shared |= maskI[w] & maskJ[w];
+            }
+            if (shared) {
+                addError(result, msgName, QString(),
+                         QStringLiteral("信号 \"%1\" 与 \"%2\" 位重叠").arg(nameOf(i), nameOf(j)));
             }
         }
     }
@@ -371,17 +365,21 @@ void validateMessageOverlap(const CanMessage *message, ValidationResult &result)
 
 ValidationResult validateMessages(const QList<CanMessage *> &messages)
 {
+    DBC_TRACE_SCOPE("validateMessages");
+    // Built per call from the list being validated, so the overlap checks never see stale geometry
+    const SignalColumns columns(messages);
     ValidationResult result;
-    for (CanMessage *msg : messages) {
+    for (int m = 0; m < messages.size(); ++m) {
+        const CanMessage *msg = messages.at(m);
         if (!msg) {
             continue;
         }
-        for (CanSignal *sig : msg->getSignals()) {
+        for (const CanSignal *sig : msg->getSignals()) {
             if (sig) {
                 validateSignalValues(msg, sig, result);
             }
         }
-        validateMessageOverlap(msg, result);
+        validateMessageOverlap(msg, columns, m, result);
     }
     return result;
 }
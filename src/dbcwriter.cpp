@@ -1,8 +1,11 @@
 #include "dbcwriter.h"
+#include "trace.h"
 
 #include <QFile>
 #include <QLocale>
+#include <QPair>
 #include <QTextStream>
+#include <QVector>
 #include <QtGlobal>
 
 #include <cmath>
@@ -120,12 +123,12 @@ int frameFormatIndex(const QString &frameFormat)
 
 QString canonicalFrameFormat(const CanMessage *message)
 {
-    const QString frameFormat = message->getFrameFormat();
+    const QString &frameFormat = message->getFrameFormat();
     if (!frameFormat.isEmpty()) {
         return frameFormat;
     }
 
-    const QString type = message->getMessageType();
+    const QString &type = message->getMessageType();
     const bool isCanFdType = type.contains("CANFD", Qt::CaseInsensitive) || type.contains("CAN FD", Qt::CaseInsensitive);
     if (isCanFdType) {
         return type.contains("Extended", Qt::CaseInsensitive) ? "ExtendedCAN_FD" : "StandardCAN_FD";
@@ -136,6 +139,80 @@ QString canonicalFrameFormat(const CanMessage *message)
     return "StandardCAN";
 }
 
+/** The attribute definitions and defaults every written file carries (Vector CANoe template). */
+AttributeStore builtinAttributes(bool isCanFd)
+{
+    AttributeStore store;
+    const auto define = [&store](const char *name, AttributeStore::Scope scope, AttributeStore::Type type,
+                                 double minimum = 0.0, double maximum = 0.0,
+                                 const QStringList &enumValues = QStringList()) {
+        AttributeStore::Definition definition;
+        definition.id = AttributeStore::nameId(QLatin1String(name));
+        definition.scope = scope;
+        definition.type = type;
+        definition.minimum = minimum;
+        definition.maximum = maximum;
+        definition.enumValues = enumValues;
+        store.define(definition);
+    };
+    const auto setDefault = [&store](const char *name, const AttributeValue &value) {
+        store.setDefault(AttributeStore::nameId(QLatin1String(name)), value);
+    };
+    const QStringList yesNo = {QStringLiteral("No"), QStringLiteral("Yes")};
+    const AttributeValue zero = AttributeValue::fromInteger(0);
+    const AttributeValue empty = AttributeValue::fromText(QString());
+
+    define("GenMsgCycleTime", AttributeStore::Message, AttributeStore::Int, 0, 65535);
+    define("GenMsgCycleTimeActive", AttributeStore::Message, AttributeStore::Int, 0, 65535);
+    define("GenMsgCycleTimeFast", AttributeStore::Message, AttributeStore::Int);
+    define("GenMsgDelayTime", AttributeStore::Message, AttributeStore::Int, 0, 65535);
+    define("GenMsgNrOfRepetition", AttributeStore::Message, AttributeStore::Int);
+    define("NmMessage", AttributeStore::Message, AttributeStore::Enum, 0, 0, yesNo);
+    define("DiagRequest", AttributeStore::Message, AttributeStore::Enum, 0, 0, yesNo);
+    define("DiagResponse", AttributeStore::Message, AttributeStore::Enum, 0, 0, yesNo);
+    define("GenMsgSendType", AttributeStore::Message, AttributeStore::Enum, 0, 0, kMessageSendTypes);
+    define("VFrameFormat", AttributeStore::Message, AttributeStore::Enum, 0, 0, kFrameFormats);
+    define("GenSigStartDelayTime", AttributeStore::Signal, AttributeStore::Int, 0, 100000);
+    define("GenSigILSupport", AttributeStore::Signal, AttributeStore::Enum, 0, 0, yesNo);
+    define("GenSigInactiveValue", AttributeStore::Signal, AttributeStore::Hex);
+    define("GenSigInvalidValue", AttributeStore::Signal, AttributeStore::Hex);
+    define("GenSigSNA", AttributeStore::Signal, AttributeStore::String);
+    define("GenSigSendType", AttributeStore::Signal, AttributeStore::Enum, 0, 0, kSignalSendTypes);
+    define("GenSigStartValue", AttributeStore::Signal, AttributeStore::Float, 0, 100000000000.0);
+    define("BusType", AttributeStore::Network, AttributeStore::String);
+    define("ProtocolType", AttributeStore::Network, AttributeStore::String);
+    define("Manufacturer", AttributeStore::Network, AttributeStore::String);
+    define("DBName", AttributeStore::Network, AttributeStore::String);
+    define("DocumentTitle", AttributeStore::Network, AttributeStore::String);
+    define("ChangeHistory", AttributeStore::Network, AttributeStore::String);
+    define("Baudrate", AttributeStore::Network, AttributeStore::Int, 0, 1000000);
+    define("NmType", AttributeStore::Network, AttributeStore::String);
+    define("VersionYear", AttributeStore::Network, AttributeStore::Int, 2010, 2999);
+    define("NmMessageCount", AttributeStore::Network, AttributeStore::Int, 0, 255);
+    define("NodeLayerModules", AttributeStore::Node, AttributeStore::String);
+
+    for (const char *name : {"GenMsgCycleTime", "GenMsgCycleTimeActive", "GenMsgCycleTimeFast", "GenMsgDelayTime",
+                             "GenMsgNrOfRepetition", "GenSigStartDelayTime", "GenSigInactiveValue", "GenSigInvalidValue"}) {
+        setDefault(name, zero);
+    }
+    setDefault("GenMsgSendType", AttributeValue::fromInteger(kMessageSendTypes.indexOf(QStringLiteral("Cycle"))));
+    setDefault("VFrameFormat", AttributeValue::fromInteger(
+        kFrameFormats.indexOf(isCanFd ? QStringLiteral("StandardCAN_FD") : QStringLiteral("StandardCAN"))));
+    setDefault("GenSigILSupport", AttributeValue::fromInteger(1));
+    setDefault("GenSigSendType", AttributeValue::fromInteger(kSignalSendTypes.indexOf(QStringLiteral("NoSigSendType"))));
+    setDefault("GenSigStartValue", AttributeValue::fromReal(0.0));
+    for (const char *name : {"GenSigSNA", "BusType", "Manufacturer", "DBName", "DocumentTitle", "ChangeHistory",
+                             "NodeLayerModules"}) {
+        setDefault(name, empty);
+    }
+    setDefault("ProtocolType", AttributeValue::fromText(QStringLiteral("CAN")));
+    setDefault("Baudrate", AttributeValue::fromInteger(500000));
+    setDefault("NmType", AttributeValue::fromText(QStringLiteral("OSEK")));
+    setDefault("VersionYear", AttributeValue::fromInteger(2019));
+    setDefault("NmMessageCount", AttributeValue::fromInteger(128));
+    return store;
+}
+
 QString fallbackNode(const QStringList &nodes)
 {
     return nodes.isEmpty() ? QStringLiteral("Vector__XXX") : nodes.first();
@@ -168,8 +245,10 @@ bool DbcWriter::write(const QString &filePath,
                       const QString &documentTitle,
                       const QList<DbcExcelConverter::ChangeHistoryEntry> &changeHistory,
                       const GlobalValueTables &globalValueTables,
+                      const AttributeStore &attributes,
                       QString *error)
 {
+    DBC_TRACE_SCOPE("DbcWriter::write");
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
         if (error) {
@@ -248,7 +327,7 @@ bool DbcWriter::write(const QString &filePath,
         out << "\nBO_ " << message->getId() << ' ' << message->getName() << ": "
             << message->getLength() << ' ' << transmitter << "\n";
 
-        const QStringList msgReceivers = message->getReceivers();
+        const QStringList &msgReceivers = message->getReceivers();
         const QString receiverListForSignal = msgReceivers.isEmpty()
             ? transmitter
             : joinReceivers(msgReceivers, QString());
@@ -276,7 +355,7 @@ bool DbcWriter::write(const QString &filePath,
 
     for (CanMessage *message : messages) {
         if (!message) continue;
-        const QStringList msgReceivers = message->getReceivers();
+        const QStringList &msgReceivers = message->getReceivers();
         if (!msgReceivers.isEmpty()) {
             out << "BO_TX_BU_ " << message->getId() << " : " << joinReceivers(msgReceivers, QString()) << ";\n";
         }
@@ -304,76 +383,41 @@ bool DbcWriter::write(const QString &filePath,
 
     out << '\n';
 
-    out << "BA_DEF_ BO_ \"GenMsgCycleTime\" INT 0 65535;\n";
-    out << "BA_DEF_ BO_ \"GenMsgCycleTimeActive\" INT 0 65535;\n";
-    out << "BA_DEF_ BO_ \"GenMsgCycleTimeFast\" INT 0 0;\n";
-    out << "BA_DEF_ BO_ \"GenMsgDelayTime\" INT 0 65535;\n";
-    out << "BA_DEF_ BO_ \"GenMsgNrOfRepetition\" INT 0 0;\n";
-    out << "BA_DEF_ BO_ \"NmMessage\" ENUM \"No\",\"Yes\";\n";
-    out << "BA_DEF_ BO_ \"DiagRequest\" ENUM \"No\",\"Yes\";\n";
-    out << "BA_DEF_ BO_ \"DiagResponse\" ENUM \"No\",\"Yes\";\n";
-    out << "BA_DEF_ BO_ \"GenMsgSendType\" ENUM ";
-    for (int i = 0; i < kMessageSendTypes.size(); ++i) {
-        out << '"' << kMessageSendTypes.at(i) << '"';
-        if (i != kMessageSendTypes.size() - 1) out << ',';
+    // Built-in definitions, with the database's own definitions (other than the ones backed by
+    // model fields) replacing a built-in of the same name or appended in database order.
+    const bool isCanFd = busType.contains(QLatin1String("FD"), Qt::CaseInsensitive);
+    AttributeStore definitions = builtinAttributes(isCanFd);
+    QVector<QPair<int, QString>> scopeAttributes[5]; // database attributes per AttributeStore::Scope
+    for (const AttributeStore::Definition &definition : attributes.definitions()) {
+        if (!AttributeStore::isModelAttribute(definition.id)) {
+            definitions.define(definition);
+            scopeAttributes[definition.scope].append(qMakePair(definition.id, definition.name()));
+        }
     }
-    out << ";\n";
-    out << "BA_DEF_ BO_ \"VFrameFormat\" ENUM ";
-    for (int i = 0; i < kFrameFormats.size(); ++i) {
-        out << '"' << kFrameFormats.at(i) << '"';
-        if (i != kFrameFormats.size() - 1) out << ',';
+    for (const AttributeStore::Definition &definition : definitions.definitions()) {
+        out << "BA_DEF_ " << definitions.formatDefinition(definition) << ";\n";
     }
-    out << ";\n";
-    out << "BA_DEF_ SG_ \"GenSigStartDelayTime\" INT 0 100000;\n";
-    out << "BA_DEF_ SG_ \"GenSigILSupport\" ENUM \"No\",\"Yes\";\n";
-    out << "BA_DEF_ SG_ \"GenSigInactiveValue\" HEX 0 0;\n";
-    out << "BA_DEF_ SG_ \"GenSigInvalidValue\" HEX 0 0;\n";
-    out << "BA_DEF_ SG_ \"GenSigSNA\" STRING ;\n";
-    out << "BA_DEF_ SG_ \"GenSigSendType\" ENUM ";
-    for (int i = 0; i < kSignalSendTypes.size(); ++i) {
-        out << '"' << kSignalSendTypes.at(i) << '"';
-        if (i != kSignalSendTypes.size() - 1) out << ',';
+    for (const AttributeStore::Definition &definition : definitions.definitions()) {
+        if (definition.hasDefault) {
+            out << "BA_DEF_DEF_ " << definitions.formatDefault(definition) << ";\n";
+        }
     }
-    out << ";\n";
-    out << "BA_DEF_ SG_ \"GenSigStartValue\" FLOAT 0 100000000000;\n";
-    out << "BA_DEF_ \"BusType\" STRING ;\n";
-    out << "BA_DEF_ \"ProtocolType\" STRING ;\n";
-    out << "BA_DEF_ \"Manufacturer\" STRING ;\n";
-    out << "BA_DEF_ \"DBName\" STRING ;\n";
-    out << "BA_DEF_ \"DocumentTitle\" STRING ;\n";
-    out << "BA_DEF_ \"ChangeHistory\" STRING ;\n";
-    out << "BA_DEF_ \"Baudrate\" INT 0 1000000;\n";
-    out << "BA_DEF_ \"NmType\" STRING ;\n";
-    out << "BA_DEF_ \"VersionYear\" INT 2010 2999;\n";
-    out << "BA_DEF_ \"NmMessageCount\" INT 0 255;\n";
-    out << "BA_DEF_ BU_ \"NodeLayerModules\" STRING ;\n";
-
-    out << "BA_DEF_DEF_ \"GenMsgCycleTime\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenMsgCycleTimeActive\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenMsgCycleTimeFast\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenMsgDelayTime\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenMsgNrOfRepetition\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenMsgSendType\" \"Cycle\";\n";
-    const bool isCanFd = busType.contains(QLatin1String("FD"), Qt::CaseInsensitive);
-    out << "BA_DEF_DEF_ \"VFrameFormat\" \"" << (isCanFd ? "StandardCAN_FD" : "StandardCAN") << "\";\n";
-    out << "BA_DEF_DEF_ \"GenSigStartDelayTime\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenSigILSupport\" \"Yes\";\n";
-    out << "BA_DEF_DEF_ \"GenSigSNA\" \"\";\n";
-    out << "BA_DEF_DEF_ \"GenSigSendType\" \"NoSigSendType\";\n";
-    out << "BA_DEF_DEF_ \"GenSigStartValue\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenSigInactiveValue\" 0;\n";
-    out << "BA_DEF_DEF_ \"GenSigInvalidValue\" 0;\n";
-    out << "BA_DEF_DEF_ \"BusType\" \"\";\n";
-    out << "BA_DEF_DEF_ \"ProtocolType\" \"CAN\";\n";
-    out << "BA_DEF_DEF_ \"Manufacturer\" \"\";\n";
-    out << "BA_DEF_DEF_ \"DBName\" \"\";\n";
-    out << "BA_DEF_DEF_ \"DocumentTitle\" \"\";\n";
-    out << "BA_DEF_DEF_ \"ChangeHistory\" \"\";\n";
-    out << "BA_DEF_DEF_ \"Baudrate\" 500000;\n";
-    out << "BA_DEF_DEF_ \"NmType\" \"OSEK\";\n";
-    out << "BA_DEF_DEF_ \"VersionYear\" 2019;\n";
-    out << "BA_DEF_DEF_ \"NmMessageCount\" 128;\n";
-    out << "BA_DEF_DEF_ \"NodeLayerModules\" \"\";\n\n";
+    out << '\n';
+
+    const auto fromDatabase = [&attributes](const char *name) {
+        return attributes.contains(AttributeStore::nameId(QLatin1String(name)));
+    };
+    const auto writeValues = [&](AttributeStore::Scope scope, const AttributeValues &values, const QString &object) {
+        if (values.isEmpty()) {
+            return;
+        }
+        for (const auto &attribute : scopeAttributes[scope]) {
+            if (const AttributeValue *value = values.find(attribute.first)) {
+                out << "BA_ \"" << attribute.second << "\" " << object
+                    << attributes.formatValue(attribute.first, *value) << ";\n";
+            }
+        }
+    };
 
     out << "BA_ \"BusType\" \"" << escape(busType.isEmpty() ? "CAN" : busType) << "\";\n";
     if (!documentTitle.isEmpty()) {
@@ -395,14 +439,20 @@ bool DbcWriter::write(const QString &filePath,
         encoded.replace(QLatin1Char('\n'), QLatin1String("\\n"));
         out << "BA_ \"ChangeHistory\" \"" << escape(encoded) << "\";\n";
     }
-    out << "BA_ \"ProtocolType\" \"CAN FD\";\n";
-    out << "BA_ \"Manufacturer\" \"JX\";\n";
-    out << "BA_ \"DBName\" \"ADCANFD\";\n";
-    out << "BA_ \"Baudrate\" 500000;\n";
-    out << "BA_ \"NmType\" \"AUTOSAR\";\n";
-    out << "BA_ \"NmMessageCount\" 255;\n";
+    // Template network/node values, unless the database defines the attribute itself
+    if (!fromDatabase("ProtocolType")) out << "BA_ \"ProtocolType\" \"CAN FD\";\n";
+    if (!fromDatabase("Manufacturer")) out << "BA_ \"Manufacturer\" \"JX\";\n";
+    if (!fromDatabase("DBName")) out << "BA_ \"DBName\" \"ADCANFD\";\n";
+    if (!fromDatabase("Baudrate")) out << "BA_ \"Baudrate\" 500000;\n";
+    if (!fromDatabase("NmType")) out << "BA_ \"NmType\" \"AUTOSAR\";\n";
+    if (!fromDatabase("NmMessageCount")) out << "BA_ \"NmMessageCount\" 255;\n";
+    writeValues(AttributeStore::Network, attributes.networkValues(), QString());
+    const bool templateNodeLayer = !fromDatabase("NodeLayerModules");
     for (const QString &node : buNodes) {
-        out << "BA_ \"NodeLayerModules\" BU_ " << node << " \"CANoeILNLVector.dll\";\n";
+        if (templateNodeLayer) {
+            out << "BA_ \"NodeLayerModules\" BU_ " << node << " \"CANoeILNLVector.dll\";\n";
+        }
+        writeValues(AttributeStore::Node, attributes.nodeValues().value(node), QStringLiteral("BU_ %1 ").arg(node));
     }
 
     for (CanMessage *message : messages) {
@@ -437,17 +487,20 @@ bool DbcWriter::write(const QString &filePath,
             << messageSendTypeIndex(message->getSendType()) << ";\n";
 
         const quint32 msgId = message->getId();
-        if (msgId == 1186 || msgId == 1187 || msgId == 1188 || msgId == 1152 || msgId == 1189 || msgId == 1190) {
+        if (!fromDatabase("NmMessage")
+            && (msgId == 1186 || msgId == 1187 || msgId == 1188 || msgId == 1152 || msgId == 1189 || msgId == 1190)) {
             out << "BA_ \"NmMessage\" BO_ " << msgId << " 1;\n";
         }
-        if (msgId == 1842) {
+        if (msgId == 1842 && !fromDatabase("DiagRequest")) {
             out << "BA_ \"DiagRequest\" BO_ " << msgId << " 1;\n";
         }
-        if (msgId == 1850) {
+        if (msgId == 1850 && !fromDatabase("DiagResponse")) {
             out << "BA_ \"DiagResponse\" BO_ " << msgId << " 1;\n";
         }
+        writeValues(AttributeStore::Message, message->getAttributes(), QStringLiteral("BO_ %1 ").arg(msgId));
     }
 
+    const bool templateInactiveValue = !fromDatabase("GenSigInactiveValue");
     for (CanMessage *message : messages) {
         if (!message) {
             continue;
@@ -462,12 +515,16 @@ bool DbcWriter::write(const QString &filePath,
             out << "BA_ \"GenSigStartValue\" SG_ " << message->getId() << ' ' << signal->getName() << ' '
                 << formatDouble(signal->getInitialValue()) << ";\n";
 
-            out << "BA_ \"GenSigInactiveValue\" SG_ " << message->getId() << ' ' << signal->getName() << " 0;\n";
+            if (templateInactiveValue) {
+                out << "BA_ \"GenSigInactiveValue\" SG_ " << message->getId() << ' ' << signal->getName() << " 0;\n";
+            }
 
             if (!signal->getInactiveValueHex().isEmpty()) {
                 out << "BA_ \"GenSigSNA\" SG_ " << message->getId() << ' ' << signal->getName() << " \""
                     << escape(signal->getInactiveValueHex()) << "\";\n";
             }
+            writeValues(AttributeStore::Signal, signal->getAttributes(),
+                        QStringLiteral("SG_ %1 %2 ").arg(message->getId()).arg(signal->getName()));
         }
     }
 
@@ -6,6 +6,7 @@
 #include <QList>
 #include <QPair>
 
+#include "attributestore.h"
 #include "canmessage.h"
 #include "dbcexcelconverter.h"
 
@@ -15,6 +16,11 @@ public:
     /** Global value tables (VAL_TABLE_): list of (name, value->description map). */
     using GlobalValueTables = QList<QPair<QString, QMap<int, QString>>>;
 
+    /**
+     * Writes the built-in attribute template plus every definition, default and value of
+     * attributes (see DbcParser::attributes()); a database definition replaces the template
+     * one of the same name, except for attributes regenerated from model fields.
+     */
     static bool write(const QString &filePath,
                       const QString &version,
                       const QString &busType,
@@ -24,6 +30,7 @@ public:
                       const QString &documentTitle = QString(),
                       const QList<DbcExcelConverter::ChangeHistoryEntry> &changeHistory = QList<DbcExcelConverter::ChangeHistoryEntry>(),
                       const GlobalValueTables &globalValueTables = GlobalValueTables(),
+                      const AttributeStore &attributes = AttributeStore(),
                       QString *error = nullptr);
 };
 
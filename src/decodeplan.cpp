@@ -0,0 +1,201 @@
+#include "decodeplan.h"
+#include "canmessage.h"
+#include "cansignal.h"
+#include "signalcodec.h"
+
+#include <QVarLengthArray>
+#include <QtEndian>
+
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+template <int Bytes> struct Word;
+template <> struct Word<1> { using Type = quint8; };
+template <> struct Word<2> { using Type = quint16; };
+template <> struct Word<4> { using Type = quint32; };
+template <> struct Word<8> { using Type = quint64; };
+
+template <int Bytes, bool BigEndian>
+inline quint64 loadWord(const uchar *p)
+{
+    using Type = typename Word<Bytes>::Type;
+    if constexpr (Bytes == 1) {
+        return *p;
+    } else if constexpr (BigEndian) {
+        return qFromBigEndian<Type>(p);
+    } else {
+        return qFromLittleEndian<Type>(p);
+    }
+}
+
+template <int Bytes, bool BigEndian, bool Signed, bool Aligned>
+quint64 windowKernel(const uchar *data, const DecodePlan::Slot &slot, const int *)
+{
+    const quint64 word = loadWord<Bytes, BigEndian>(data + slot.byte);
+    if constexpr (Aligned) {
+        if constexpr (Signed) {
+            using SignedType = std::make_signed_t<typename Word<Bytes>::Type>;
+            return quint64(qint64(SignedType(word)));
+        } else {
+            return word;
+        }
+    } else {
+        const quint64 raw = (word >> slot.shift) & slot.mask;
+        if constexpr (Signed) {
+            return (raw ^ slot.sign) - slot.sign;
+        } else {
+            return raw;
+        }
+    }
+}
+
+quint64 genericKernel(const uchar *data, const DecodePlan::Slot &slot, const int *positions)
+{
+    const int *bits = positions + slot.firstPosition;
+    quint64 raw = 0;
+    for (int i = 0; i < slot.length; ++i) {
+        const int bit = bits[i];
+        if (bit >= 0 && (data[bit >> 3] >> (bit & 7)) & 1) {
+            raw |= quint64(1) << i;
+        }
+    }
+    return (raw ^ slot.sign) - slot.sign;
+}
+
+template <int Bytes, bool BigEndian>
+DecodePlan::Kernel pickKernel(bool isSigned, bool aligned)
+{
+    if (aligned) {
+        return isSigned ? &windowKernel<Bytes, BigEndian, true, true> : &windowKernel<Bytes, BigEndian, false, true>;
+    }
+    return isSigned ? &windowKernel<Bytes, BigEndian, true, false> : &windowKernel<Bytes, BigEndian, false, false>;
+}
+
+template <int Bytes>
+DecodePlan::Kernel pickKernel(bool bigEndian, bool isSigned, bool aligned)
+{
+    return bigEndian ? pickKernel<Bytes, true>(isSigned, aligned) : pickKernel<Bytes, false>(isSigned, aligned);
+}
+
+DecodePlan::Kernel selectKernel(int bytes, bool bigEndian, bool isSigned, bool aligned)
+{
+    switch (bytes) {
+    case 1: return pickKernel<1>(bigEndian, isSigned, aligned);
+    case 2: return pickKernel<2>(bigEndian, isSigned, aligned);
+    case 4: return pickKernel<4>(bigEndian, isSigned, aligned);
+    case 8: return pickKernel<8>(bigEndian, isSigned, aligned);
+    }
+    return nullptr;
+}
+
+/** Finds a 1/2/4/8-byte load window holding all bits of the signal; false if none fits the frame. */
+bool fitWindow(const QVector<int> &positions, int startBit, bool motorola, int frameBytes, DecodePlan::Slot *slot,
+               int *windowBytes)
+{
+    for (int bit : positions) {
+        if (bit < 0 || bit >= frameBytes * 8) {
+            return false;
+        }
+    }
+    const int lsb = positions.first();
+    // Intel bits run upwards from startBit; Motorola bits run from the MSB byte to the LSB byte.
+    const int firstByte = motorola ? startBit / 8 : lsb / 8;
+    const int lastByte = motorola ? lsb / 8 : positions.last() / 8;
+    const int span = lastByte - firstByte + 1;
+    for (int bytes : {1, 2, 4, 8}) {
+        if (bytes < span || bytes > frameBytes) {
+            continue;
+        }
+        const int base = qMin(firstByte, frameBytes - bytes); // slide back when the window would overrun the frame
+        const int shift = motorola ? (base + bytes - 1 - lsb / 8) * 8 + lsb % 8 : (firstByte - base) * 8 + lsb % 8;
+        if (shift + positions.size() > bytes * 8) {
+            continue;
+        }
+        slot->byte = base;
+        slot->shift = shift;
+        *windowBytes = bytes;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+DecodePlan::DecodePlan(const CanMessage &message, Mode mode)
+    : DecodePlan(message.getSignals(), message.getLength(), mode)
+{
+}
+
+DecodePlan::DecodePlan(const QList<CanSignal *> &signalList, int frameBytes, Mode mode)
+    : m_frameBytes(qBound(0, frameBytes, kMaxFrameBytes))
+{
+    m_slots.reserve(signalList.size());
+    for (const CanSignal *signal : signalList) {
+        Slot slot;
+        slot.isSigned = signal->isSigned();
+        slot.factor = signal->getFactor();
+        slot.offset = signal->getOffset();
+
+        const bool motorola = signal->getByteOrder() == 0;
+        const QVector<int> positions = SignalCodec::bitPositions(*signal);
+        slot.length = positions.size();
+        slot.mask = slot.length >= 64 ? ~quint64(0) : (quint64(1) << slot.length) - 1;
+        slot.sign = slot.isSigned && slot.length > 0 && slot.length < 64 ? quint64(1) << (slot.length - 1) : 0;
+
+        int windowBytes = 0;
+        if (mode == Specialized && !positions.isEmpty()
+            && fitWindow(positions, signal->getStartBit(), motorola, m_frameBytes, &slot, &windowBytes)) {
+            const bool aligned = slot.shift == 0 && slot.length == windowBytes * 8;
+            slot.kind = aligned ? AlignedKernel : WindowKernel;
+            slot.kernel = selectKernel(windowBytes, motorola, slot.isSigned, aligned);
+        } else {
+            slot.kind = GenericKernel;
+            slot.kernel = &genericKernel;
+            slot.firstPosition = m_positions.size();
+            for (int bit : positions) {
+                m_positions.append(bit >= 0 && bit < m_frameBytes * 8 ? bit : -1);
+            }
+        }
+        m_slots.append(slot);
+    }
+}
+
+int DecodePlan::countOf(KernelKind kind) const
+{
+    int count = 0;
+    for (const Slot &slot : m_slots) {
+        count += slot.kind == kind ? 1 : 0;
+    }
+    return count;
+}
+
+void DecodePlan::decodeRaw(const uchar *data, int size, quint64 *out) const
+{
+    const uchar *frame = data;
+    uchar padded[kMaxFrameBytes];
+    if (size < m_frameBytes) {
+        std::memset(padded, 0, sizeof(padded));
+        if (size > 0) {
+            std::memcpy(padded, data, size);
+        }
+        frame = padded;
+    }
+    const int *positions = m_positions.constData();
+    for (int i = 0; i < m_slots.size(); ++i) {
+        const Slot &slot = m_slots.at(i);
+        out[i] = slot.kernel(frame, slot, positions);
+    }
+}
+
+void DecodePlan::decodePhysical(const uchar *data, int size, double *out) const
+{
+    QVarLengthArray<quint64, 64> raw(m_slots.size());
+    decodeRaw(data, size, raw.data());
+    for (int i = 0; i < m_slots.size(); ++i) {
+        const Slot &slot = m_slots.at(i);
+        const double value = slot.isSigned ? double(qint64(raw[i])) : double(raw[i]);
+        out[i] = value * slot.factor + slot.offset;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef DECODEPLAN_H
+#define DECODEPLAN_H
+
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+class CanMessage;
+class CanSignal;
+
+/**
+ * Precompiled decoder for the signals of one message. Building the plan maps each signal onto
+ * a template-instantiated kernel: byte-aligned 8/16/32/64-bit signals become a single
+ * little/big-endian load, signals that fit in one 1/2/4/8-byte window (nibble-aligned
+ * Motorola, odd Intel offsets, ...) a load plus shift and mask. Everything else falls back to
+ * a bit walk over positions precomputed at build time. Results match SignalCodec.
+ */
+class DecodePlan
+{
+public:
+    enum Mode
+    {
+        Specialized,
+        GenericOnly     // every signal uses the bit-walk kernel (benchmark baseline)
+    };
+
+    enum KernelKind
+    {
+        AlignedKernel,  // whole bytes, one load
+        WindowKernel,   // one load, shift and mask
+        GenericKernel   // bit walk
+    };
+
+    static const int kMaxFrameBytes = 64;
+
+    struct Slot;
+    using Kernel = quint64 (*)(const uchar *data, const Slot &slot, const int *positions);
+
+    struct Slot
+    {
+        Kernel kernel = nullptr;
+        KernelKind kind = GenericKernel;
+        int byte = 0;           // first byte of the load window
+        int shift = 0;          // position of the raw LSB inside the window
+        int length = 0;
+        quint64 mask = 0;
+        quint64 sign = 0;       // sign bit for signed signals, 0 otherwise
+        int firstPosition = 0;  // generic kernel: offset into the position table
+        bool isSigned = false;
+        double factor = 1.0;
+        double offset = 0.0;
+    };
+
+    DecodePlan() = default;
+    explicit DecodePlan(const CanMessage &message, Mode mode = Specialized);
+    DecodePlan(const QList<CanSignal *> &signalList, int frameBytes, Mode mode = Specialized);
+
+    int size() const { return m_slots.size(); }
+    int frameBytes() const { return m_frameBytes; }
+    KernelKind kernelKind(int index) const { return m_slots.at(index).kind; }
+    int countOf(KernelKind kind) const;
+
+    /**
+     * Raw values in signal order, sign-extended to 64 bits for signed signals. Payloads shorter
+     * than the frame read as zero-padded; signals with an invalid length decode as 0.
+     */
+    void decodeRaw(const uchar *data, int size, quint64 *out) const;
+    void decodePhysical(const uchar *data, int size, double *out) const;
+
+private:
+    QVector<Slot> m_slots;
+    QVector<int> m_positions;
+    int m_frameBytes = 0;
+};
+
+#endif // DECODEPLAN_H
@@ -0,0 +1,138 @@
+#include "editcommands.h"
+
+#include "canmessage.h"
+#include "cansignal.h"
+#include "messagetreemodel.h"
+
+#include <QObject>
+
+namespace {
+void deleteMessageWithSignals(CanMessage *message)
+{
+    for (CanSignal *signal : message->getSignals()) {
+        delete signal;
+    }
+    delete message;
+}
+} // namespace
+
+void notifyFieldChanged(MessageTreeModel *model, CanMessage *message, CanMessage *)
+{
+    model->messageChanged(message);
+}
+
+void notifyFieldChanged(MessageTreeModel *model, CanMessage *message, CanSignal *signal)
+{
+    model->signalChanged(message, signal);
+}
+
+AddMessageCommand::AddMessageCommand(MessageTreeModel *model, CanMessage *message, const QString &text,
+                                     QUndoCommand *parent)
+    : QUndoCommand(text, parent)
+    , m_model(model)
+    , m_message(message)
+{
+}
+
+AddMessageCommand::~AddMessageCommand()
+{
+    if (!m_inserted) {
+        deleteMessageWithSignals(m_message);
+    }
+}
+
+void AddMessageCommand::undo()
+{
+    m_row = m_model->takeMessage(m_message);
+    m_inserted = false;
+}
+
+void AddMessageCommand::redo()
+{
+    m_model->insertMessage(m_row, m_message);
+    m_inserted = true;
+}
+
+RemoveMessageCommand::RemoveMessageCommand(MessageTreeModel *model, CanMessage *message, QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , m_model(model)
+    , m_message(message)
+{
+    setText(QObject::tr("Delete message %1").arg(message->getName()));
+}
+
+RemoveMessageCommand::~RemoveMessageCommand()
+{
+    if (m_removed) {
+        deleteMessageWithSignals(m_message);
+    }
+}
+
+void RemoveMessageCommand::undo()
+{
+    m_model->insertMessage(m_row, m_message);
+    m_removed = false;
+}
+
+void RemoveMessageCommand::redo()
+{
+    m_row = m_model->takeMessage(m_message);
+    m_removed = true;
+}
+
+AddSignalCommand::AddSignalCommand(MessageTreeModel *model, CanMessage *message, CanSignal *signal,
+                                   const QString &text, QUndoCommand *parent)
+    : QUndoCommand(text, parent)
+    , m_model(model)
+    , m_message(message)
+    , m_signal(signal)
+{
+}
+
+AddSignalCommand::~AddSignalCommand()
+{
+    if (!m_inserted) {
+        delete m_signal;
+    }
+}
+
+void AddSignalCommand::undo()
+{
+    m_row = m_model->removeSignal(m_message, m_signal);
+    m_inserted = false;
+}
+
+void AddSignalCommand::redo()
+{
+    m_model->insertSignal(m_message, m_row, m_signal);
+    m_inserted = true;
+}
+
+RemoveSignalCommand::RemoveSignalCommand(MessageTreeModel *model, CanMessage *message, CanSignal *signal,
+                                         QUndoCommand *parent)
+    : QUndoCommand(parent)
+    , m_model(model)
+    , m_message(message)
+    , m_signal(signal)
+{
+    setText(QObject::tr("Delete signal %1").arg(signal->getName()));
+}
+
+RemoveSignalCommand::~RemoveSignalCommand()
+{
+    if (m_removed) {
+        delete m_signal;
+    }
+}
+
+void RemoveSignalCommand::undo()
+{
+    m_model->insertSignal(m_message, m_row, m_signal);
+    m_removed = false;
+}
+
+void RemoveSignalCommand::redo()
+{
+    m_row = m_model->removeSignal(m_message, m_signal);
+    m_removed = true;
+}
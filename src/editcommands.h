@@ -0,0 +1,134 @@
+#ifndef EDITCOMMANDS_H
+#define EDITCOMMANDS_H
+
+#include <QUndoCommand>
+
+#include <functional>
+
+class MessageTreeModel;
+class CanMessage;
+class CanSignal;
+
+/** Tells the model (and through it every view) that a field of message/signal changed. */
+void notifyFieldChanged(MessageTreeModel *model, CanMessage *message, CanMessage *);
+void notifyFieldChanged(MessageTreeModel *model, CanMessage *message, CanSignal *signal);
+
+/**
+ * Undoable edit of a single field. Only the field's before/after values are stored, so a
+ * command costs O(size of the field) no matter how large the database is.
+ */
+template <typename Object, typename Value>
+class SetFieldCommand : public QUndoCommand
+{
+public:
+    template <typename Arg>
+    SetFieldCommand(MessageTreeModel *model, CanMessage *message, Object *object,
+                    void (Object::*setter)(Arg), const Value &before, const Value &after,
+                    const QString &text, QUndoCommand *parent = nullptr)
+        : QUndoCommand(text, parent)
+        , m_model(model)
+        , m_message(message)
+        , m_object(object)
+        , m_setter([setter](Object *target, const Value &value) { (target->*setter)(value); })
+        , m_before(before)
+        , m_after(after)
+    {
+    }
+
+    void undo() override { apply(m_before); }
+    void redo() override { apply(m_after); }
+
+private:
+    void apply(const Value &value)
+    {
+        m_setter(m_object, value);
+        notifyFieldChanged(m_model, m_message, m_object);
+    }
+
+    MessageTreeModel *m_model;
+    CanMessage *m_message;
+    Object *m_object;
+    std::function<void(Object *, const Value &)> m_setter;
+    Value m_before;
+    Value m_after;
+};
+
+template <typename Value>
+using SetMessageFieldCommand = SetFieldCommand<CanMessage, Value>;
+template <typename Value>
+using SetSignalFieldCommand = SetFieldCommand<CanSignal, Value>;
+
+/** Inserts a message (new or copied); owns it while the insert is undone. */
+class AddMessageCommand : public QUndoCommand
+{
+public:
+    AddMessageCommand(MessageTreeModel *model, CanMessage *message, const QString &text,
+                      QUndoCommand *parent = nullptr);
+    ~AddMessageCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    MessageTreeModel *m_model;
+    CanMessage *m_message;
+    int m_row = -1;
+    bool m_inserted = false;
+};
+
+/** Detaches a message; owns it (and its signals) while the removal is applied. */
+class RemoveMessageCommand : public QUndoCommand
+{
+public:
+    RemoveMessageCommand(MessageTreeModel *model, CanMessage *message, QUndoCommand *parent = nullptr);
+    ~RemoveMessageCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    MessageTreeModel *m_model;
+    CanMessage *m_message;
+    int m_row = -1;
+    bool m_removed = false;
+};
+
+/** Appends a signal to a message; owns it while the insert is undone. */
+class AddSignalCommand : public QUndoCommand
+{
+public:
+    AddSignalCommand(MessageTreeModel *model, CanMessage *message, CanSignal *signal,
+                     const QString &text, QUndoCommand *parent = nullptr);
+    ~AddSignalCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    MessageTreeModel *m_model;
+    CanMessage *m_message;
+    CanSignal *m_signal;
+    int m_row = -1;
+    bool m_inserted = false;
+};
+
+/** Detaches a signal from its message; owns it while the removal is applied. */
+class RemoveSignalCommand : public QUndoCommand
+{
+public:
+    RemoveSignalCommand(MessageTreeModel *model, CanMessage *message, CanSignal *signal,
+                        QUndoCommand *parent = nullptr);
+    ~RemoveSignalCommand() override;
+
+    void undo() override;
+    void redo() override;
+
+private:
+    MessageTreeModel *m_model;
+    CanMessage *m_message;
+    CanSignal *m_signal;
+    int m_row = -1;
+    bool m_removed = false;
+};
+
+#endif // EDITCOMMANDS_H
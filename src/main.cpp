@@ -1,12 +1,31 @@
 #include <QApplication>
 #include <QCoreApplication>
 #include <QString>
+#include <QStringList>
 #include "mainwindow.h"
+#include "cli.h"
 #include "dbcparser.h"
 #include "dbcvalidator.h"
+#include "trace.h"
 
 int main(int argc, char *argv[])
 {
+    // 性能追踪：DBC_TRACE=<file.json> 或 --trace <file.json>（须为第一个参数），退出时写出 Chrome trace_event JSON
+    Trace::initFromEnvironment();
+    if (argc >= 3 && qstrcmp(argv[1], "--trace") == 0) {
+        Trace::startSession(QString::fromLocal8Bit(argv[2]));
+        for (int i = 3; i <= argc; ++i) {
+            argv[i - 2] = argv[i]; // drop the option (argv[argc] is the terminating null)
+        }
+        argc -= 2;
+    }
+
+    // 批处理子命令：convert / validate / stats / diff / merge / report / codegen（无需 GUI，可在无显示的构建机上运行）
+    if (argc >= 2 && CommandLine::isCommand(QString::fromLocal8Bit(argv[1]))) {
+        QCoreApplication app(argc, argv);
+        return CommandLine::run(app.arguments().mid(1));
+    }
+
     // 命令行校验模式：传入一个 .dbc 文件时，仅解析并执行重叠校验后打印结果并退出（无需 GUI）
     if (argc >= 2) {
         const QString path = QString::fromLocal8Bit(argv[1]);
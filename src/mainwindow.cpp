@@ -1,12 +1,25 @@
 #include "mainwindow.h"
 #include "signallayoutwidget.h"
 #include "dbcvalidator.h"
+#include "messagetreemodel.h"
+#include "signaltablemodel.h"
+#include "messagefilterproxymodel.h"
+#include "dbcloader.h"
+#include "editcommands.h"
+#include "snapshotcomparedialog.h"
+#include "parsereportdialog.h"
+#include "trace.h"
+#include <QActionGroup>
 #include <QApplication>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QHeaderView>
+#include <QInputDialog>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QScreen>
+#include <QUndoStack>
 #include <QDebug>
 #include <QClipboard>
 
@@ -16,9 +29,24 @@
 #include <cmath>
 #include <limits>
 
+namespace {
+
+void deleteMessages(const QList<CanMessage *> &messages)
+{
+    for (CanMessage *message : messages) {
+        qDeleteAll(message->getSignals());
+        delete message;
+    }
+}
+
+} // namespace
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_dbcParser(new DbcParser())
+    , m_loader(new DbcLoader(this))
+    , m_compareLoader(new DbcLoader(this))
+    , m_undoStack(new QUndoStack(this))
     , m_currentMessage(nullptr)
     , m_currentSignal(nullptr)
     , m_currentDbcPath()
@@ -26,6 +54,9 @@ MainWindow::MainWindow(QWidget *parent)
     setupUI();
     setupMenuBar();
     setupStatusBar();
+
+    connect(m_loader, &DbcLoader::finished, this, &MainWindow::onLoadFinished);
+    connect(m_compareLoader, &DbcLoader::finished, this, &MainWindow::onCompareLoadFinished);
     
     setWindowTitle("DBC Viewer");
     setMinimumSize(1000, 700);
@@ -65,30 +96,75 @@ void MainWindow::setupUI()
     m_messageGroup = new QGroupBox("CAN Messages", this);
     QVBoxLayout *messageLayout = new QVBoxLayout(m_messageGroup);
     
-    m_messageTree = new QTreeWidget(this);
-    m_messageTree->setHeaderLabels(QStringList() << "ID" << "Name" << "Length" << "Transmitter" << "Cycle Time");
+    // 报文树：模型直接读取 DbcParser，信号子行在展开时才创建
+    m_messageModel = new MessageTreeModel(m_dbcParser, this);
+    m_messageModel->setUndoStack(m_undoStack);
+    m_messageProxy = new MessageFilterProxyModel(m_messageModel, this);
+
+    // 全局搜索：报文名/ID、信号名、描述、单位、接收节点、值表文本
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText(tr("搜索报文、信号、注释、值表..."));
+    m_searchEdit->setClearButtonEnabled(true);
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &MainWindow::applySearch);
+
+    m_messageTree = new QTreeView(this);
+    m_messageTree->setModel(m_messageProxy);
     m_messageTree->setAlternatingRowColors(true);
     m_messageTree->setRootIsDecorated(false);
+    m_messageTree->setUniformRowHeights(true);
     m_messageTree->setSortingEnabled(true);
     m_messageTree->sortByColumn(0, Qt::AscendingOrder);
     m_messageTree->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::SelectedClicked);
     m_messageTree->setContextMenuPolicy(Qt::CustomContextMenu);
     
-    connect(m_messageTree, &QTreeWidget::itemSelectionChanged, this, &MainWindow::onMessageSelectionChanged);
-    connect(m_messageTree, &QTreeWidget::itemChanged, this, &MainWindow::onMessageTreeItemChanged);
-    connect(m_messageTree, &QTreeWidget::customContextMenuRequested, this, &MainWindow::onMessageTreeContextMenuRequested);
+    connect(m_messageTree->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::onMessageSelectionChanged);
+    // 编辑、撤销和重做都经由模型通知，视图统一在这里刷新
+    connect(m_messageModel, &MessageTreeModel::messageUpdated, this, &MainWindow::onMessageUpdated);
+    connect(m_messageModel, &MessageTreeModel::signalUpdated, this, &MainWindow::onSignalUpdated);
+    connect(m_messageModel, &MessageTreeModel::signalListChanged, this, &MainWindow::onSignalListChanged);
+    connect(m_messageModel, &MessageTreeModel::messageAboutToBeRemoved, this, [this](CanMessage *message) {
+        if (message == m_currentMessage) {
+            clearViews();
+        }
+    });
+    connect(m_messageModel, &MessageTreeModel::editRejected, this, [this](const QString &reason) {
+        m_statusLabel->setText(reason);
+    });
+    connect(m_messageTree, &QTreeView::customContextMenuRequested, this, &MainWindow::onMessageTreeContextMenuRequested);
+
+    // 编辑后索引已增量更新，重新执行当前查询即可
+    auto refreshSearch = [this]() {
+        if (m_messageProxy->isSearchActive()) {
+            applySearch();
+        }
+    };
+    connect(m_messageModel, &MessageTreeModel::messageUpdated, this, refreshSearch);
+    connect(m_messageModel, &MessageTreeModel::signalUpdated, this, refreshSearch);
+    connect(m_messageModel, &MessageTreeModel::signalListChanged, this, refreshSearch);
+    connect(m_messageModel, &MessageTreeModel::modelReset, this, refreshSearch);
+    // 新增/删除报文同样要刷新；信号行的插入来自展开时的懒加载，不影响结果
+    auto refreshSearchOnRows = [refreshSearch](const QModelIndex &parent) {
+        if (!parent.isValid()) {
+            refreshSearch();
+        }
+    };
+    connect(m_messageModel, &MessageTreeModel::rowsInserted, this, refreshSearchOnRows);
+    connect(m_messageModel, &MessageTreeModel::rowsRemoved, this, refreshSearchOnRows);
     
+    messageLayout->addWidget(m_searchEdit);
     messageLayout->addWidget(m_messageTree);
     
     // Right panel - Signal table
     m_signalGroup = new QGroupBox("Signals", this);
     QVBoxLayout *signalLayout = new QVBoxLayout(m_signalGroup);
     
-    m_signalTable = new QTableWidget(this);
-    m_signalTable->setColumnCount(8);
-    m_signalTable->setHorizontalHeaderLabels(QStringList()
-        << "Name" << "Start Bit" << "Length" << "Factor" << "Offset"
-        << "Min" << "Max" << "Unit");
+    m_signalModel = new SignalTableModel(m_messageModel, this);
+    m_signalProxy = new QSortFilterProxyModel(this);
+    m_signalProxy->setSourceModel(m_signalModel);
+    m_signalProxy->setSortRole(SignalTableModel::SortRole);
+
+    m_signalTable = new QTableView(this);
+    m_signalTable->setModel(m_signalProxy);
     m_signalTable->setAlternatingRowColors(true);
     m_signalTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_signalTable->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::SelectedClicked);
@@ -96,10 +172,12 @@ void MainWindow::setupUI()
     m_signalTable->horizontalHeader()->setStretchLastSection(true);
     m_signalTable->horizontalHeader()->setSectionsClickable(true);
 
-    connect(m_signalTable, &QTableWidget::itemSelectionChanged, this, &MainWindow::onSignalSelectionChanged);
-    connect(m_signalTable, &QTableWidget::itemChanged, this, &MainWindow::onSignalCellChanged);
+    connect(m_signalTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::onSignalSelectionChanged);
+    connect(m_signalModel, &SignalTableModel::editRejected, this, [this](const QString &reason) {
+        m_statusLabel->setText(reason);
+    });
     connect(m_signalTable->horizontalHeader(), &QHeaderView::sectionClicked, this, &MainWindow::onSignalTableHeaderClicked);
-    connect(m_signalTable, &QTableWidget::customContextMenuRequested, this, &MainWindow::onSignalTableContextMenuRequested);
+    connect(m_signalTable, &QTableView::customContextMenuRequested, this, &MainWindow::onSignalTableContextMenuRequested);
     
     signalLayout->addWidget(m_signalTable);
     
@@ -168,6 +246,27 @@ void MainWindow::setupMenuBar()
     exportExcelSingleAction->setStatusTip("Export all messages in one data sheet");
     connect(exportExcelSingleAction, &QAction::triggered, this, &MainWindow::exportToExcelSingleSheet);
     exportExcelMenu->addAction(exportExcelSingleAction);
+    exportExcelMenu->addSeparator();
+
+    // 压缩级别：交互导出默认 Balanced，Store 用于快速往返
+    QMenu *compressionMenu = exportExcelMenu->addMenu(tr("&Compression"));
+    QActionGroup *compressionGroup = new QActionGroup(this);
+    const QList<QPair<QString, DbcExcelConverter::CompressionLevel>> compressionChoices = {
+        {tr("S&tore (no compression, fastest)"), DbcExcelConverter::CompressionStore},
+        {tr("&Fast"), DbcExcelConverter::CompressionFast},
+        {tr("&Balanced"), DbcExcelConverter::CompressionBalanced},
+        {tr("B&est (smallest file, slowest)"), DbcExcelConverter::CompressionBest},
+    };
+    for (const auto &choice : compressionChoices) {
+        QAction *action = compressionMenu->addAction(choice.first);
+        action->setCheckable(true);
+        action->setChecked(choice.second == m_excelCompression);
+        compressionGroup->addAction(action);
+        const DbcExcelConverter::CompressionLevel level = choice.second;
+        connect(action, &QAction::triggered, this, [this, level]() {
+            m_excelCompression = level;
+        });
+    }
 
     QAction *exportDbcAction = new QAction("Export to &DBC...", this);
     exportDbcAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_S));
@@ -185,37 +284,63 @@ void MainWindow::setupMenuBar()
     
     // Edit menu
     QMenu *editMenu = menuBar->addMenu(tr("&Edit"));
+    QAction *undoAction = m_undoStack->createUndoAction(this, tr("&Undo"));
+    undoAction->setShortcut(QKeySequence::Undo);
+    QAction *redoAction = m_undoStack->createRedoAction(this, tr("&Redo"));
+    redoAction->setShortcut(QKeySequence::Redo);
     QAction *saveAction = new QAction(tr("&Save"), this);
     saveAction->setShortcut(QKeySequence::Save);
     QAction *revertAction = new QAction(tr("&Revert to Last Save"), this);
-    revertAction->setShortcut(QKeySequence::Undo);
+    QAction *checkpointAction = new QAction(tr("Create &Checkpoint..."), this);
+    QAction *compareAction = new QAction(tr("Com&pare with Checkpoint..."), this);
+    QAction *compareFileAction = new QAction(tr("Compare with &File..."), this);
     QAction *addMsgAction = new QAction(tr("Add &Message"), this);
     QAction *delMsgAction = new QAction(tr("Delete Message"), this);
     QAction *addSigAction = new QAction(tr("Add &Signal"), this);
     QAction *delSigAction = new QAction(tr("Delete Signal"), this);
 
     connect(saveAction, &QAction::triggered, this, [this]() {
-        createSnapshotFromCurrent();
-        m_isDirty = false;
+        m_undoStack->setClean();
+        m_savedSnapshot = m_messageModel->snapshot();
         m_statusLabel->setText(tr("已保存当前修改"));
     });
-    connect(revertAction, &QAction::triggered, this, [this]() {
-        restoreSnapshotToCurrent();
+    connect(revertAction, &QAction::triggered, this, &MainWindow::revertToSaved);
+    connect(m_undoStack, &QUndoStack::cleanChanged, this, [this](bool clean) {
+        if (!clean) {
+            m_statusLabel->setText(tr("已修改（未保存）"));
+        }
     });
+    connect(checkpointAction, &QAction::triggered, this, &MainWindow::createCheckpoint);
+    connect(compareAction, &QAction::triggered, this, &MainWindow::compareWithCheckpoint);
+    connect(compareFileAction, &QAction::triggered, this, &MainWindow::compareWithFile);
     connect(addMsgAction, &QAction::triggered, this, &MainWindow::addMessage);
     connect(delMsgAction, &QAction::triggered, this, &MainWindow::deleteMessage);
     connect(addSigAction, &QAction::triggered, this, &MainWindow::addSignal);
     connect(delSigAction, &QAction::triggered, this, &MainWindow::deleteSignal);
 
+    editMenu->addAction(undoAction);
+    editMenu->addAction(redoAction);
+    editMenu->addSeparator();
     editMenu->addAction(saveAction);
     editMenu->addAction(revertAction);
     editMenu->addSeparator();
+    editMenu->addAction(checkpointAction);
+    editMenu->addAction(compareAction);
+    editMenu->addAction(compareFileAction);
+    editMenu->addSeparator();
     editMenu->addAction(addMsgAction);
     editMenu->addAction(delMsgAction);
     editMenu->addSeparator();
     editMenu->addAction(addSigAction);
     editMenu->addAction(delSigAction);
 
+    // View menu
+    QMenu *viewMenu = menuBar->addMenu(tr("&View"));
+    QAction *parseReportAction = new QAction(tr("Parse &Report..."), this);
+    parseReportAction->setStatusTip(tr("Per-keyword parse time and the lines that could not be imported"));
+    connect(parseReportAction, &QAction::triggered, this, &MainWindow::showParseReport);
+    viewMenu->addAction(parseReportAction);
+
     // Help menu
     QMenu *helpMenu = menuBar->addMenu("&Help");
     
@@ -252,47 +377,20 @@ void MainWindow::openFile()
         return;
     }
 
-    if (fileName.endsWith(".xlsx", Qt::CaseInsensitive)) {
-        DbcExcelConverter::ImportResult importResult;
-        QString errorMessage;
-        if (!DbcExcelConverter::importFromExcel(fileName, importResult, &errorMessage)) {
-            QMessageBox::critical(this, "Open Failed", errorMessage);
-            return;
-        }
-        m_dbcParser->loadFromExcelImport(importResult);
-        m_currentDbcPath = fileName;
-        m_fileLabel->setText(QString("File: %1").arg(QFileInfo(fileName).fileName()));
-        m_statusLabel->setText(QString("Loaded %1 messages").arg(m_dbcParser->getMessages().size()));
-        populateMessageTree();
-        clearViews();
-        showValidationErrorsIfAny();
-        createSnapshotFromCurrent();
-        m_isDirty = false;
-    } else {
-        loadDbcFile(fileName);
-    }
+    loadFile(fileName);
 }
 
 void MainWindow::exportToExcelByEcu()
 {
-    if (m_savedMessages.isEmpty()) {
+    const DbcSnapshot &saved = m_savedSnapshot;
+    if (saved.messages.isEmpty()) {
         QMessageBox::warning(this, "Export", "Please load a DBC file before exporting to Excel.");
         return;
     }
-
-    const ValidationResult result = validateMessages(m_savedMessages);
-    if (!result.ok) {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle(tr("导出前校验失败"));
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setText(tr("当前数据存在问题，建议先修复再导出。"));
-        msgBox.setDetailedText(result.errors.join(QStringLiteral("\n")));
-        msgBox.setStandardButtons(QMessageBox::Cancel | QMessageBox::Ok);
-        msgBox.button(QMessageBox::Ok)->setText(tr("仍然导出"));
-        msgBox.button(QMessageBox::Cancel)->setText(tr("取消"));
-        if (msgBox.exec() == QMessageBox::Cancel) {
-            return;
-        }
+    const QList<CanMessage *> messages = createMessages(saved);
+    if (!confirmExport(messages)) {
+        deleteMessages(messages);
+        return;
     }
 
     QString suggestedPath;
@@ -307,6 +405,7 @@ void MainWindow::exportToExcelByEcu()
         "Export to Excel (by ECU)", suggestedPath, "Excel Workbook (*.xlsx)");
 
     if (filePath.isEmpty()) {
+        deleteMessages(messages);
         return;
     }
 
@@ -316,15 +415,18 @@ void MainWindow::exportToExcelByEcu()
     }
 
     QString errorMessage;
-    if (!DbcExcelConverter::exportToExcel(normalizedPath,
-                                          m_savedVersion,
-                                          m_savedBusType,
-                                          m_savedNodes,
-                                          m_savedMessages,
-                                          m_savedDocumentTitle,
-                                          m_savedChangeHistory,
-                                          true,
-                                          &errorMessage)) {
+    const bool exported = DbcExcelConverter::exportToExcel(normalizedPath,
+                                                           saved.version,
+                                                           saved.busType,
+                                                           saved.nodes,
+                                                           messages,
+                                                           saved.documentTitle,
+                                                           saved.changeHistory,
+                                                           true,
+                                                           m_excelCompression,
+                                                           &errorMessage);
+    deleteMessages(messages);
+    if (!exported) {
         QMessageBox::critical(this, "Export Failed", errorMessage);
         return;
     }
@@ -334,24 +436,15 @@ void MainWindow::exportToExcelByEcu()
 
 void MainWindow::exportToExcelSingleSheet()
 {
-    if (m_savedMessages.isEmpty()) {
+    const DbcSnapshot &saved = m_savedSnapshot;
+    if (saved.messages.isEmpty()) {
         QMessageBox::warning(this, "Export", "Please load a DBC file before exporting to Excel.");
         return;
     }
-
-    const ValidationResult result = validateMessages(m_savedMessages);
-    if (!result.ok) {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle(tr("导出前校验失败"));
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setText(tr("当前数据存在问题，建议先修复再导出。"));
-        msgBox.setDetailedText(result.errors.join(QStringLiteral("\n")));
-        msgBox.setStandardButtons(QMessageBox::Cancel | QMessageBox::Ok);
-        msgBox.button(QMessageBox::Ok)->setText(tr("仍然导出"));
-        msgBox.button(QMessageBox::Cancel)->setText(tr("取消"));
-        if (msgBox.exec() == QMessageBox::Cancel) {
-            return;
-        }
+    const QList<CanMessage *> messages = createMessages(saved);
+    if (!confirmExport(messages)) {
+        deleteMessages(messages);
+        return;
     }
 
     QString suggestedPath;
@@ -366,6 +459,7 @@ void MainWindow::exportToExcelSingleSheet()
         "Export to Excel (single sheet)", suggestedPath, "Excel Workbook (*.xlsx)");
 
     if (filePath.isEmpty()) {
+        deleteMessages(messages);
         return;
     }
 
@@ -375,15 +469,18 @@ void MainWindow::exportToExcelSingleSheet()
     }
 
     QString errorMessage;
-    if (!DbcExcelConverter::exportToExcel(normalizedPath,
-                                          m_savedVersion,
-                                          m_savedBusType,
-                                          m_savedNodes,
-                                          m_savedMessages,
-                                          m_savedDocumentTitle,
-                                          m_savedChangeHistory,
-                                          false,
-                                          &errorMessage)) {
+    const bool exported = DbcExcelConverter::exportToExcel(normalizedPath,
+                                                           saved.version,
+                                                           saved.busType,
+                                                           saved.nodes,
+                                                           messages,
+                                                           saved.documentTitle,
+                                                           saved.changeHistory,
+                                                           false,
+                                                           m_excelCompression,
+                                                           &errorMessage);
+    deleteMessages(messages);
+    if (!exported) {
         QMessageBox::critical(this, "Export Failed", errorMessage);
         return;
     }
@@ -393,24 +490,15 @@ void MainWindow::exportToExcelSingleSheet()
 
 void MainWindow::exportToDbc()
 {
-    if (m_savedMessages.isEmpty()) {
+    const DbcSnapshot &saved = m_savedSnapshot;
+    if (saved.messages.isEmpty()) {
         QMessageBox::warning(this, "Export", "Please load a DBC file before exporting to DBC.");
         return;
     }
-
-    const ValidationResult result = validateMessages(m_savedMessages);
-    if (!result.ok) {
-        QMessageBox msgBox(this);
-        msgBox.setWindowTitle(tr("导出前校验失败"));
-        msgBox.setIcon(QMessageBox::Warning);
-        msgBox.setText(tr("当前数据存在问题，建议先修复再导出。"));
-        msgBox.setDetailedText(result.errors.join(QStringLiteral("\n")));
-        msgBox.setStandardButtons(QMessageBox::Cancel | QMessageBox::Ok);
-        msgBox.button(QMessageBox::Ok)->setText(tr("仍然导出"));
-        msgBox.button(QMessageBox::Cancel)->setText(tr("取消"));
-        if (msgBox.exec() == QMessageBox::Cancel) {
-            return;
-        }
+    const QList<CanMessage *> messages = createMessages(saved);
+    if (!confirmExport(messages)) {
+        deleteMessages(messages);
+        return;
     }
 
     QString suggestedPath;
@@ -425,6 +513,7 @@ void MainWindow::exportToDbc()
         "Export to DBC", suggestedPath, "DBC Files (*.dbc);;All Files (*)");
 
     if (filePath.isEmpty()) {
+        deleteMessages(messages);
         return;
     }
 
@@ -434,16 +523,19 @@ void MainWindow::exportToDbc()
     }
 
     QString errorMessage;
-    if (!DbcWriter::write(normalizedPath,
-                          m_savedVersion,
-                          m_savedBusType,
-                          m_savedNodes,
-                          m_savedMessages,
-                          QString(),
-                          m_savedDocumentTitle,
-                          m_savedChangeHistory,
-                          m_savedGlobalValueTables,
-                          &errorMessage)) {
+    const bool exported = DbcWriter::write(normalizedPath,
+                                           saved.version,
+                                           saved.busType,
+                                           saved.nodes,
+                                           messages,
+                                           QString(),
+                                           saved.documentTitle,
+                                           saved.changeHistory,
+                                           saved.globalValueTables,
+                                           saved.attributes,
+                                           &errorMessage);
+    deleteMessages(messages);
+    if (!exported) {
         QMessageBox::critical(this, "Export Failed", errorMessage);
         return;
     }
@@ -451,242 +543,122 @@ void MainWindow::exportToDbc()
     m_statusLabel->setText(QString("Exported DBC: %1").arg(QFileInfo(normalizedPath).fileName()));
 }
 
-void MainWindow::loadDbcFile(const QString &filePath)
+void MainWindow::loadFile(const QString &filePath)
 {
-    if (m_dbcParser->parseFile(filePath)) {
-        m_currentDbcPath = filePath;
-        m_fileLabel->setText(QString("File: %1").arg(QFileInfo(filePath).fileName()));
-        m_statusLabel->setText(QString("Loaded %1 messages").arg(m_dbcParser->getMessages().size()));
-
-        populateMessageTree();
-        clearViews();
-        showValidationErrorsIfAny();
-        createSnapshotFromCurrent();
-        m_isDirty = false;
-    } else {
-        QMessageBox::critical(this, "Error", "Failed to parse DBC file!");
-        m_statusLabel->setText("Error loading file");
+    if (m_loader->isRunning() || m_compareLoader->isRunning()) {
+        return;
     }
-}
 
-void MainWindow::populateMessageTree()
-{
-    m_isUpdatingMessageTree = true;
-    m_messageTree->clear();
-    
-    for (CanMessage *message : m_dbcParser->getMessages()) {
-        QTreeWidgetItem *item = new QTreeWidgetItem(m_messageTree);
-        item->setText(0, message->getFormattedId());
-        item->setText(1, message->getName());
-        item->setText(2, QString::number(message->getLength()));
-        item->setText(3, message->getTransmitter());
-        const QString cycleText = message->getCycleTime() > 0
-            ? QString("%1 ms (%2)").arg(message->getCycleTime()).arg(message->getSendType().isEmpty() ? "N/A" : message->getSendType())
-            : (message->getSendType().isEmpty() ? "N/A" : message->getSendType());
-        item->setText(4, cycleText);
-        
-        // Store message pointer in item data
-        item->setData(0, Qt::UserRole, QVariant::fromValue(static_cast<void*>(message)));
-        item->setFlags(item->flags() | Qt::ItemIsEditable);
-        
-        // Add signals as child items
-        for (CanSignal *signal : message->getSignals()) {
-            QTreeWidgetItem *signalItem = new QTreeWidgetItem(item);
-            signalItem->setText(0, signal->getName());
-            signalItem->setText(1, QString("Bit %1").arg(signal->getStartBit()));
-            signalItem->setText(2, QString("%1 bits").arg(signal->getLength()));
-            signalItem->setText(3, signal->getUnit());
-            signalItem->setText(4, signal->getReceiversAsString());
-            
-            // Store signal pointer in item data
-            signalItem->setData(0, Qt::UserRole, QVariant::fromValue(static_cast<void*>(signal)));
-            signalItem->setFlags(signalItem->flags() & ~Qt::ItemIsEditable);
-        }
-    }
-    
-    m_messageTree->collapseAll();
-    m_isUpdatingMessageTree = false;
+    // 解析与校验在工作线程进行，当前数据保持不变直到加载成功
+    startLoad(m_loader, filePath, tr("Open File"));
 }
 
-void MainWindow::populateSignalTable(CanMessage *message)
+void MainWindow::startLoad(DbcLoader *loader, const QString &filePath, const QString &title)
 {
-    if (!message) {
-        m_isUpdatingSignalTable = true;
-        m_signalTable->setRowCount(0);
-        m_isUpdatingSignalTable = false;
-        return;
-    }
-    
-    QList<CanSignal*> signalList = message->getSignals();
-    m_signalTable->setRowCount(signalList.size());
-    
-    for (int i = 0; i < signalList.size(); ++i) {
-        CanSignal *signal = signalList[i];
-        
-        m_isUpdatingSignalTable = true;
-
-        auto *nameItem = new QTableWidgetItem(signal->getName());
-        auto *startBitItem = new QTableWidgetItem(QString::number(signal->getStartBit()));
-        auto *lengthItem = new QTableWidgetItem(QString::number(signal->getLength()));
-        auto *factorItem = new QTableWidgetItem(QString::number(signal->getFactor()));
-        auto *offsetItem = new QTableWidgetItem(QString::number(signal->getOffset()));
-        auto *minItem = new QTableWidgetItem(QString::number(signal->getMin()));
-        auto *maxItem = new QTableWidgetItem(QString::number(signal->getMax()));
-        auto *unitItem = new QTableWidgetItem(signal->getUnit());
-
-        m_signalTable->setItem(i, 0, nameItem);
-        m_signalTable->setItem(i, 1, startBitItem);
-        m_signalTable->setItem(i, 2, lengthItem);
-        m_signalTable->setItem(i, 3, factorItem);
-        m_signalTable->setItem(i, 4, offsetItem);
-        m_signalTable->setItem(i, 5, minItem);
-        m_signalTable->setItem(i, 6, maxItem);
-        m_signalTable->setItem(i, 7, unitItem);
-
-        // Store model pointer and original numeric values for validation/restore
-        nameItem->setData(Qt::UserRole, QVariant::fromValue(static_cast<void *>(signal)));
-        m_signalTable->item(i, 1)->setData(Qt::UserRole, signal->getStartBit());
-        m_signalTable->item(i, 2)->setData(Qt::UserRole, signal->getLength());
-        m_signalTable->item(i, 3)->setData(Qt::UserRole, signal->getFactor());
-        m_signalTable->item(i, 4)->setData(Qt::UserRole, signal->getOffset());
-        m_signalTable->item(i, 5)->setData(Qt::UserRole, signal->getMin());
-        m_signalTable->item(i, 6)->setData(Qt::UserRole, signal->getMax());
-        m_isUpdatingSignalTable = false;
-    }
-    
-    m_signalTable->resizeColumnsToContents();
+    m_loadProgress = new QProgressDialog(tr("Loading %1...").arg(QFileInfo(filePath).fileName()),
+                                         tr("Cancel"), 0, 100, this);
+    m_loadProgress->setWindowTitle(title);
+    m_loadProgress->setWindowModality(Qt::WindowModal);
+    m_loadProgress->setAutoClose(false);
+    m_loadProgress->setAutoReset(false);
+    m_loadProgress->setMinimumDuration(300);
+    m_loadProgress->setValue(0);
+    connect(m_loadProgress, &QProgressDialog::canceled, loader, &DbcLoader::cancel);
+    connect(loader, &DbcLoader::progressChanged, m_loadProgress, [this](int percent, const QString &text) {
+        m_loadProgress->setValue(percent);
+        m_loadProgress->setLabelText(text);
+    });
+
+    m_statusLabel->setText(QString("Loading %1...").arg(QFileInfo(filePath).fileName()));
+    loader->start(filePath);
 }
 
-void MainWindow::onSignalCellChanged(QTableWidgetItem *item)
+void MainWindow::onLoadFinished()
 {
-    if (!item || m_isUpdatingSignalTable) {
-        return;
+    DBC_TRACE_SCOPE("MainWindow::onLoadFinished");
+    const QString filePath = m_loader->filePath();
+    DbcLoader::Result result = m_loader->takeResult();
+    if (m_loadProgress) {
+        m_loadProgress->deleteLater();
+        m_loadProgress = nullptr;
     }
 
-    const int row = item->row();
-    const int col = item->column();
-    if (row < 0 || col < 0) {
+    if (result.cancelled) {
+        m_statusLabel->setText("Loading cancelled");
         return;
     }
-
-    QTableWidgetItem *nameItem = m_signalTable->item(row, 0);
-    if (!nameItem) {
+    if (!result.parser) {
+        QMessageBox::critical(this, "Open Failed", result.error);
+        m_statusLabel->setText("Error loading file");
         return;
     }
 
-    void *ptr = nameItem->data(Qt::UserRole).value<void *>();
-    CanSignal *signal = static_cast<CanSignal *>(ptr);
-    if (!signal) {
-        return;
+    clearViews();
+    // 撤销栈中的命令引用旧数据，必须在替换前清空
+    m_undoStack->clear();
+    m_checkpoints.clear();
+    m_messageModel->swapDatabase(*result.parser);
+    delete result.parser;
+    m_savedSnapshot = m_messageModel->snapshot();
+
+    m_currentDbcPath = filePath;
+    m_fileLabel->setText(QString("File: %1").arg(QFileInfo(filePath).fileName()));
+    const int parseIssues = m_dbcParser->parseReport().issueCount();
+    if (parseIssues > 0) {
+        m_statusLabel->setText(tr("Loaded %1 messages, %2 parse issue(s) (View > Parse Report)")
+                                   .arg(m_dbcParser->getMessages().size()).arg(parseIssues));
+    } else {
+        m_statusLabel->setText(QString("Loaded %1 messages").arg(m_dbcParser->getMessages().size()));
     }
 
-    const QString text = item->text().trimmed();
-
-    m_isUpdatingSignalTable = true;
+    showValidationErrors(result.validation);
+}
 
-    bool ok = false;
-    switch (col) {
-    case 0: // Name
-        signal->setName(text);
-        markDirty();
-        break;
-    case 1: { // Start Bit
-        int value = text.toInt(&ok);
-        if (!ok) {
-            item->setText(QString::number(signal->getStartBit()));
-            m_statusLabel->setText(tr("无效的起始位：%1").arg(text));
-        } else {
-            signal->setStartBit(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 2: { // Length
-        int value = text.toInt(&ok);
-        if (!ok || value <= 0) {
-            item->setText(QString::number(signal->getLength()));
-            m_statusLabel->setText(tr("无效的长度：%1").arg(text));
-        } else {
-            signal->setLength(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 3: { // Factor
-        double value = text.toDouble(&ok);
-        if (!ok) {
-            item->setText(QString::number(signal->getFactor()));
-            m_statusLabel->setText(tr("无效的系数：%1").arg(text));
-        } else {
-            signal->setFactor(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 4: { // Offset
-        double value = text.toDouble(&ok);
-        if (!ok) {
-            item->setText(QString::number(signal->getOffset()));
-            m_statusLabel->setText(tr("无效的偏移：%1").arg(text));
-        } else {
-            signal->setOffset(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 5: { // Min
-        double value = text.toDouble(&ok);
-        if (!ok) {
-            item->setText(QString::number(signal->getMin()));
-            m_statusLabel->setText(tr("无效的最小值：%1").arg(text));
-        } else {
-            signal->setMin(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 6: { // Max
-        double value = text.toDouble(&ok);
-        if (!ok) {
-            item->setText(QString::number(signal->getMax()));
-            m_statusLabel->setText(tr("无效的最大值：%1").arg(text));
-        } else {
-            signal->setMax(value);
-            item->setData(Qt::UserRole, value);
-            markDirty();
-        }
-        break;
-    }
-    case 7: // Unit
-        signal->setUnit(text);
-        markDirty();
-        break;
-    default:
-        break;
+void MainWindow::populateSignalTable(CanMessage *message)
+{
+    DBC_TRACE_SCOPE("MainWindow::populateSignalTable");
+    m_signalModel->setMessage(message);
+    if (message) {
+        m_signalTable->resizeColumnsToContents();
     }
+}
 
-    // 刷新位布局和详情
-    if (m_currentMessage) {
-        m_signalLayout->setMessage(m_currentMessage);
+void MainWindow::onSignalUpdated(CanMessage *message, CanSignal *signal)
+{
+    if (message != m_currentMessage) {
+        return;
     }
+    // 刷新信号表行、位布局和详情
+    m_signalModel->signalChanged(signal);
+    m_signalLayout->setMessage(m_currentMessage);
+    m_signalLayout->setHighlightedSignal(m_currentSignal);
     if (m_currentSignal == signal) {
         populateSignalDetails(m_currentSignal);
     }
-
-    m_isUpdatingSignalTable = false;
 }
 
-void MainWindow::onSignalTableHeaderClicked(int logicalIndex)
+void MainWindow::onSignalListChanged(CanMessage *message)
 {
-    if (logicalIndex < 0 || logicalIndex >= m_signalTable->columnCount()) {
+    if (message != m_currentMessage) {
         return;
     }
-    if (m_signalTable->rowCount() <= 1) {
+    if (m_currentSignal && !m_currentMessage->getSignals().contains(m_currentSignal)) {
+        m_currentSignal = nullptr;
+        m_signalDetails->clear();
+        m_valueTable->clear();
+        m_detailsStack->setCurrentIndex(0);
+        if (m_applyValueTableButton) {
+            m_applyValueTableButton->setEnabled(false);
+        }
+    }
+    populateSignalTable(m_currentMessage);
+    m_signalLayout->setMessage(m_currentMessage);
+    m_signalLayout->setHighlightedSignal(m_currentSignal);
+}
+
+void MainWindow::onSignalTableHeaderClicked(int logicalIndex)
+{
+    if (logicalIndex < 0 || logicalIndex >= m_signalProxy->columnCount()) {
         return;
     }
     if (m_signalTableSortColumn == logicalIndex) {
@@ -695,51 +667,21 @@ void MainWindow::onSignalTableHeaderClicked(int logicalIndex)
         m_signalTableSortColumn = logicalIndex;
         m_signalTableSortOrder = Qt::AscendingOrder;
     }
+    // 代理模型按 SortRole 排序，只重排行索引，不重建单元格
+    m_signalProxy->sort(m_signalTableSortColumn, m_signalTableSortOrder);
+    m_signalTable->horizontalHeader()->setSortIndicatorShown(true);
+    m_signalTable->horizontalHeader()->setSortIndicator(m_signalTableSortColumn, m_signalTableSortOrder);
+}
 
-    const int rowCount = m_signalTable->rowCount();
-    const int colCount = m_signalTable->columnCount();
-    QList<QList<QTableWidgetItem *>> rows;
-    for (int r = 0; r < rowCount; ++r) {
-        QList<QTableWidgetItem *> row;
-        for (int c = 0; c < colCount; ++c) {
-            row.append(m_signalTable->takeItem(r, c));
-        }
-        rows.append(row);
-    }
-
-    const bool numericColumn = (logicalIndex >= 1 && logicalIndex <= 6);
-    const bool ascending = (m_signalTableSortOrder == Qt::AscendingOrder);
-    if (numericColumn) {
-        std::sort(rows.begin(), rows.end(), [logicalIndex, ascending](const QList<QTableWidgetItem *> &a, const QList<QTableWidgetItem *> &b) {
-            const QVariant va = a[logicalIndex]->data(Qt::UserRole);
-            const QVariant vb = b[logicalIndex]->data(Qt::UserRole);
-            bool okA = false, okB = false;
-            const double na = va.toDouble(&okA);
-            const double nb = vb.toDouble(&okB);
-            if (okA && okB) {
-                return ascending ? (na < nb) : (na > nb);
-            }
-            const QString sa = a[logicalIndex]->text();
-            const QString sb = b[logicalIndex]->text();
-            return ascending ? (sa < sb) : (sa > sb);
-        });
-    } else {
-        std::sort(rows.begin(), rows.end(), [logicalIndex, ascending](const QList<QTableWidgetItem *> &a, const QList<QTableWidgetItem *> &b) {
-            const QString sa = a[logicalIndex]->text();
-            const QString sb = b[logicalIndex]->text();
-            return ascending ? (sa < sb) : (sa > sb);
-        });
-    }
-
-    for (int r = 0; r < rowCount; ++r) {
-        for (int c = 0; c < colCount; ++c) {
-            m_signalTable->setItem(r, c, rows[r][c]);
-        }
-    }
+CanSignal *MainWindow::signalAtTableRow(int row) const
+{
+    const QModelIndex index = m_signalProxy->mapToSource(m_signalProxy->index(row, 0));
+    return index.isValid() ? m_signalModel->signalAt(index.row()) : nullptr;
 }
 
 void MainWindow::populateSignalDetails(CanSignal *signal)
 {
+    DBC_TRACE_SCOPE("MainWindow::populateSignalDetails");
     if (!signal) {
         m_signalDetails->clear();
         m_valueTable->clear();
@@ -850,17 +792,20 @@ void MainWindow::applyValueTableChanges()
         table[raw] = desc;
     }
 
-    m_currentSignal->setValueTable(table);
-    populateSignalDetails(m_currentSignal);
+    if (table == m_currentSignal->getValueTable()) {
+        return;
+    }
+    m_undoStack->push(new SetSignalFieldCommand<QMap<int, QString>>(
+        m_messageModel, m_currentMessage, m_currentSignal, &CanSignal::setValueTable,
+        m_currentSignal->getValueTable(), table, tr("Edit value table of %1").arg(m_currentSignal->getName())));
     m_statusLabel->setText(tr("值表已更新"));
-    markDirty();
 }
 
 void MainWindow::onMessageSelectionChanged()
 {
-    QList<QTreeWidgetItem*> selectedItems = m_messageTree->selectedItems();
-    
-    if (selectedItems.isEmpty()) {
+    const QModelIndex index = currentMessageTreeIndex();
+
+    if (!index.isValid()) {
         m_currentMessage = nullptr;
         m_currentSignal = nullptr;
         populateSignalTable(nullptr);
@@ -875,12 +820,9 @@ void MainWindow::onMessageSelectionChanged()
         return;
     }
     
-    QTreeWidgetItem *item = selectedItems.first();
-    void *data = item->data(0, Qt::UserRole).value<void*>();
-    
-    if (item->parent() == nullptr) {
+    if (CanMessage *message = m_messageModel->messageAt(index)) {
         // CAN ID (message) selected -> show bitfield layout
-        m_currentMessage = static_cast<CanMessage*>(data);
+        m_currentMessage = message;
         m_currentSignal = nullptr;
         populateSignalTable(m_currentMessage);
         m_signalLayout->setMessage(m_currentMessage);
@@ -888,10 +830,14 @@ void MainWindow::onMessageSelectionChanged()
         m_detailsStack->setCurrentIndex(0);
     } else {
         // Specific signal selected in tree -> show Properties + Value Table
-        m_currentSignal = static_cast<CanSignal*>(data);
-        m_currentMessage = static_cast<CanMessage*>(item->parent()->data(0, Qt::UserRole).value<void*>());
-        populateSignalTable(m_currentMessage);
-        m_signalLayout->setMessage(m_currentMessage);
+        CanMessage *parentMessage = m_messageModel->messageAt(index.parent());
+        m_currentSignal = m_messageModel->signalAt(index);
+        if (parentMessage != m_currentMessage) {
+            m_currentMessage = parentMessage;
+            populateSignalTable(m_currentMessage);
+            m_signalLayout->setMessage(m_currentMessage);
+        }
+        // 同一报文内切换信号只需更新高亮，位表无需重建
         m_signalLayout->setHighlightedSignal(m_currentSignal);
         m_detailsStack->setCurrentIndex(1);
         populateSignalDetails(m_currentSignal);
@@ -900,8 +846,8 @@ void MainWindow::onMessageSelectionChanged()
 
 void MainWindow::onMessageTreeContextMenuRequested(const QPoint &pos)
 {
-    QTreeWidgetItem *item = m_messageTree->itemAt(pos);
-    if (!item) {
+    const QModelIndex index = m_messageTree->indexAt(pos);
+    if (!index.isValid()) {
         return;
     }
     QMenu menu(this);
@@ -911,17 +857,18 @@ void MainWindow::onMessageTreeContextMenuRequested(const QPoint &pos)
     if (chosen == copyRow) {
         copyMessageAsNew();
     } else if (chosen == deleteRow) {
-        m_messageTree->setCurrentItem(item);
+        m_messageTree->setCurrentIndex(index);
         deleteMessage();
     }
 }
 
 void MainWindow::onSignalTableContextMenuRequested(const QPoint &pos)
 {
-    if (!m_signalTable->itemAt(pos)) {
+    const QModelIndex index = m_signalTable->indexAt(pos);
+    if (!index.isValid()) {
         return;
     }
-    int row = m_signalTable->itemAt(pos)->row();
+    const int row = index.row();
     QMenu menu(this);
     QAction *copyRow = menu.addAction(tr("复制为新的信号"));
     QAction *deleteRow = menu.addAction(tr("删除信号"));
@@ -938,17 +885,12 @@ void MainWindow::copyMessageAsNew()
     if (!m_dbcParser) {
         return;
     }
-    QList<QTreeWidgetItem *> items = m_messageTree->selectedItems();
-    if (items.isEmpty()) {
-        return;
-    }
-    QTreeWidgetItem *item = items.first();
-    if (item->parent() != nullptr) {
+    QModelIndex index = currentMessageTreeIndex();
+    if (index.parent().isValid()) {
         // 若选中的是信号行，则取父节点对应的报文
-        item = item->parent();
+        index = index.parent();
     }
-    void *ptr = item->data(0, Qt::UserRole).value<void *>();
-    CanMessage *origMsg = static_cast<CanMessage *>(ptr);
+    CanMessage *origMsg = m_messageModel->messageAt(index);
     if (!origMsg) {
         return;
     }
@@ -980,6 +922,7 @@ void MainWindow::copyMessageAsNew()
     msg->setComment(origMsg->getComment());
     msg->setMessageType(origMsg->getMessageType());
     msg->setReceivers(origMsg->getReceivers());
+    msg->setAttributes(origMsg->getAttributes());
 
     for (CanSignal *origSig : origMsg->getSignals()) {
         if (!origSig) {
@@ -1003,26 +946,17 @@ void MainWindow::copyMessageAsNew()
         sig->setInvalidValueHex(origSig->getInvalidValueHex());
         sig->setInactiveValueHex(origSig->getInactiveValueHex());
         sig->setValueTable(origSig->getValueTable());
+        sig->setAttributes(origSig->getAttributes());
         if (origSig->hasRawRange()) {
             sig->setRawRange(origSig->getRawMin(), origSig->getRawMax());
         }
         msg->addSignal(sig);
     }
 
-    m_dbcParser->addMessage(msg);
-    populateMessageTree();
-    markDirty();
+    m_undoStack->push(new AddMessageCommand(m_messageModel, msg, tr("Copy message %1").arg(origMsg->getName())));
 
-    // 选中新复制的报文（按 ID 查找）
-    const int topCount = m_messageTree->topLevelItemCount();
-    for (int i = 0; i < topCount; ++i) {
-        QTreeWidgetItem *it = m_messageTree->topLevelItem(i);
-        void *p = it->data(0, Qt::UserRole).value<void *>();
-        if (p == msg) {
-            m_messageTree->setCurrentItem(it);
-            break;
-        }
-    }
+    // 选中新复制的报文
+    selectMessageInTree(msg);
 }
 
 void MainWindow::copySignalAsNew(int row)
@@ -1030,16 +964,7 @@ void MainWindow::copySignalAsNew(int row)
     if (!m_currentMessage) {
         return;
     }
-    if (row < 0 || row >= m_signalTable->rowCount()) {
-        return;
-    }
-
-    QTableWidgetItem *nameItem = m_signalTable->item(row, 0);
-    if (!nameItem) {
-        return;
-    }
-    void *ptr = nameItem->data(Qt::UserRole).value<void *>();
-    CanSignal *origSig = static_cast<CanSignal *>(ptr);
+    CanSignal *origSig = signalAtTableRow(row);
     if (!origSig) {
         return;
     }
@@ -1066,15 +991,13 @@ void MainWindow::copySignalAsNew(int row)
     sig->setInvalidValueHex(origSig->getInvalidValueHex());
     sig->setInactiveValueHex(origSig->getInactiveValueHex());
     sig->setValueTable(origSig->getValueTable());
+    sig->setAttributes(origSig->getAttributes());
     if (origSig->hasRawRange()) {
         sig->setRawRange(origSig->getRawMin(), origSig->getRawMax());
     }
 
-    m_currentMessage->addSignal(sig);
-    populateMessageTree();
-    populateSignalTable(m_currentMessage);
-    m_signalLayout->setMessage(m_currentMessage);
-    markDirty();
+    m_undoStack->push(new AddSignalCommand(m_messageModel, m_currentMessage, sig,
+                                           tr("Copy signal %1").arg(origSig->getName())));
 }
 
 void MainWindow::addMessage()
@@ -1096,17 +1019,10 @@ void MainWindow::addMessage()
     message->setName(QStringLiteral("NewMessage_%1").arg(messages.size() + 1));
     message->setLength(8);
 
-    m_dbcParser->addMessage(message);
-
-    populateMessageTree();
-    markDirty();
+    m_undoStack->push(new AddMessageCommand(m_messageModel, message, tr("Add message %1").arg(message->getName())));
 
     // Select the newly added message
-    const int topCount = m_messageTree->topLevelItemCount();
-    if (topCount > 0) {
-        QTreeWidgetItem *last = m_messageTree->topLevelItem(topCount - 1);
-        m_messageTree->setCurrentItem(last);
-    }
+    selectMessageInTree(message);
 }
 
 void MainWindow::deleteMessage()
@@ -1115,33 +1031,29 @@ void MainWindow::deleteMessage()
         return;
     }
 
-    QTreeWidgetItem *item = m_messageTree->currentItem();
-    if (!item) {
+    QModelIndex index = m_messageProxy->mapToSource(m_messageTree->currentIndex());
+    if (!index.isValid()) {
         return;
     }
 
-    if (item->parent() != nullptr) {
+    if (index.parent().isValid()) {
         // If a signal is selected, delete its parent message only when explicitly selected
-        item = item->parent();
+        index = index.parent();
     }
 
-    void *ptr = item->data(0, Qt::UserRole).value<void *>();
-    CanMessage *message = static_cast<CanMessage *>(ptr);
+    CanMessage *message = m_messageModel->messageAt(index);
     if (!message) {
         return;
     }
 
     const auto ret = QMessageBox::question(this,
                                            tr("删除报文"),
-                                           tr("确定要删除报文 \"%1\" 吗？此操作不可撤销。").arg(message->getName()));
+                                           tr("确定要删除报文 \"%1\" 吗？").arg(message->getName()));
     if (ret != QMessageBox::Yes) {
         return;
     }
 
-    m_dbcParser->removeMessage(message);
-    delete m_messageTree->takeTopLevelItem(m_messageTree->indexOfTopLevelItem(item));
-    clearViews();
-    markDirty();
+    m_undoStack->push(new RemoveMessageCommand(m_messageModel, message));
 }
 
 void MainWindow::addSignal()
@@ -1154,7 +1066,7 @@ void MainWindow::addSignal()
     const int msgLen = m_currentMessage->getLength();
     const int totalBits = msgLen * 8;
     QVector<bool> used(totalBits, false);
-    const QList<CanSignal*> signalList = m_currentMessage->getSignals();
+    const QList<CanSignal*> &signalList = m_currentMessage->getSignals();
     for (CanSignal *sig : signalList) {
         if (!sig) {
             continue;
@@ -1208,12 +1120,8 @@ void MainWindow::addSignal()
     signal->setMin(0.0);
     signal->setMax(1.0);
 
-    m_currentMessage->addSignal(signal);
-
-    populateMessageTree();
-    populateSignalTable(m_currentMessage);
-    m_signalLayout->setMessage(m_currentMessage);
-    markDirty();
+    m_undoStack->push(new AddSignalCommand(m_messageModel, m_currentMessage, signal,
+                                           tr("Add signal %1").arg(signal->getName())));
 }
 
 void MainWindow::deleteSignal()
@@ -1222,7 +1130,7 @@ void MainWindow::deleteSignal()
         return;
     }
 
-    deleteSignalAtRow(m_signalTable->currentRow());
+    deleteSignalAtRow(m_signalTable->currentIndex().row());
 }
 
 void MainWindow::deleteSignalAtRow(int row)
@@ -1230,51 +1138,27 @@ void MainWindow::deleteSignalAtRow(int row)
     if (!m_currentMessage) {
         return;
     }
-    if (row < 0 || row >= m_signalTable->rowCount()) {
-        return;
-    }
-
-    QTableWidgetItem *nameItem = m_signalTable->item(row, 0);
-    if (!nameItem) {
-        return;
-    }
-    void *ptr = nameItem->data(Qt::UserRole).value<void *>();
-    CanSignal *sig = static_cast<CanSignal *>(ptr);
+    CanSignal *sig = signalAtTableRow(row);
     if (!sig) {
         return;
     }
 
     const auto ret = QMessageBox::question(this,
                                            tr("删除信号"),
-                                           tr("确定要删除信号 \"%1\" 吗？此操作不可撤销。").arg(sig->getName()));
+                                           tr("确定要删除信号 \"%1\" 吗？").arg(sig->getName()));
     if (ret != QMessageBox::Yes) {
         return;
     }
 
-    if (m_currentSignal == sig) {
-        m_currentSignal = nullptr;
-    }
-
-    m_currentMessage->removeSignal(sig);
-    delete sig;
-
-    populateMessageTree();
-    populateSignalTable(m_currentMessage);
-    m_signalLayout->setMessage(m_currentMessage);
-    m_signalLayout->setHighlightedSignal(m_currentSignal);
-    m_signalDetails->clear();
-    m_valueTable->clear();
-    if (m_applyValueTableButton) {
-        m_applyValueTableButton->setEnabled(false);
-    }
-    markDirty();
+    // 信号表、位布局和详情由 onSignalListChanged 刷新
+    m_undoStack->push(new RemoveSignalCommand(m_messageModel, m_currentMessage, sig));
 }
 
 void MainWindow::onSignalSelectionChanged()
 {
-    QList<QTableWidgetItem*> selectedItems = m_signalTable->selectedItems();
+    const QModelIndexList selectedRows = m_signalTable->selectionModel()->selectedRows();
     
-    if (selectedItems.isEmpty()) {
+    if (selectedRows.isEmpty()) {
         m_currentSignal = nullptr;
         m_signalLayout->setHighlightedSignal(nullptr);
         m_signalDetails->clear();
@@ -1283,10 +1167,7 @@ void MainWindow::onSignalSelectionChanged()
         return;
     }
     
-    QTableWidgetItem *item = selectedItems.first();
-    void *data = item->data(Qt::UserRole).value<void*>();
-    m_currentSignal = static_cast<CanSignal*>(data);
-    m_signalLayout->setMessage(m_currentMessage);
+    m_currentSignal = signalAtTableRow(selectedRows.first().row());
     m_signalLayout->setHighlightedSignal(m_currentSignal);
     m_detailsStack->setCurrentIndex(1);
     populateSignalDetails(m_currentSignal);
@@ -1294,7 +1175,7 @@ void MainWindow::onSignalSelectionChanged()
 
 void MainWindow::clearViews()
 {
-    m_signalTable->setRowCount(0);
+    m_signalModel->setMessage(nullptr);
     m_signalDetails->clear();
     m_valueTable->clear();
     m_signalLayout->setMessage(nullptr);
@@ -1307,204 +1188,181 @@ void MainWindow::clearViews()
     }
 }
 
-void MainWindow::onMessageTreeItemChanged(QTreeWidgetItem *item, int column)
+QModelIndex MainWindow::currentMessageTreeIndex() const
 {
-    if (!item || m_isUpdatingMessageTree) {
-        return;
+    const QModelIndexList selected = m_messageTree->selectionModel()->selectedRows();
+    if (selected.isEmpty()) {
+        return QModelIndex();
     }
+    return m_messageProxy->mapToSource(selected.first());
+}
 
-    // Top-level items are messages, children are signals
-    if (item->parent() != nullptr) {
-        // For now, keep signal rows in tree read-only (name编辑在表格中处理)
-        return;
+void MainWindow::selectMessageInTree(CanMessage *message)
+{
+    const QModelIndex index = m_messageProxy->mapFromSource(m_messageModel->indexOfMessage(message));
+    if (index.isValid()) {
+        m_messageTree->setCurrentIndex(index);
+        m_messageTree->scrollTo(index);
     }
+}
 
-    void *ptr = item->data(0, Qt::UserRole).value<void *>();
-    CanMessage *message = static_cast<CanMessage *>(ptr);
-    if (!message) {
-        return;
+void MainWindow::onMessageUpdated(CanMessage *message)
+{
+    // 报文长度等变化会影响位布局
+    if (message == m_currentMessage) {
+        m_signalLayout->setMessage(m_currentMessage);
+        m_signalLayout->setHighlightedSignal(m_currentSignal);
     }
+}
 
-    const QString text = item->text(column).trimmed();
-
-    m_isUpdatingMessageTree = true;
-
-    switch (column) {
-    case 0: { // ID
-        QString idText = text;
-        bool ok = false;
-        quint32 id = 0;
-        if (idText.startsWith(QStringLiteral("0x"), Qt::CaseInsensitive)) {
-            id = idText.toUInt(&ok, 16);
-        } else {
-            id = idText.toUInt(&ok, 10);
-        }
-        if (!ok) {
-            item->setText(0, message->getFormattedId());
-            m_statusLabel->setText(tr("无效的报文ID：%1").arg(text));
-        } else {
-            message->setId(id);
-            item->setText(0, message->getFormattedId());
-            markDirty();
-        }
-        break;
-    }
-    case 1: // Name
-        message->setName(text);
-        markDirty();
-        break;
-    case 2: { // Length
-        bool ok = false;
-        int len = text.toInt(&ok);
-        if (!ok || len < 0) {
-            item->setText(2, QString::number(message->getLength()));
-            m_statusLabel->setText(tr("无效的报文长度：%1").arg(text));
-        } else {
-            message->setLength(len);
-            item->setText(2, QString::number(message->getLength()));
-            if (message == m_currentMessage) {
-                populateSignalTable(m_currentMessage);
-                m_signalLayout->setMessage(m_currentMessage);
-            }
-            markDirty();
-        }
-        break;
+void MainWindow::revertToSaved()
+{
+    if (m_undoStack->isClean()) {
+        return;
     }
-    case 3: // Transmitter
-        message->setTransmitter(text);
-        markDirty();
-        break;
-    default:
-        break;
+    const int cleanIndex = m_undoStack->cleanIndex();
+    if (cleanIndex < 0) {
+        // 保存点之后撤销再编辑，保存点已不在撤销历史中
+        QMessageBox::warning(this, tr("恢复"), tr("上次保存的状态已不在撤销历史中，请使用撤销逐步恢复。"));
+        return;
     }
-
-    m_isUpdatingMessageTree = false;
+    // 逐条撤销/重做到保存点，代价与编辑次数成正比，与数据库大小无关
+    m_undoStack->setIndex(cleanIndex);
+    m_statusLabel->setText(tr("已恢复到上次保存状态"));
 }
 
-void MainWindow::markDirty()
+void MainWindow::applySearch()
 {
-    if (!m_isDirty) {
-        m_isDirty = true;
-        m_statusLabel->setText(tr("已修改（未保存）"));
+    DBC_TRACE_SCOPE("MainWindow::applySearch");
+    const QString query = m_searchEdit->text().trimmed();
+    QElapsedTimer timer;
+    timer.start();
+    const SearchResult result = m_messageModel->search(query);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    m_messageModel->setSearchResult(result);
+    m_signalModel->setHighlightedSignals(result.matchedSignals);
+    m_messageProxy->setSearchActive(!query.isEmpty());
+    if (query.isEmpty()) {
+        return;
     }
-}
 
-void MainWindow::clearSavedSnapshot()
-{
-    for (CanMessage *msg : m_savedMessages) {
-        if (!msg) {
-            continue;
-        }
-        for (CanSignal *sig : msg->getSignals()) {
-            delete sig;
+    // 仅通过信号命中的报文自动展开（数量较少时），使命中的信号可见
+    if (result.parentMessages.size() <= 50) {
+        for (const CanMessage *message : result.parentMessages) {
+            if (!result.matchedMessages.contains(message)) {
+                m_messageTree->expand(m_messageProxy->mapFromSource(m_messageModel->indexOfMessage(message)));
+            }
         }
-        delete msg;
-    }
-    m_savedMessages.clear();
-    m_savedVersion.clear();
-    m_savedBusType.clear();
-    m_savedNodes.clear();
-    m_savedDocumentTitle.clear();
-    m_savedChangeHistory.clear();
-    m_savedGlobalValueTables.clear();
+    }
+    const int messageCount = (result.matchedMessages + result.parentMessages).size();
+    m_statusLabel->setText(tr("搜索 \"%1\"：%2 个报文，%3 个信号（%4 ms）")
+                               .arg(query)
+                               .arg(messageCount)
+                               .arg(result.matchedSignals.size())
+                               .arg(elapsedNs / 1e6, 0, 'f', 3));
 }
 
-QList<CanMessage*> MainWindow::cloneMessages(const QList<CanMessage*> &source) const
+void MainWindow::createCheckpoint()
 {
-    QList<CanMessage*> result;
-    for (CanMessage *origMsg : source) {
-        if (!origMsg) {
-            continue;
-        }
-        CanMessage *msg = new CanMessage();
-        msg->setId(origMsg->getId());
-        msg->setName(origMsg->getName());
-        msg->setLength(origMsg->getLength());
-        msg->setTransmitter(origMsg->getTransmitter());
-        msg->setCycleTime(origMsg->getCycleTime());
-        msg->setFrameFormat(origMsg->getFrameFormat());
-        msg->setSendType(origMsg->getSendType());
-        msg->setCycleTimeFast(origMsg->getCycleTimeFast());
-        msg->setNrOfRepetitions(origMsg->getNrOfRepetitions());
-        msg->setDelayTime(origMsg->getDelayTime());
-        msg->setComment(origMsg->getComment());
-        msg->setMessageType(origMsg->getMessageType());
-        msg->setReceivers(origMsg->getReceivers());
-
-        for (CanSignal *origSig : origMsg->getSignals()) {
-            if (!origSig) {
-                continue;
-            }
-            CanSignal *sig = new CanSignal();
-            sig->setName(origSig->getName());
-            sig->setStartBit(origSig->getStartBit());
-            sig->setLength(origSig->getLength());
-            sig->setByteOrder(origSig->getByteOrder());
-            sig->setSigned(origSig->isSigned());
-            sig->setFactor(origSig->getFactor());
-            sig->setOffset(origSig->getOffset());
-            sig->setMin(origSig->getMin());
-            sig->setMax(origSig->getMax());
-            sig->setUnit(origSig->getUnit());
-            sig->setReceivers(origSig->getReceivers());
-            sig->setDescription(origSig->getDescription());
-            sig->setSendType(origSig->getSendType());
-            sig->setInitialValue(origSig->getInitialValue());
-            sig->setInvalidValueHex(origSig->getInvalidValueHex());
-            sig->setInactiveValueHex(origSig->getInactiveValueHex());
-            sig->setValueTable(origSig->getValueTable());
-            if (origSig->hasRawRange()) {
-                sig->setRawRange(origSig->getRawMin(), origSig->getRawMax());
-            }
-            msg->addSignal(sig);
-        }
-
-        result.append(msg);
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("创建检查点"), tr("检查点名称："), QLineEdit::Normal,
+                                               tr("Checkpoint %1").arg(m_checkpoints.size() + 1), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
     }
-    return result;
+    // 快照为 O(1) 拷贝，之后的编辑只复制被修改的报文/信号
+    DbcCheckpoint checkpoint;
+    checkpoint.name = name;
+    checkpoint.created = QDateTime::currentDateTime();
+    checkpoint.snapshot = m_messageModel->snapshot();
+    m_checkpoints.append(checkpoint);
+    m_statusLabel->setText(tr("已创建检查点：%1").arg(name));
 }
 
-void MainWindow::createSnapshotFromCurrent()
+void MainWindow::compareWithCheckpoint()
 {
-    if (!m_dbcParser) {
+    if (m_checkpoints.isEmpty()) {
+        QMessageBox::information(this, tr("比较"), tr("尚未创建检查点。"));
         return;
     }
-    clearSavedSnapshot();
-
-    m_savedMessages = cloneMessages(m_dbcParser->getMessages());
-    m_savedVersion = m_dbcParser->getVersion();
-    m_savedBusType = m_dbcParser->getBusType();
-    m_savedNodes = m_dbcParser->getNodes();
-    m_savedDocumentTitle = m_dbcParser->getDocumentTitle();
-    m_savedChangeHistory = m_dbcParser->getChangeHistory();
-    m_savedGlobalValueTables = m_dbcParser->getGlobalValueTables();
+    QStringList names;
+    for (const DbcCheckpoint &checkpoint : m_checkpoints) {
+        names << QString("%1 (%2)").arg(checkpoint.name, checkpoint.created.toString("HH:mm:ss"));
+    }
+    bool ok = false;
+    const QString chosen = QInputDialog::getItem(this, tr("比较"), tr("与当前数据比较的检查点："),
+                                                 names, names.size() - 1, false, &ok);
+    const int index = names.indexOf(chosen);
+    if (!ok || index < 0) {
+        return;
+    }
+    SnapshotCompareDialog dialog(m_checkpoints.at(index).name, m_checkpoints.at(index).snapshot,
+                                 tr("当前"), m_messageModel->snapshot(), this);
+    dialog.exec();
 }
 
-void MainWindow::restoreSnapshotToCurrent()
+void MainWindow::compareWithFile()
 {
-    if (!m_dbcParser || m_savedMessages.isEmpty()) {
+    if (m_loader->isRunning() || m_compareLoader->isRunning()) {
         return;
     }
+    const QString initialDir = m_currentDbcPath.isEmpty() ? QDir::homePath() : QFileInfo(m_currentDbcPath).absolutePath();
+    const QString fileName = QFileDialog::getOpenFileName(this, tr("Compare with File"), initialDir,
+        "DBC and Excel Files (*.dbc *.xlsx);;DBC Files (*.dbc);;Excel Workbook (*.xlsx);;All Files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    startLoad(m_compareLoader, fileName, tr("Compare with File"));
+}
 
-    // 清空当前解析器并用快照重建
-    m_dbcParser->clear();
-    for (CanMessage *msg : cloneMessages(m_savedMessages)) {
-        m_dbcParser->addMessage(msg);
+void MainWindow::onCompareLoadFinished()
+{
+    const QString filePath = m_compareLoader->filePath();
+    DbcLoader::Result result = m_compareLoader->takeResult();
+    if (m_loadProgress) {
+        m_loadProgress->deleteLater();
+        m_loadProgress = nullptr;
+    }
+    if (result.cancelled) {
+        m_statusLabel->setText(tr("Comparison cancelled"));
+        return;
+    }
+    if (!result.parser) {
+        QMessageBox::critical(this, tr("Compare Failed"), result.error);
+        m_statusLabel->setText(tr("Error loading file"));
+        return;
     }
 
-    // 恢复其他元数据
-    // 这些字段在 DbcParser 中是私有成员，只能通过当前公开接口在导出时使用；
-    // 这里保持它们只在快照中用于导出，不强行写回 parser。
+    // 所选文件作为旧版本，当前数据作为新版本
+    // 快照持有字段数据的引用，解析器可立即释放
+    const DbcSnapshot other = snapshotOf(*result.parser);
+    delete result.parser;
+    const QString currentTitle = m_currentDbcPath.isEmpty() ? tr("当前") : QFileInfo(m_currentDbcPath).fileName();
+    SnapshotCompareDialog dialog(QFileInfo(filePath).fileName(), other, currentTitle, m_messageModel->snapshot(), this);
+    dialog.exec();
+    m_statusLabel->setText(tr("Compared with %1").arg(QFileInfo(filePath).fileName()));
+}
 
-    populateMessageTree();
-    clearViews();
-    m_isDirty = false;
-    m_statusLabel->setText(tr("已恢复到上次保存状态"));
+bool MainWindow::confirmExport(const QList<CanMessage *> &messages)
+{
+    const ValidationResult result = validateMessages(messages);
+    if (result.ok) {
+        return true;
+    }
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle(tr("导出前校验失败"));
+    msgBox.setIcon(QMessageBox::Warning);
+    msgBox.setText(tr("已保存的数据存在问题，建议先修复并保存后再导出。"));
+    msgBox.setDetailedText(result.errors.join(QStringLiteral("\n")));
+    msgBox.setStandardButtons(QMessageBox::Cancel | QMessageBox::Ok);
+    msgBox.button(QMessageBox::Ok)->setText(tr("仍然导出"));
+    msgBox.button(QMessageBox::Cancel)->setText(tr("取消"));
+    return msgBox.exec() != QMessageBox::Cancel;
 }
 
-void MainWindow::showValidationErrorsIfAny()
+void MainWindow::showValidationErrors(const ValidationResult &result)
 {
-    const ValidationResult result = validateMessages(m_dbcParser->getMessages());
     if (!result.ok && !result.errors.isEmpty()) {
         QMessageBox msgBox(this);
         msgBox.setWindowTitle(tr("导入数据校验"));
@@ -1516,6 +1374,17 @@ void MainWindow::showValidationErrorsIfAny()
     }
 }
 
+void MainWindow::showParseReport()
+{
+    const ParseReport &report = m_dbcParser->parseReport();
+    if (report.isEmpty()) {
+        QMessageBox::information(this, tr("Parse Report"), tr("当前数据不是从 DBC 文件解析得到的，没有解析报告。"));
+        return;
+    }
+    ParseReportDialog dialog(report, this);
+    dialog.exec();
+}
+
 void MainWindow::showAbout()
 {
     QMessageBox::about(this, "About DBC Viewer",
@@ -1554,26 +1423,9 @@ void MainWindow::dropEvent(QDropEvent *event)
         QList<QUrl> urls = event->mimeData()->urls();
         if (!urls.isEmpty()) {
             QString fileName = urls.first().toLocalFile();
-            if (fileName.endsWith(".dbc", Qt::CaseInsensitive)) {
-                loadDbcFile(fileName);
-                event->acceptProposedAction();
-                return;
-            }
-            if (fileName.endsWith(".xlsx", Qt::CaseInsensitive)) {
-                DbcExcelConverter::ImportResult importResult;
-                QString errorMessage;
-                if (!DbcExcelConverter::importFromExcel(fileName, importResult, &errorMessage)) {
-                    QMessageBox::critical(this, "Open Failed", errorMessage);
-                    event->ignore();
-                    return;
-                }
-                m_dbcParser->loadFromExcelImport(importResult);
-                m_currentDbcPath = fileName;
-                m_fileLabel->setText(QString("File: %1").arg(QFileInfo(fileName).fileName()));
-                m_statusLabel->setText(QString("Loaded %1 messages").arg(m_dbcParser->getMessages().size()));
-                populateMessageTree();
-                clearViews();
-                showValidationErrorsIfAny();
+            if (fileName.endsWith(".dbc", Qt::CaseInsensitive)
+                || fileName.endsWith(".xlsx", Qt::CaseInsensitive)) {
+                loadFile(fileName);
                 event->acceptProposedAction();
                 return;
             }
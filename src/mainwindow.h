@@ -2,8 +2,9 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTreeWidget>
-#include <QTableWidget>
+#include <QTreeView>
+#include <QSortFilterProxyModel>
+#include <QTableView>
 #include <QTextEdit>
 #include <QSplitter>
 #include <QVBoxLayout>
@@ -20,11 +21,20 @@
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QMimeData>
+#include <QLineEdit>
 #include "dbcparser.h"
 #include "dbcexcelconverter.h"
 #include "dbcwriter.h"
+#include "dbcsnapshot.h"
 
 class SignalLayoutWidget;
+class MessageTreeModel;
+class SignalTableModel;
+class MessageFilterProxyModel;
+class DbcLoader;
+class QProgressDialog;
+class QUndoStack;
+struct ValidationResult;
 
 class MainWindow : public QMainWindow
 {
@@ -42,13 +52,15 @@ private slots:
     void onMessageSelectionChanged();
     void onSignalSelectionChanged();
     void onSignalTableHeaderClicked(int logicalIndex);
-    void onSignalCellChanged(QTableWidgetItem *item);
-    void onMessageTreeItemChanged(QTreeWidgetItem *item, int column);
+    void onSignalUpdated(CanMessage *message, CanSignal *signal);
+    void onMessageUpdated(CanMessage *message);
+    void onSignalListChanged(CanMessage *message);
     void addMessage();
     void deleteMessage();
     void addSignal();
     void deleteSignal();
     void showAbout();
+    void showParseReport();
 
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
@@ -58,12 +70,20 @@ private:
     void setupUI();
     void setupMenuBar();
     void setupStatusBar();
-    void loadDbcFile(const QString &filePath);
-    void populateMessageTree();
+    /** Loads a .dbc or .xlsx file in the background; the result is applied in onLoadFinished(). */
+    void loadFile(const QString &filePath);
+    void onLoadFinished();
+    /** Shows a progress dialog for loader and starts loading filePath. */
+    void startLoad(DbcLoader *loader, const QString &filePath, const QString &title);
     void populateSignalTable(CanMessage *message);
     void populateSignalDetails(CanSignal *signal);
     void clearViews();
-    void showValidationErrorsIfAny();
+    /** Source-model index of the tree's current row (message or signal). */
+    QModelIndex currentMessageTreeIndex() const;
+    void selectMessageInTree(CanMessage *message);
+    void showValidationErrors(const ValidationResult &result);
+    /** Runs the search box query against the index; filters the tree and highlights matches. */
+    void applySearch();
     
     // UI Components
     QWidget *m_centralWidget;
@@ -72,11 +92,16 @@ private:
     
     // Left panel - Message tree
     QGroupBox *m_messageGroup;
-    QTreeWidget *m_messageTree;
+    QLineEdit *m_searchEdit;
+    QTreeView *m_messageTree;
+    MessageTreeModel *m_messageModel;
+    MessageFilterProxyModel *m_messageProxy;
     
     // Right panel - Signal table and details
     QGroupBox *m_signalGroup;
-    QTableWidget *m_signalTable;
+    QTableView *m_signalTable;
+    SignalTableModel *m_signalModel;
+    QSortFilterProxyModel *m_signalProxy;
     
     QGroupBox *m_detailsGroup;
     QStackedWidget *m_detailsStack;
@@ -92,36 +117,39 @@ private:
     
     // Data
     DbcParser *m_dbcParser;
+    DbcLoader *m_loader;
+    DbcLoader *m_compareLoader;
+    QUndoStack *m_undoStack;
+    QProgressDialog *m_loadProgress = nullptr;
     CanMessage *m_currentMessage;
     CanSignal *m_currentSignal;
     QString m_currentDbcPath;
     int m_signalTableSortColumn = -1;
     Qt::SortOrder m_signalTableSortOrder = Qt::AscendingOrder;
-    bool m_isUpdatingSignalTable = false;
-    bool m_isUpdatingMessageTree = false;
+    DbcExcelConverter::CompressionLevel m_excelCompression = DbcExcelConverter::CompressionBalanced;
 
     void applyValueTableChanges();
     void onMessageTreeContextMenuRequested(const QPoint &pos);
     void onSignalTableContextMenuRequested(const QPoint &pos);
     void copyMessageAsNew();
+    /** Signal shown in the given (sorted) table row. */
+    CanSignal *signalAtTableRow(int row) const;
     void copySignalAsNew(int row);
     void deleteSignalAtRow(int row);
 
-    // 保存/撤销相关
-    bool m_isDirty = false;
-    QList<CanMessage*> m_savedMessages;
-    QString m_savedVersion;
-    QString m_savedBusType;
-    QStringList m_savedNodes;
-    QString m_savedDocumentTitle;
-    QList<DbcExcelConverter::ChangeHistoryEntry> m_savedChangeHistory;
-    QList<QPair<QString, QMap<int, QString>>> m_savedGlobalValueTables;
-
-    void clearSavedSnapshot();
-    QList<CanMessage*> cloneMessages(const QList<CanMessage*> &source) const;
-    void createSnapshotFromCurrent();
-    void restoreSnapshotToCurrent();
-    void markDirty();
+    // 保存/撤销相关：编辑以命令形式入栈，保存点即撤销栈的 clean 状态
+    void revertToSaved();
+    // 上次保存（或加载）时的快照，导出写出的是它而不是未保存的编辑
+    DbcSnapshot m_savedSnapshot;
+    // 命名检查点：快照与当前数据共享未修改的报文/信号
+    QList<DbcCheckpoint> m_checkpoints;
+    void createCheckpoint();
+    void compareWithCheckpoint();
+    /** Loads another .dbc/.xlsx in the background and shows its field-level diff against the current data. */
+    void compareWithFile();
+    void onCompareLoadFinished();
+    /** Validates the messages to export and asks whether to export anyway; false cancels the export. */
+    bool confirmExport(const QList<CanMessage *> &messages);
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,31 @@
+#include "messagefilterproxymodel.h"
+
+#include "messagetreemodel.h"
+
+MessageFilterProxyModel::MessageFilterProxyModel(MessageTreeModel *model, QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_model(model)
+{
+    setSourceModel(model);
+    setSortRole(MessageTreeModel::SortRole);
+}
+
+void MessageFilterProxyModel::setSearchActive(bool active)
+{
+    m_searchActive = active;
+    invalidateFilter();
+}
+
+bool MessageFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!m_searchActive) {
+        return true;
+    }
+    const SearchResult &result = m_model->searchResult();
+    const QModelIndex index = m_model->index(sourceRow, 0, sourceParent);
+    if (!sourceParent.isValid()) {
+        return result.containsMessage(m_model->messageAt(index));
+    }
+    return result.matchedMessages.contains(m_model->messageAt(sourceParent))
+        || result.matchedSignals.contains(m_model->signalAt(index));
+}
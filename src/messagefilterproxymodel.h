@@ -0,0 +1,32 @@
+#ifndef MESSAGEFILTERPROXYMODEL_H
+#define MESSAGEFILTERPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+
+class MessageTreeModel;
+
+/**
+ * Sort/filter proxy for the message tree. While a search is active, only messages that
+ * matched (directly or through a signal) are shown, and under a message that only matched
+ * through signals, only those signals.
+ */
+class MessageFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit MessageFilterProxyModel(MessageTreeModel *model, QObject *parent = nullptr);
+
+    /** Re-applies the filter using the model's current search result. */
+    void setSearchActive(bool active);
+    bool isSearchActive() const { return m_searchActive; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    MessageTreeModel *m_model;
+    bool m_searchActive = false;
+};
+
+#endif // MESSAGEFILTERPROXYMODEL_H
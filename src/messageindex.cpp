@@ -0,0 +1,68 @@
+#include "messageindex.h"
+#include "canmessage.h"
+
+#include <QPair>
+#include <QtAlgorithms>
+#include <QMap>
+
+namespace {
+
+/** Fills the 1-based Eytzinger array from sorted input by an in-order walk of the implicit tree. */
+int fillEytzinger(const QVector<QPair<quint32, qint32>> &sorted, int next, int k, QVector<quint32> &keys,
+                  QVector<qint32> &ordinals)
+{
+    if (k < keys.size()) {
+        next = fillEytzinger(sorted, next, 2 * k, keys, ordinals);
+        keys[k] = sorted.at(next).first;
+        ordinals[k] = sorted.at(next).second;
+        ++next;
+        next = fillEytzinger(sorted, next, 2 * k + 1, keys, ordinals);
+    }
+    return next;
+}
+
+} // namespace
+
+MessageIndex::MessageIndex(const QList<CanMessage *> &messages)
+    : m_size(messages.size())
+{
+    QMap<quint32, qint32> extended; // sorted, last occurrence wins
+    m_standard.fill(-1, int(kStandardIds));
+    for (int i = 0; i < messages.size(); ++i) {
+        const CanMessage *message = messages.at(i);
+        if (!message) {
+            continue;
+        }
+        const quint32 id = message->getId();
+        if (id < kStandardIds) {
+            m_standard[int(id)] = i;
+        } else {
+            extended.insert(id, i);
+        }
+    }
+
+    QVector<QPair<quint32, qint32>> sorted;
+    sorted.reserve(extended.size());
+    for (auto it = extended.constBegin(); it != extended.constEnd(); ++it) {
+        sorted.append(qMakePair(it.key(), it.value()));
+    }
+    m_keys.resize(sorted.size() + 1);
+    m_ordinals.resize(sorted.size() + 1);
+    m_keys[0] = 0;
+    m_ordinals[0] = -1;
+    fillEytzinger(sorted, 0, 1, m_keys, m_ordinals);
+}
+
+int MessageIndex::extendedOrdinal(quint32 id) const
+{
+    const quint32 *keys = m_keys.constData();
+    const quint32 n = quint32(m_keys.size());
+    quint32 k = 1;
+    // Descend without branching on the comparison; k ends one level below the last node visited.
+    while (k < n) {
+        k = 2 * k + (keys[k] < id ? 1 : 0);
+    }
+    // Drop the trailing right turns plus one left turn: k becomes the lower bound (0 = none).
+    k >>= qCountTrailingZeroBits(~k) + 1;
+    return k != 0 && keys[k] == id ? m_ordinals.at(int(k)) : -1;
+}
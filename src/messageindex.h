@@ -0,0 +1,48 @@
+#ifndef MESSAGEINDEX_H
+#define MESSAGEINDEX_H
+
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+class CanMessage;
+
+/**
+ * Immutable frame-ID -> message ordinal index for decode dispatch. The ordinal is the position
+ * in the message list the index was built from, so per-message tables (e.g. DecodePlan) can be
+ * plain vectors in the same order.
+ *
+ * Standard 11-bit IDs use a direct 2048-entry table; other IDs (29-bit, stored with bit 31 set)
+ * live in a sorted array in Eytzinger (BFS) order, searched without data-dependent branches.
+ * When an ID occurs more than once the last message wins, as in DbcParser::getMessage().
+ */
+class MessageIndex
+{
+public:
+    static const quint32 kStandardIds = 0x800;
+
+    MessageIndex() = default;
+    explicit MessageIndex(const QList<CanMessage *> &messages);
+
+    /** Ordinal of the message with this ID (DBC form: bit 31 set for extended frames), or -1. */
+    int ordinal(quint32 id) const
+    {
+        if (id < kStandardIds) {
+            return m_standard.isEmpty() ? -1 : m_standard.at(int(id));
+        }
+        return extendedOrdinal(id);
+    }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+private:
+    int extendedOrdinal(quint32 id) const;
+
+    QVector<qint32> m_standard;     // kStandardIds entries, -1 = no message
+    QVector<quint32> m_keys;        // Eytzinger order, 1-based (slot 0 unused)
+    QVector<qint32> m_ordinals;     // parallel to m_keys
+    int m_size = 0;
+};
+
+#endif // MESSAGEINDEX_H
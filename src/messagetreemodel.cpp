@@ -0,0 +1,472 @@
+#include "messagetreemodel.h"
+
+#include "canmessage.h"
+#include "cansignal.h"
+#include "dbcparser.h"
+#include "editcommands.h"
+
+#include <QBrush>
+#include <QUndoStack>
+
+namespace {
+const QColor kSearchHighlight(255, 236, 140);
+
+QString cycleText(const CanMessage *message)
+{
+    const QString sendType = message->getSendType().isEmpty() ? QStringLiteral("N/A") : message->getSendType();
+    return message->getCycleTime() > 0
+        ? QString("%1 ms (%2)").arg(message->getCycleTime()).arg(sendType)
+        : sendType;
+}
+} // namespace
+
+MessageTreeModel::MessageTreeModel(DbcParser *parser, QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_parser(parser)
+{
+    m_snapshots.reset(*m_parser);
+    m_searchIndex.rebuild(m_parser->getMessages());
+}
+
+// Message rows carry no internal pointer; signal rows carry their parent message.
+QModelIndex MessageTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        if (row >= m_parser->getMessages().size()) {
+            return QModelIndex();
+        }
+        return createIndex(row, column);
+    }
+    CanMessage *message = messageAt(parent);
+    if (!message || row >= rowCount(parent)) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, message);
+}
+
+QModelIndex MessageTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || !child.internalPointer()) {
+        return QModelIndex();
+    }
+    const CanMessage *message = static_cast<const CanMessage *>(child.internalPointer());
+    const int row = rowOfMessage(message);
+    return row >= 0 ? createIndex(row, 0) : QModelIndex();
+}
+
+int MessageTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return m_parser->getMessages().size();
+    }
+    if (parent.column() != 0) {
+        return 0;
+    }
+    const CanMessage *message = messageAt(parent);
+    if (!message || !m_fetched.contains(message)) {
+        return 0;
+    }
+    return message->getSignals().size();
+}
+
+int MessageTreeModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+bool MessageTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return !m_parser->getMessages().isEmpty();
+    }
+    const CanMessage *message = messageAt(parent);
+    return message && parent.column() == 0 && !message->getSignals().isEmpty();
+}
+
+bool MessageTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    const CanMessage *message = messageAt(parent);
+    return message && !m_fetched.contains(message) && !message->getSignals().isEmpty();
+}
+
+void MessageTreeModel::fetchMore(const QModelIndex &parent)
+{
+    CanMessage *message = messageAt(parent);
+    if (!message || m_fetched.contains(message)) {
+        return;
+    }
+    const int count = message->getSignals().size();
+    if (count == 0) {
+        m_fetched.insert(message);
+        return;
+    }
+    beginInsertRows(parent.sibling(parent.row(), 0), 0, count - 1);
+    m_fetched.insert(message);
+    endInsertRows();
+}
+
+QVariant MessageTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    if (!index.internalPointer()) {
+        const CanMessage *message = m_parser->getMessages().value(index.row());
+        if (!message) {
+            return QVariant();
+        }
+        if (role == Qt::DisplayRole || role == Qt::EditRole) {
+            switch (index.column()) {
+            case ColumnId: return message->getFormattedId();
+            case ColumnName: return message->getName();
+            case ColumnLength: return QString::number(message->getLength());
+            case ColumnTransmitter: return message->getTransmitter();
+            case ColumnCycleTime: return cycleText(message);
+            default: break;
+            }
+        } else if (role == Qt::BackgroundRole) {
+            if (m_searchResult.matchedMessages.contains(message)) {
+                return QBrush(kSearchHighlight);
+            }
+        } else if (role == SortRole) {
+            switch (index.column()) {
+            case ColumnId: return message->getId();
+            case ColumnName: return message->getName();
+            case ColumnLength: return message->getLength();
+            case ColumnTransmitter: return message->getTransmitter();
+            case ColumnCycleTime: return message->getCycleTime();
+            default: break;
+            }
+        }
+        return QVariant();
+    }
+
+    const CanSignal *signal = signalAt(index);
+    if (!signal) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case 0: return signal->getName();
+        case 1: return QString("Bit %1").arg(signal->getStartBit());
+        case 2: return QString("%1 bits").arg(signal->getLength());
+        case 3: return signal->getUnit();
+        case 4: return signal->getReceiversAsString();
+        default: break;
+        }
+    } else if (role == Qt::BackgroundRole) {
+        if (m_searchResult.matchedSignals.contains(signal)) {
+            return QBrush(kSearchHighlight);
+        }
+    } else if (role == SortRole) {
+        switch (index.column()) {
+        case 0: return signal->getName();
+        case 1: return signal->getStartBit();
+        case 2: return signal->getLength();
+        case 3: return signal->getUnit();
+        case 4: return signal->getReceiversAsString();
+        default: break;
+        }
+    }
+    return QVariant();
+}
+
+bool MessageTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole) {
+        return false;
+    }
+    CanMessage *message = messageAt(index);
+    if (!message) {
+        return false;
+    }
+
+    const QString text = value.toString().trimmed();
+    const QString commandText = tr("Edit %1 of %2")
+        .arg(headerData(index.column(), Qt::Horizontal).toString(), message->getName());
+    QUndoCommand *command = nullptr;
+    switch (index.column()) {
+    case ColumnId: {
+        bool ok = false;
+        const quint32 id = text.startsWith(QStringLiteral("0x"), Qt::CaseInsensitive)
+            ? text.toUInt(&ok, 16)
+            : text.toUInt(&ok, 10);
+        if (!ok) {
+            emit editRejected(tr("无效的报文ID：%1").arg(text));
+            return false;
+        }
+        if (id == message->getId()) {
+            return true;
+        }
+        command = new SetMessageFieldCommand<quint32>(this, message, message, &CanMessage::setId,
+                                                      message->getId(), id, commandText);
+        break;
+    }
+    case ColumnName:
+        if (text == message->getName()) {
+            return true;
+        }
+        command = new SetMessageFieldCommand<QString>(this, message, message, &CanMessage::setName,
+                                                      message->getName(), text, commandText);
+        break;
+    case ColumnLength: {
+        bool ok = false;
+        const int length = text.toInt(&ok);
+        if (!ok || length < 0) {
+            emit editRejected(tr("无效的报文长度：%1").arg(text));
+            return false;
+        }
+        if (length == message->getLength()) {
+            return true;
+        }
+        command = new SetMessageFieldCommand<int>(this, message, message, &CanMessage::setLength,
+                                                  message->getLength(), length, commandText);
+        break;
+    }
+    case ColumnTransmitter:
+        if (text == message->getTransmitter()) {
+            return true;
+        }
+        command = new SetMessageFieldCommand<QString>(this, message, message, &CanMessage::setTransmitter,
+                                                      message->getTransmitter(), text, commandText);
+        break;
+    default:
+        return false;
+    }
+
+    // The command applies the value and emits dataChanged through messageChanged().
+    pushEdit(command);
+    return true;
+}
+
+QVariant MessageTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case ColumnId: return QStringLiteral("ID");
+    case ColumnName: return QStringLiteral("Name");
+    case ColumnLength: return QStringLiteral("Length");
+    case ColumnTransmitter: return QStringLiteral("Transmitter");
+    case ColumnCycleTime: return QStringLiteral("Cycle Time");
+    default: return QVariant();
+    }
+}
+
+Qt::ItemFlags MessageTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    Qt::ItemFlags f = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    // Signal rows stay read-only here; signals are edited in the signal table.
+    if (!index.internalPointer() && index.column() <= ColumnTransmitter) {
+        f |= Qt::ItemIsEditable;
+    }
+    return f;
+}
+
+CanMessage *MessageTreeModel::messageAt(const QModelIndex &index) const
+{
+    if (!index.isValid() || index.internalPointer()) {
+        return nullptr;
+    }
+    return m_parser->getMessages().value(index.row());
+}
+
+CanSignal *MessageTreeModel::signalAt(const QModelIndex &index) const
+{
+    if (!index.isValid() || !index.internalPointer()) {
+        return nullptr;
+    }
+    const CanMessage *message = static_cast<const CanMessage *>(index.internalPointer());
+    return message->getSignals().value(index.row());
+}
+
+QModelIndex MessageTreeModel::indexOfMessage(const CanMessage *message, int column) const
+{
+    const int row = rowOfMessage(message);
+    return row >= 0 ? createIndex(row, column) : QModelIndex();
+}
+
+void MessageTreeModel::reload()
+{
+    beginResetModel();
+    m_parser->rebuildMessageIndex();
+    m_fetched.clear();
+    invalidateRows();
+    m_snapshots.reset(*m_parser);
+    m_searchIndex.rebuild(m_parser->getMessages());
+    endResetModel();
+}
+
+void MessageTreeModel::swapDatabase(DbcParser &loaded)
+{
+    beginResetModel();
+    m_parser->swap(loaded);
+    m_fetched.clear();
+    invalidateRows();
+    m_snapshots.reset(*m_parser);
+    m_searchIndex.rebuild(m_parser->getMessages());
+    m_searchResult = SearchResult();
+    endResetModel();
+}
+
+void MessageTreeModel::setSearchResult(const SearchResult &result)
+{
+    m_searchResult = result;
+    // Views re-read BackgroundRole on repaint; the filter proxy re-filters on its own.
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, ColumnCount - 1), {Qt::BackgroundRole});
+    }
+}
+
+void MessageTreeModel::pushEdit(QUndoCommand *command)
+{
+    if (m_undoStack) {
+        m_undoStack->push(command);
+    } else {
+        command->redo();
+        delete command;
+    }
+}
+
+void MessageTreeModel::insertMessage(int row, CanMessage *message)
+{
+    if (!message) {
+        return;
+    }
+    const int count = m_parser->getMessages().size();
+    if (row < 0 || row > count) {
+        row = count;
+    }
+    beginInsertRows(QModelIndex(), row, row);
+    m_parser->insertMessage(row, message);
+    invalidateRows();
+    m_snapshots.messageInserted(row, *message);
+    m_searchIndex.addMessage(message);
+    endInsertRows();
+}
+
+int MessageTreeModel::takeMessage(CanMessage *message)
+{
+    const int row = rowOfMessage(message);
+    if (row < 0) {
+        return -1;
+    }
+    emit messageAboutToBeRemoved(message);
+    beginRemoveRows(QModelIndex(), row, row);
+    m_fetched.remove(message);
+    m_parser->takeMessage(message);
+    invalidateRows();
+    m_snapshots.messageRemoved(row);
+    m_searchIndex.removeMessage(message);
+    endRemoveRows();
+    return row;
+}
+
+void MessageTreeModel::insertSignal(CanMessage *message, int row, CanSignal *signal)
+{
+    if (!message || !signal) {
+        return;
+    }
+    const int count = message->getSignals().size();
+    if (row < 0 || row > count) {
+        row = count;
+    }
+    const QModelIndex parentIndex = indexOfMessage(message);
+    if (parentIndex.isValid() && m_fetched.contains(message)) {
+        beginInsertRows(parentIndex, row, row);
+        message->insertSignal(row, signal);
+        endInsertRows();
+    } else {
+        message->insertSignal(row, signal);
+        // The expand indicator appears with the first signal.
+        if (parentIndex.isValid() && count == 0) {
+            emit dataChanged(parentIndex, parentIndex.sibling(parentIndex.row(), ColumnCount - 1));
+        }
+    }
+    m_snapshots.signalListChanged(parentIndex.row(), *message);
+    m_searchIndex.addSignal(message, signal);
+    emit signalListChanged(message);
+}
+
+int MessageTreeModel::removeSignal(CanMessage *message, CanSignal *signal)
+{
+    if (!message || !signal) {
+        return -1;
+    }
+    const int row = message->getSignals().indexOf(signal);
+    if (row < 0) {
+        return -1;
+    }
+    const QModelIndex parentIndex = indexOfMessage(message);
+    if (parentIndex.isValid() && m_fetched.contains(message)) {
+        beginRemoveRows(parentIndex, row, row);
+        message->removeSignal(signal);
+        endRemoveRows();
+    } else {
+        message->removeSignal(signal);
+    }
+    m_snapshots.signalListChanged(rowOfMessage(message), *message);
+    m_searchIndex.removeSignal(signal);
+    emit signalListChanged(message);
+    return row;
+}
+
+void MessageTreeModel::messageChanged(CanMessage *message)
+{
+    const QModelIndex first = indexOfMessage(message);
+    if (first.isValid()) {
+        if (m_parser->getMessage(message->getId()) != message) {
+            m_parser->rebuildMessageIndex(); // ID edited (or undone) in place
+        }
+        m_snapshots.messageChanged(first.row(), *message);
+        m_searchIndex.updateMessage(message);
+        emit dataChanged(first, first.sibling(first.row(), ColumnCount - 1));
+    }
+    emit messageUpdated(message);
+}
+
+void MessageTreeModel::signalChanged(CanMessage *message, CanSignal *signal)
+{
+    if (!message || !signal) {
+        return;
+    }
+    const int row = message->getSignals().indexOf(signal);
+    if (row >= 0) {
+        m_snapshots.signalChanged(rowOfMessage(message), row, *signal);
+        m_searchIndex.updateSignal(message, signal);
+    }
+    if (row >= 0 && m_fetched.contains(message)) {
+        const QModelIndex first = createIndex(row, 0, message);
+        emit dataChanged(first, first.sibling(row, ColumnCount - 1));
+    }
+    emit signalUpdated(message, signal);
+}
+
+int MessageTreeModel::rowOfMessage(const CanMessage *message) const
+{
+    if (!message) {
+        return -1;
+    }
+    if (m_rowCache.isEmpty()) {
+        const QList<CanMessage *> &messages = m_parser->getMessages();
+        m_rowCache.reserve(messages.size());
+        for (int i = 0; i < messages.size(); ++i) {
+            m_rowCache.insert(messages.at(i), i);
+        }
+    }
+    return m_rowCache.value(message, -1);
+}
+
+void MessageTreeModel::invalidateRows()
+{
+    m_rowCache.clear();
+}
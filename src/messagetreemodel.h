@@ -0,0 +1,117 @@
+#ifndef MESSAGETREEMODEL_H
+#define MESSAGETREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QSet>
+
+#include "dbcsnapshot.h"
+#include "searchindex.h"
+
+class DbcParser;
+class CanMessage;
+class CanSignal;
+class QUndoCommand;
+class QUndoStack;
+
+/**
+ * Item model over DbcParser's messages: one top-level row per message, one child row per
+ * signal. Rows are read straight from the parser; signal rows are only created when a
+ * message is expanded (canFetchMore/fetchMore). Structural edits go through the model so
+ * views get fine-grained insert/remove/dataChanged notifications instead of a rebuild.
+ * With an undo stack set, setData() pushes field commands instead of editing directly.
+ * Every change is also mirrored into a DbcSnapshotTracker, so snapshot() is O(1), and
+ * into a SearchIndex, so search() never rescans the database.
+ */
+class MessageTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnId,
+        ColumnName,
+        ColumnLength,
+        ColumnTransmitter,
+        ColumnCycleTime,
+        ColumnCount
+    };
+
+    /** Typed value for sorting (numeric IDs/lengths instead of their display text). */
+    static constexpr int SortRole = Qt::UserRole + 1;
+
+    explicit MessageTreeModel(DbcParser *parser, QObject *parent = nullptr);
+
+    void setUndoStack(QUndoStack *stack) { m_undoStack = stack; }
+    QUndoStack *undoStack() const { return m_undoStack; }
+    /** Pushes command onto the undo stack, or just runs it when there is none. */
+    void pushEdit(QUndoCommand *command);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /** Null for signal rows. */
+    CanMessage *messageAt(const QModelIndex &index) const;
+    /** Null for message rows. */
+    CanSignal *signalAt(const QModelIndex &index) const;
+    QModelIndex indexOfMessage(const CanMessage *message, int column = 0) const;
+    /** Immutable copy of the current database; O(1), shares data with the live objects. */
+    DbcSnapshot snapshot() const { return m_snapshots.current(); }
+
+    SearchResult search(const QString &query) const { return m_searchIndex.search(query); }
+    /** Result used for highlighting (BackgroundRole) and by MessageFilterProxyModel. */
+    const SearchResult &searchResult() const { return m_searchResult; }
+    void setSearchResult(const SearchResult &result);
+
+    /** Re-reads everything from the parser (after load/revert). */
+    void reload();
+    /** Exchanges the parser's database with loaded inside one model reset. */
+    void swapDatabase(DbcParser &loaded);
+    /** Inserts into the parser at row (appends when row < 0) and inserts one row. */
+    void insertMessage(int row, CanMessage *message);
+    /** Removes the row and detaches the message; the caller owns it afterwards. Returns the former row. */
+    int takeMessage(CanMessage *message);
+    /** Inserts at row of the message's signal list (appends when row < 0). */
+    void insertSignal(CanMessage *message, int row, CanSignal *signal);
+    /** Detaches the signal from its message; the caller owns it afterwards. Returns the former row. */
+    int removeSignal(CanMessage *message, CanSignal *signal);
+    /** Call after changing a message or signal outside the model. */
+    void messageChanged(CanMessage *message);
+    void signalChanged(CanMessage *message, CanSignal *signal);
+
+signals:
+    /** A message field changed (edit, undo or redo). */
+    void messageUpdated(CanMessage *message);
+    /** A signal field changed (edit, undo or redo). */
+    void signalUpdated(CanMessage *message, CanSignal *signal);
+    /** Signals were added to or removed from message. */
+    void signalListChanged(CanMessage *message);
+    /** Emitted before message is detached from the parser. */
+    void messageAboutToBeRemoved(CanMessage *message);
+    /** An edit was refused; reason is user-visible. */
+    void editRejected(const QString &reason);
+
+private:
+    int rowOfMessage(const CanMessage *message) const;
+    void invalidateRows();
+
+    DbcParser *m_parser;
+    QUndoStack *m_undoStack = nullptr;
+    DbcSnapshotTracker m_snapshots;
+    SearchIndex m_searchIndex;
+    SearchResult m_searchResult;
+    QSet<const CanMessage *> m_fetched;
+    mutable QHash<const CanMessage *, int> m_rowCache;
+};
+
+#endif // MESSAGETREEMODEL_H
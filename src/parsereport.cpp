@@ -0,0 +1,137 @@
+#include "parsereport.h"
+
+#include <QJsonArray>
+#include <QStringList>
+#include <QVector>
+
+#include <algorithm>
+
+namespace {
+const int kMaxIssueText = 160;
+
+/** Keywords ordered by cumulative time, slowest first. */
+QVector<QString> keywordsByTime(const QMap<QString, ParseReport::RecordStats> &records)
+{
+    QVector<QString> keywords;
+    keywords.reserve(records.size());
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+        keywords.append(it.key());
+    }
+    std::stable_sort(keywords.begin(), keywords.end(), [&](const QString &a, const QString &b) {
+        return records.value(a).nanoseconds > records.value(b).nanoseconds;
+    });
+    return keywords;
+}
+} // namespace
+
+void ParseReport::addIssue(IssueKind kind, int line, int column, const QString &keyword, const QString &message,
+                           const QString &text)
+{
+    ++issueCounts[kind];
+    if (kind != Unknown) {
+        ++records[keyword].failed;
+    }
+    if (issues.size() >= kMaxIssues) {
+        return;
+    }
+    Issue issue;
+    issue.kind = kind;
+    issue.line = line;
+    issue.column = column;
+    issue.keyword = keyword;
+    issue.message = message;
+    issue.text = text.size() > kMaxIssueText ? text.left(kMaxIssueText) + QStringLiteral("...") : text;
+    issues.append(issue);
+}
+
+QString ParseReport::kindName(IssueKind kind)
+{
+    switch (kind) {
+    case Malformed: return QStringLiteral("malformed");
+    case Unknown: return QStringLiteral("unknown");
+    case Dropped: return QStringLiteral("dropped");
+    }
+    return QString();
+}
+
+QJsonObject ParseReport::toJson() const
+{
+    QJsonObject root;
+    root.insert("file", filePath);
+    root.insert("bytes", bytes);
+    root.insert("lines", lineCount);
+    root.insert("totalMs", totalNanoseconds / 1e6);
+
+    QJsonArray recordArray;
+    for (const QString &keyword : keywordsByTime(records)) {
+        const RecordStats &stats = records[keyword];
+        QJsonObject record;
+        record.insert("keyword", keyword);
+        record.insert("count", stats.count);
+        record.insert("failed", stats.failed);
+        record.insert("ignored", stats.ignored);
+        record.insert("ms", stats.nanoseconds / 1e6);
+        recordArray.append(record);
+    }
+    root.insert("records", recordArray);
+
+    QJsonObject attributes;
+    for (auto it = ignoredAttributes.constBegin(); it != ignoredAttributes.constEnd(); ++it) {
+        attributes.insert(it.key(), it.value());
+    }
+    root.insert("ignoredAttributes", attributes);
+
+    QJsonObject counts;
+    for (int kind = Malformed; kind <= Dropped; ++kind) {
+        counts.insert(kindName(IssueKind(kind)), issueCounts[kind]);
+    }
+    root.insert("issueCounts", counts);
+
+    QJsonArray issueArray;
+    for (const Issue &issue : issues) {
+        QJsonObject object;
+        object.insert("kind", kindName(issue.kind));
+        object.insert("line", issue.line);
+        object.insert("column", issue.column);
+        object.insert("keyword", issue.keyword);
+        object.insert("message", issue.message);
+        object.insert("text", issue.text);
+        issueArray.append(object);
+    }
+    root.insert("issues", issueArray);
+    return root;
+}
+
+QString ParseReport::toText() const
+{
+    QString text = QString("%1: %2 lines, %3 bytes, %4 ms\n")
+                       .arg(filePath).arg(lineCount).arg(bytes).arg(totalNanoseconds / 1e6, 0, 'f', 1);
+    text += QString("  %1 %2 %3 %4\n").arg(QStringLiteral("keyword"), -20).arg(QStringLiteral("count"), 9)
+                .arg(QStringLiteral("failed"), 7).arg(QStringLiteral("ms"), 10);
+    for (const QString &keyword : keywordsByTime(records)) {
+        const RecordStats &stats = records[keyword];
+        text += QString("  %1 %2 %3 %4%5\n")
+                    .arg(keyword, -20)
+                    .arg(stats.count, 9)
+                    .arg(stats.failed, 7)
+                    .arg(stats.nanoseconds / 1e6, 10, 'f', 2)
+                    .arg(stats.ignored ? QStringLiteral("  (not imported)") : QString());
+    }
+    if (!ignoredAttributes.isEmpty()) {
+        QStringList names;
+        for (auto it = ignoredAttributes.constBegin(); it != ignoredAttributes.constEnd(); ++it) {
+            names << QString("%1 x%2").arg(it.key()).arg(it.value());
+        }
+        text += QString("  attributes not imported: %1\n").arg(names.join(QStringLiteral(", ")));
+    }
+    text += QString("  issues: %1 malformed, %2 unknown, %3 dropped\n")
+                .arg(issueCounts[Malformed]).arg(issueCounts[Unknown]).arg(issueCounts[Dropped]);
+    for (const Issue &issue : issues) {
+        text += QString("  %1:%2: %3: %4: %5\n")
+                    .arg(issue.line).arg(issue.column).arg(kindName(issue.kind), issue.message, issue.text);
+    }
+    if (issues.size() < issueCount()) {
+        text += QString("  ... %1 more issue(s) not listed\n").arg(issueCount() - issues.size());
+    }
+    return text;
+}
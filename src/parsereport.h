@@ -0,0 +1,64 @@
+#ifndef PARSEREPORT_H
+#define PARSEREPORT_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+/**
+ * What DbcParser::parseFile did with a file: per-keyword record counts and cumulative
+ * parse time, plus malformed/unknown lines and entities that were dropped on the way.
+ */
+struct ParseReport
+{
+    enum IssueKind
+    {
+        Malformed,  // known keyword, but the record did not match its syntax
+        Unknown,    // unrecognised keyword (or a continuation of a multi-line record)
+        Dropped,    // well-formed, but its data could not be attached (e.g. VAL_ for a missing signal)
+    };
+
+    struct RecordStats
+    {
+        int count = 0;
+        int failed = 0;       // Malformed + Dropped issues raised by this record type
+        bool ignored = false; // recognised DBC keyword that the model does not import
+        qint64 nanoseconds = 0;
+    };
+
+    struct Issue
+    {
+        IssueKind kind = Malformed;
+        int line = 0;      // 1-based
+        int column = 0;    // 1-based, where the record starts
+        QString keyword;
+        QString message;
+        QString text;      // the offending line (truncated)
+    };
+
+    /** At most this many issues are stored; issueCounts keeps the full totals. */
+    static const int kMaxIssues = 1000;
+
+    QString filePath;
+    qint64 bytes = 0;
+    int lineCount = 0;
+    qint64 totalNanoseconds = 0;
+    QMap<QString, RecordStats> records;     // keyword -> stats
+    QMap<QString, int> ignoredAttributes;   // BA_ attribute name -> occurrences not imported
+    QList<Issue> issues;
+    int issueCounts[3] = {0, 0, 0};
+
+    bool isEmpty() const { return lineCount == 0; }
+    int issueCount() const { return issueCounts[Malformed] + issueCounts[Unknown] + issueCounts[Dropped]; }
+    void clear() { *this = ParseReport(); }
+    void addIssue(IssueKind kind, int line, int column, const QString &keyword, const QString &message,
+                  const QString &text);
+
+    static QString kindName(IssueKind kind);
+    QJsonObject toJson() const;
+    /** Human-readable summary: keyword table sorted by time, then the issue list. */
+    QString toText() const;
+};
+
+#endif // PARSEREPORT_H
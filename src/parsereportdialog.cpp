@@ -0,0 +1,132 @@
+#include "parsereportdialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+QString kindText(ParseReport::IssueKind kind)
+{
+    switch (kind) {
+    case ParseReport::Malformed: return QObject::tr("格式错误");
+    case ParseReport::Unknown: return QObject::tr("未知");
+    case ParseReport::Dropped: return QObject::tr("已丢弃");
+    }
+    return QString();
+}
+
+/** QTreeWidgetItem that sorts numeric columns by value. */
+class NumericItem : public QTreeWidgetItem
+{
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem &other) const override
+    {
+        const int column = treeWidget() ? treeWidget()->sortColumn() : 0;
+        bool ok = false;
+        bool otherOk = false;
+        const double value = text(column).toDouble(&ok);
+        const double otherValue = other.text(column).toDouble(&otherOk);
+        if (ok && otherOk) {
+            return value < otherValue;
+        }
+        return QTreeWidgetItem::operator<(other);
+    }
+};
+} // namespace
+
+ParseReportDialog::ParseReportDialog(const ParseReport &report, QWidget *parent)
+    : QDialog(parent)
+    , m_report(report)
+{
+    setWindowTitle(tr("Parse Report: %1").arg(QFileInfo(report.filePath).fileName()));
+    resize(900, 600);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QString summary = tr("%1 行，%2 字节，解析耗时 %3 ms；格式错误 %4 条，未知 %5 条，丢弃 %6 条")
+                          .arg(report.lineCount)
+                          .arg(report.bytes)
+                          .arg(report.totalNanoseconds / 1e6, 0, 'f', 1)
+                          .arg(report.issueCounts[ParseReport::Malformed])
+                          .arg(report.issueCounts[ParseReport::Unknown])
+                          .arg(report.issueCounts[ParseReport::Dropped]);
+    if (report.issues.size() < report.issueCount()) {
+        summary += tr("（仅列出前 %1 条）").arg(report.issues.size());
+    }
+    QLabel *summaryLabel = new QLabel(summary, this);
+    summaryLabel->setWordWrap(true);
+    layout->addWidget(summaryLabel);
+
+    m_records = new QTreeWidget(this);
+    m_records->setRootIsDecorated(false);
+    m_records->setUniformRowHeights(true);
+    m_records->setHeaderLabels(QStringList() << tr("Keyword") << tr("Count") << tr("Failed") << tr("Time (ms)")
+                                             << tr("Note"));
+    for (auto it = report.records.constBegin(); it != report.records.constEnd(); ++it) {
+        QTreeWidgetItem *item = new NumericItem(m_records);
+        item->setText(0, it.key());
+        item->setText(1, QString::number(it.value().count));
+        item->setText(2, QString::number(it.value().failed));
+        item->setText(3, QString::number(it.value().nanoseconds / 1e6, 'f', 2));
+        item->setText(4, it.value().ignored ? tr("未导入") : QString());
+        for (int column = 1; column <= 3; ++column) {
+            item->setTextAlignment(column, Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+    m_records->setSortingEnabled(true);
+    m_records->sortByColumn(3, Qt::DescendingOrder);
+    m_records->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    m_issues = new QTreeWidget(this);
+    m_issues->setRootIsDecorated(false);
+    m_issues->setUniformRowHeights(true);
+    m_issues->setHeaderLabels(QStringList() << tr("Line") << tr("Column") << tr("Kind") << tr("Keyword")
+                                            << tr("Message") << tr("Text"));
+    for (const ParseReport::Issue &issue : report.issues) {
+        QTreeWidgetItem *item = new NumericItem(m_issues);
+        item->setText(0, QString::number(issue.line));
+        item->setText(1, QString::number(issue.column));
+        item->setText(2, kindText(issue.kind));
+        item->setText(3, issue.keyword);
+        item->setText(4, issue.message);
+        item->setText(5, issue.text);
+    }
+    m_issues->setSortingEnabled(true);
+    m_issues->sortByColumn(0, Qt::AscendingOrder);
+    m_issues->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(m_records);
+    splitter->addWidget(m_issues);
+    splitter->setSizes(QList<int>() << 250 << 350);
+    layout->addWidget(splitter);
+
+    if (!report.ignoredAttributes.isEmpty()) {
+        QStringList names;
+        for (auto it = report.ignoredAttributes.constBegin(); it != report.ignoredAttributes.constEnd(); ++it) {
+            names << QString("%1 ×%2").arg(it.key()).arg(it.value());
+        }
+        QLabel *attributes = new QLabel(tr("未导入的属性：%1").arg(names.join(QStringLiteral(", "))), this);
+        attributes->setWordWrap(true);
+        layout->addWidget(attributes);
+    }
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *copyButton = buttons->addButton(tr("Copy as Text"), QDialogButtonBox::ActionRole);
+    connect(copyButton, &QPushButton::clicked, this, &ParseReportDialog::copyReport);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttons);
+}
+
+void ParseReportDialog::copyReport()
+{
+    QApplication::clipboard()->setText(m_report.toText());
+}
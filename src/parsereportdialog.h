@@ -0,0 +1,29 @@
+#ifndef PARSEREPORTDIALOG_H
+#define PARSEREPORTDIALOG_H
+
+#include <QDialog>
+
+#include "parsereport.h"
+
+class QTreeWidget;
+
+/**
+ * Shows the parse report of the loaded DBC: time and record count per keyword (slowest
+ * first), attributes that were not imported, and every malformed, unknown or dropped line.
+ */
+class ParseReportDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ParseReportDialog(const ParseReport &report, QWidget *parent = nullptr);
+
+private:
+    void copyReport();
+
+    ParseReport m_report;
+    QTreeWidget *m_records;
+    QTreeWidget *m_issues;
+};
+
+#endif // PARSEREPORTDIALOG_H
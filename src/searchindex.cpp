@@ -0,0 +1,223 @@
+#include "searchindex.h"
+
+#include <algorithm>
+
+#include "canmessage.h"
+#include "cansignal.h"
+
+namespace {
+constexpr int kTrigram = 3;
+
+quint64 trigramAt(const QString &text, int i)
+{
+    return (quint64(text.at(i).unicode()) << 32)
+        | (quint64(text.at(i + 1).unicode()) << 16)
+        | quint64(text.at(i + 2).unicode());
+}
+
+QString messageText(const CanMessage *message)
+{
+    QStringList parts;
+    parts << message->getName()
+          << message->getFormattedId()
+          << QString::number(message->getId())
+          << message->getTransmitter()
+          << message->getComment();
+    return parts.join(QLatin1Char('\n')).toCaseFolded();
+}
+
+QString signalText(const CanSignal *signal)
+{
+    QStringList parts;
+    parts << signal->getName()
+          << signal->getDescription()
+          << signal->getUnit()
+          << signal->getReceivers().join(QLatin1Char(' '));
+    const QMap<int, QString> &valueTable = signal->getValueTable();
+    for (auto it = valueTable.constBegin(); it != valueTable.constEnd(); ++it) {
+        parts << it.value();
+    }
+    return parts.join(QLatin1Char('\n')).toCaseFolded();
+}
+
+/** Sorted intersection of two ascending id lists. */
+QVector<int> intersect(const QVector<int> &a, const QVector<int> &b)
+{
+    QVector<int> out;
+    out.reserve(qMin(a.size(), b.size()));
+    std::set_intersection(a.constBegin(), a.constEnd(), b.constBegin(), b.constEnd(), std::back_inserter(out));
+    return out;
+}
+} // namespace
+
+void SearchIndex::clear()
+{
+    m_documents.clear();
+    m_documentOf.clear();
+    m_postings.clear();
+    m_deadCount = 0;
+}
+
+void SearchIndex::rebuild(const QList<CanMessage *> &messages)
+{
+    clear();
+    for (CanMessage *message : messages) {
+        addMessage(message);
+    }
+}
+
+void SearchIndex::addMessage(CanMessage *message)
+{
+    if (!message) {
+        return;
+    }
+    addDocument(message, nullptr);
+    for (CanSignal *signal : message->getSignals()) {
+        addSignal(message, signal);
+    }
+}
+
+void SearchIndex::removeMessage(CanMessage *message)
+{
+    if (!message) {
+        return;
+    }
+    removeDocument(message);
+    for (const CanSignal *signal : message->getSignals()) {
+        removeDocument(signal);
+    }
+    compactIfNeeded();
+}
+
+void SearchIndex::updateMessage(CanMessage *message)
+{
+    if (!message || !m_documentOf.contains(message)) {
+        return;
+    }
+    removeDocument(message);
+    addDocument(message, nullptr);
+    compactIfNeeded();
+}
+
+void SearchIndex::addSignal(CanMessage *message, CanSignal *signal)
+{
+    if (message && signal) {
+        addDocument(message, signal);
+    }
+}
+
+void SearchIndex::removeSignal(CanSignal *signal)
+{
+    removeDocument(signal);
+    compactIfNeeded();
+}
+
+void SearchIndex::updateSignal(CanMessage *message, CanSignal *signal)
+{
+    if (!signal || !m_documentOf.contains(signal)) {
+        return;
+    }
+    removeDocument(signal);
+    addDocument(message, signal);
+    compactIfNeeded();
+}
+
+SearchResult SearchIndex::search(const QString &query) const
+{
+    SearchResult result;
+    const QString needle = query.trimmed().toCaseFolded();
+    if (needle.isEmpty()) {
+        return result;
+    }
+
+    auto accept = [&](const Document &doc) {
+        if (!doc.alive || !doc.text.contains(needle)) {
+            return;
+        }
+        if (doc.signal) {
+            result.matchedSignals.insert(doc.signal);
+            result.parentMessages.insert(doc.message);
+        } else {
+            result.matchedMessages.insert(doc.message);
+        }
+    };
+
+    if (needle.size() < kTrigram) {
+        // Too short for trigrams: a linear scan over the (small) document texts.
+        for (const Document &doc : m_documents) {
+            accept(doc);
+        }
+        return result;
+    }
+
+    // Collect the query's posting lists, shortest first, and intersect.
+    QVector<const QVector<int> *> lists;
+    for (int i = 0; i + kTrigram <= needle.size(); ++i) {
+        const auto it = m_postings.constFind(trigramAt(needle, i));
+        if (it == m_postings.constEnd()) {
+            return result;
+        }
+        if (!lists.contains(&it.value())) {
+            lists.append(&it.value());
+        }
+    }
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+    QVector<int> candidates = *lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        candidates = intersect(candidates, *lists.at(i));
+    }
+
+    for (int id : candidates) {
+        accept(m_documents.at(id));
+    }
+    return result;
+}
+
+void SearchIndex::addDocument(CanMessage *message, CanSignal *signal)
+{
+    Document doc;
+    doc.message = message;
+    doc.signal = signal;
+    doc.text = signal ? signalText(signal) : messageText(message);
+
+    const int id = m_documents.size();
+    QSet<quint64> seen;
+    for (int i = 0; i + kTrigram <= doc.text.size(); ++i) {
+        const quint64 trigram = trigramAt(doc.text, i);
+        if (!seen.contains(trigram)) {
+            seen.insert(trigram);
+            // Ids only grow, so appending keeps every posting list sorted.
+            m_postings[trigram].append(id);
+        }
+    }
+    m_documents.append(doc);
+    m_documentOf.insert(signal ? static_cast<const void *>(signal) : static_cast<const void *>(message), id);
+}
+
+void SearchIndex::removeDocument(const void *key)
+{
+    const auto it = m_documentOf.find(key);
+    if (it == m_documentOf.end()) {
+        return;
+    }
+    m_documents[it.value()].alive = false;
+    m_documents[it.value()].text.clear();
+    m_documentOf.erase(it);
+    ++m_deadCount;
+}
+
+void SearchIndex::compactIfNeeded()
+{
+    if (m_deadCount < 1024 || m_deadCount < m_documentOf.size()) {
+        return;
+    }
+    const QVector<Document> old = m_documents;
+    clear();
+    for (const Document &doc : old) {
+        if (doc.alive) {
+            addDocument(doc.message, doc.signal);
+        }
+    }
+}
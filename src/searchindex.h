@@ -0,0 +1,72 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class CanMessage;
+class CanSignal;
+
+/** Messages and signals matching a query. */
+struct SearchResult
+{
+    QSet<const CanMessage *> matchedMessages;  // message text itself matched
+    QSet<const CanMessage *> parentMessages;   // messages owning a matched signal
+    QSet<const CanSignal *> matchedSignals;
+
+    bool isEmpty() const { return matchedMessages.isEmpty() && matchedSignals.isEmpty(); }
+    bool containsMessage(const CanMessage *message) const
+    {
+        return matchedMessages.contains(message) || parentMessages.contains(message);
+    }
+};
+
+/**
+ * Case-insensitive substring index over messages (name, ID, comment, transmitter) and
+ * signals (name, description, unit, receivers, value-table labels).
+ *
+ * Each message/signal is a document; a trigram -> sorted document-id posting list narrows
+ * a query to candidates, which are then verified with a substring check. Updates append
+ * a fresh document and tombstone the old one, so postings stay sorted without moving
+ * entries; the index is compacted when tombstones outnumber live documents.
+ */
+class SearchIndex
+{
+public:
+    void rebuild(const QList<CanMessage *> &messages);
+    void clear();
+
+    /** Indexes the message and all of its signals. */
+    void addMessage(CanMessage *message);
+    void removeMessage(CanMessage *message);
+    /** Re-indexes the message's own fields (not its signals). */
+    void updateMessage(CanMessage *message);
+    void addSignal(CanMessage *message, CanSignal *signal);
+    void removeSignal(CanSignal *signal);
+    void updateSignal(CanMessage *message, CanSignal *signal);
+
+    SearchResult search(const QString &query) const;
+
+private:
+    struct Document
+    {
+        CanMessage *message = nullptr;
+        CanSignal *signal = nullptr; // null for message documents
+        QString text;                // case-folded, fields separated by '\n'
+        bool alive = true;
+    };
+
+    void addDocument(CanMessage *message, CanSignal *signal);
+    void removeDocument(const void *key);
+    void compactIfNeeded();
+
+    QVector<Document> m_documents;
+    QHash<const void *, int> m_documentOf; // message or signal -> live document id
+    QHash<quint64, QVector<int>> m_postings;
+    int m_deadCount = 0;
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,73 @@
+#include "signalcodec.h"
+#include "cansignal.h"
+
+QVector<int> SignalCodec::bitPositions(int startBit, int length, bool motorola)
+{
+    QVector<int> positions;
+    if (length < 1 || length > 64) {
+        return positions;
+    }
+    positions.resize(length);
+    int bit = startBit;
+    for (int k = 0; k < length; ++k) {
+        if (motorola) {
+            positions[length - 1 - k] = bit; // walk starts at the MSB
+            bit += (bit % 8 == 0) ? 15 : -1;
+        } else {
+            positions[k] = bit++;
+        }
+    }
+    return positions;
+}
+
+QVector<int> SignalCodec::bitPositions(const CanSignal &signal)
+{
+    return bitPositions(signal.getStartBit(), signal.getLength(), signal.getByteOrder() == 0);
+}
+
+quint64 SignalCodec::extractRaw(const CanSignal &signal, const uchar *data, int size)
+{
+    const QVector<int> positions = bitPositions(signal);
+    quint64 raw = 0;
+    for (int i = 0; i < positions.size(); ++i) {
+        const int bit = positions.at(i);
+        if (bit >= 0 && bit < size * 8 && (data[bit / 8] >> (bit % 8)) & 1) {
+            raw |= quint64(1) << i;
+        }
+    }
+    return raw;
+}
+
+void SignalCodec::insertRaw(const CanSignal &signal, quint64 raw, uchar *data, int size)
+{
+    const QVector<int> positions = bitPositions(signal);
+    for (int i = 0; i < positions.size(); ++i) {
+        const int bit = positions.at(i);
+        if (bit < 0 || bit >= size * 8) {
+            continue;
+        }
+        const uchar mask = uchar(1u << (bit % 8));
+        if ((raw >> i) & 1) {
+            data[bit / 8] |= mask;
+        } else {
+            data[bit / 8] &= uchar(~mask);
+        }
+    }
+}
+
+qint64 SignalCodec::toSigned(quint64 raw, int length)
+{
+    if (length <= 0 || length >= 64) {
+        return qint64(raw);
+    }
+    const quint64 sign = quint64(1) << (length - 1);
+    raw &= (quint64(1) << length) - 1;
+    return qint64((raw ^ sign) - sign);
+}
+
+double SignalCodec::decodePhysical(const CanSignal &signal, const uchar *data, int size)
+{
+    const quint64 raw = extractRaw(signal, data, size);
+    const double value = signal.isSigned() ? double(toSigned(raw, signal.getLength())) : double(raw);
+    return value * signal.getFactor() + signal.getOffset();
+}
@@ -0,0 +1,30 @@
+#ifndef SIGNALCODEC_H
+#define SIGNALCODEC_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class CanSignal;
+
+/**
+ * Generic (bit-by-bit) signal decoder/encoder for frame payloads. Bit numbering follows the
+ * DBC file and the validator: @0 = Motorola (startBit is the MSB, walking down and wrapping
+ * to bit 7 of the next byte), @1 = Intel (startBit is the LSB, walking up).
+ * Bits outside the payload read as 0 and are not written.
+ */
+class SignalCodec
+{
+public:
+    /** Payload bit index of each raw bit, LSB first (empty when length is not 1..64). */
+    static QVector<int> bitPositions(int startBit, int length, bool motorola);
+    static QVector<int> bitPositions(const CanSignal &signal);
+
+    static quint64 extractRaw(const CanSignal &signal, const uchar *data, int size);
+    static void insertRaw(const CanSignal &signal, quint64 raw, uchar *data, int size);
+    /** Two's-complement sign extension of the low length bits. */
+    static qint64 toSigned(quint64 raw, int length);
+    /** Raw value (sign-extended for signed signals) scaled by factor/offset. */
+    static double decodePhysical(const CanSignal &signal, const uchar *data, int size);
+};
+
+#endif // SIGNALCODEC_H
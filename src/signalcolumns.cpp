@@ -0,0 +1,47 @@
+#include "signalcolumns.h"
+#include "canmessage.h"
+#include "cansignal.h"
+
+SignalColumns::SignalColumns(const QList<CanMessage *> &messages)
+{
+    int total = 0;
+    for (const CanMessage *message : messages) {
+        total += message ? message->getSignals().size() : 0;
+    }
+    m_signalBegin.reserve(messages.size() + 1);
+    m_messageLengths.reserve(messages.size());
+    for (QVector<int> *column : {&m_messageOrdinals, &m_startBits, &m_lengths}) {
+        column->reserve(total);
+    }
+    for (QVector<double> *column : {&m_factors, &m_offsets, &m_minimums, &m_maximums}) {
+        column->reserve(total);
+    }
+    m_motorola.reserve(total);
+    m_signed.reserve(total);
+    m_signals.reserve(total);
+
+    for (int m = 0; m < messages.size(); ++m) {
+        const CanMessage *message = messages.at(m);
+        m_signalBegin.append(m_startBits.size());
+        m_messageLengths.append(message ? message->getLength() : 0);
+        if (!message) {
+            continue;
+        }
+        for (const CanSignal *signal : message->getSignals()) {
+            if (!signal) {
+                continue;
+            }
+            m_messageOrdinals.append(m);
+            m_startBits.append(signal->getStartBit());
+            m_lengths.append(signal->getLength());
+            m_motorola.append(signal->getByteOrder() == 0 ? 1 : 0);
+            m_signed.append(signal->isSigned() ? 1 : 0);
+            m_factors.append(signal->getFactor());
+            m_offsets.append(signal->getOffset());
+            m_minimums.append(signal->getMin());
+            m_maximums.append(signal->getMax());
+            m_signals.append(signal);
+        }
+    }
+    m_signalBegin.append(m_startBits.size());
+}
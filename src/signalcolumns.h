@@ -0,0 +1,60 @@
+#ifndef SIGNALCOLUMNS_H
+#define SIGNALCOLUMNS_H
+
+#include <QList>
+#include <QVector>
+#include <QtGlobal>
+
+class CanMessage;
+class CanSignal;
+
+/**
+ * Read-only structure-of-arrays copy of the numeric signal fields, for bulk passes that would
+ * otherwise chase CanMessage/CanSignal pointers and copy QString/QList values per getter call.
+ *
+ * Signals are numbered message-major: the signals of message m are
+ * [signalBegin(m), signalBegin(m + 1)). Message ordinals follow the message list order, as in
+ * MessageIndex. A snapshot does not track edits; build one per pass.
+ */
+class SignalColumns
+{
+public:
+    SignalColumns() = default;
+    explicit SignalColumns(const QList<CanMessage *> &messages);
+
+    int messageCount() const { return m_messageLengths.size(); }
+    int signalCount() const { return m_startBits.size(); }
+    int signalBegin(int message) const { return m_signalBegin.at(message); }
+
+    // Per message
+    const QVector<int> &messageLengths() const { return m_messageLengths; }
+
+    // Per signal
+    const QVector<int> &messageOrdinals() const { return m_messageOrdinals; }
+    const QVector<int> &startBits() const { return m_startBits; }
+    const QVector<int> &lengths() const { return m_lengths; }
+    const QVector<quint8> &motorola() const { return m_motorola; }   // 1 = @0 (Motorola), 0 = @1 (Intel)
+    const QVector<quint8> &isSigned() const { return m_signed; }
+    const QVector<double> &factors() const { return m_factors; }
+    const QVector<double> &offsets() const { return m_offsets; }
+    const QVector<double> &minimums() const { return m_minimums; }
+    const QVector<double> &maximums() const { return m_maximums; }
+    /** Back-reference for the rare per-signal detail (names, value tables, ...). */
+    const CanSignal *signalAt(int index) const { return m_signals.at(index); }
+
+private:
+    QVector<int> m_signalBegin;     // messageCount() + 1 entries
+    QVector<int> m_messageLengths;
+    QVector<int> m_messageOrdinals;
+    QVector<int> m_startBits;
+    QVector<int> m_lengths;
+    QVector<quint8> m_motorola;
+    QVector<quint8> m_signed;
+    QVector<double> m_factors;
+    QVector<double> m_offsets;
+    QVector<double> m_minimums;
+    QVector<double> m_maximums;
+    QVector<const CanSignal *> m_signals;
+};
+
+#endif // SIGNALCOLUMNS_H
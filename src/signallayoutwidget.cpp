@@ -1,19 +1,18 @@
 #include "signallayoutwidget.h"
 #include "canmessage.h"
 #include "cansignal.h"
-#include <QHeaderView>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
 #include <QVBoxLayout>
 #include <QColor>
 #include <QToolTip>
 #include <QMouseEvent>
 #include <QEvent>
-#include <QApplication>
-#include <QCursor>
 #include <QDialog>
 #include <QTabWidget>
 #include <QTextEdit>
 #include <QDialogButtonBox>
-#include <QPushButton>
 #include <QFont>
 #include <QtGlobal>
 #include <cmath>
@@ -22,6 +21,7 @@
 namespace {
 
 const int kMaxSignalNameChars = 12;
+const int kMaxBytes = 64; // CAN FD
 
 const QList<QColor> kDefaultColors = {
     QColor(0x8B, 0xC3, 0x4A),  // light green
@@ -41,118 +41,233 @@ const QList<QColor> kDefaultColors = {
     QColor(0xBC, 0xAA, 0xA4),  // brown
 };
 
-const int kSignalIndexRole = Qt::UserRole + 1;
+/** "0".."511"，绘制时直接引用，避免每帧 QString::number */
+const QVector<QString> &bitLabels()
+{
+    static const QVector<QString> labels = [] {
+        QVector<QString> out;
+        out.reserve(kMaxBytes * 8);
+        for (int bit = 0; bit < kMaxBytes * 8; ++bit) {
+            out.append(QString::number(bit));
+        }
+        return out;
+    }();
+    return labels;
+}
 
 } // namespace
 
 SignalLayoutWidget::SignalLayoutWidget(QWidget *parent)
-    : QWidget(parent)
-    , m_table(new QTableWidget(this))
+    : QAbstractScrollArea(parent)
     , m_message(nullptr)
-    , m_highlightedSignal(nullptr)
+    , m_emptyBrush(QColor(0xF5, 0xF5, 0xF5))
 {
-    m_signalColors = kDefaultColors;
-    QVBoxLayout *layout = new QVBoxLayout(this);
-    layout->setContentsMargins(0, 0, 0, 0);
-    layout->addWidget(m_table);
+    m_cellSignal.reserve(kMaxBytes * 8);
+    m_signalStart.reserve(64);
+    m_signalBrushes.reserve(kDefaultColors.size());
+    m_highlightBrushes.reserve(kDefaultColors.size());
+    for (const QColor &color : kDefaultColors) {
+        m_signalBrushes.append(QBrush(color));
+        m_highlightBrushes.append(QBrush(color.darker(120)));
+    }
 
-    m_table->setAlternatingRowColors(false);
-    m_table->setShowGrid(true);
-    m_table->verticalHeader()->setVisible(false);
-    m_table->horizontalHeader()->setStretchLastSection(false);
-    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_table->setSelectionMode(QAbstractItemView::NoSelection);
-    m_table->setMouseTracking(true);
-    m_table->viewport()->setMouseTracking(true);
-    m_table->viewport()->installEventFilter(this);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setMouseTracking(true);
+    viewport()->setBackgroundRole(QPalette::Base);
 }
 
-int SignalLayoutWidget::cellToBit(int row, int col)
+void SignalLayoutWidget::setMessage(CanMessage *message)
 {
-    return row * 8 + col;
+    m_message = message;
+    computeLayout();
+    updateScrollBar();
+    viewport()->update();
 }
 
-void SignalLayoutWidget::bitToCell(int bit, int *row, int *col)
+void SignalLayoutWidget::setHighlightedSignal(CanSignal *signal)
 {
-    if (row) *row = bit / 8;
-    if (col) *col = bit % 8;
+    const int index = signal ? m_signalList.indexOf(signal) : -1;
+    if (index == m_highlightedIndex) {
+        return;
+    }
+    m_highlightedIndex = index;
+    viewport()->update();
 }
 
-bool SignalLayoutWidget::eventFilter(QObject *watched, QEvent *event)
+void SignalLayoutWidget::computeLayout()
 {
-    if (watched != m_table->viewport()) {
-        return QWidget::eventFilter(watched, event);
-    }
-    QMouseEvent *mouseEvent = nullptr;
-    if (event->type() == QEvent::MouseMove) {
-        QPoint pos = static_cast<QMouseEvent *>(event)->pos();
-        QTableWidgetItem *item = m_table->itemAt(pos);
-        QString tip = item ? item->data(Qt::UserRole).toString() : QString();
-        if (tip.isEmpty()) {
-            QToolTip::hideText();
-            QToolTip::showText(QPoint(-10000, -10000), QString(), m_table);
-        } else {
-            QPoint globalPos = m_table->viewport()->mapToGlobal(pos);
-            QToolTip::showText(globalPos + QPoint(12, 20), tip, m_table);
+    m_signalList = m_message ? m_message->getSignals() : QList<CanSignal *>();
+    m_byteCount = m_message ? qBound(0, m_message->getLength(), kMaxBytes) : 0;
+    m_highlightedIndex = -1;
+    m_hoverCell = -1;
+
+    // resize/fill 只在已预留的容量内进行，切换报文不再分配内存
+    const int cellCount = m_byteCount * 8;
+    m_cellSignal.resize(cellCount);
+    m_cellSignal.fill(-1);
+    m_signalStart.resize(m_signalList.size());
+    m_signalStart.fill(-1);
+
+    // DBC 约定：@0 = Motorola（大端，startBit 为 MSB），@1 = Intel（小端，startBit 为 LSB）
+    // 物理位 c：0=LSB、7=MSB。显示列 0 对应 bit 7（左 MSB），显示列 7 对应 bit 0（右 LSB），故 displayCol = 7 - c
+    auto cellOf = [](int bit) { return (bit / 8) * 8 + (7 - bit % 8); };
+    for (int i = 0; i < m_signalList.size(); ++i) {
+        const CanSignal *sig = m_signalList.at(i);
+        const int startBit = sig->getStartBit();
+        const int length = sig->getLength();
+        const bool motorola = (sig->getByteOrder() == 0);
+        if (startBit >= 0 && startBit < cellCount) {
+            m_signalStart[i] = cellOf(startBit);
         }
-    } else if (event->type() == QEvent::Leave) {
-        QToolTip::hideText();
-        QToolTip::showText(QPoint(-10000, -10000), QString(), m_table);
-    } else if (event->type() == QEvent::MouseButtonPress) {
-        mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent->button() == Qt::LeftButton) {
-            QPoint pos = mouseEvent->pos();
-            QTableWidgetItem *item = m_table->itemAt(pos);
-            QString tip = item ? item->data(Qt::UserRole).toString() : QString();
-            if (!tip.isEmpty()) {
-                QPoint globalPos = m_table->viewport()->mapToGlobal(pos);
-                QToolTip::showText(globalPos + QPoint(12, 20), tip, m_table);
+        int bitIndex = startBit;
+        for (int k = 0; k < length; ++k) {
+            if (!motorola) {
+                bitIndex = startBit + k;
             }
-        }
-    } else if (event->type() == QEvent::MouseButtonRelease) {
-        mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent->button() == Qt::LeftButton) {
-            QPoint pos = mouseEvent->pos();
-            QTableWidgetItem *item = m_table->itemAt(pos);
-            QString tip = item ? item->data(Qt::UserRole).toString() : QString();
-            if (!tip.isEmpty()) {
-                QPoint globalPos = m_table->viewport()->mapToGlobal(pos);
-                QToolTip::showText(globalPos + QPoint(12, 20), tip, m_table);
+            if (bitIndex >= 0 && bitIndex < cellCount) {
+                m_cellSignal[cellOf(bitIndex)] = i;
+            }
+            if (motorola) {
+                bitIndex += (bitIndex % 8 == 0) ? 15 : -1;
             }
         }
-    } else if (event->type() == QEvent::MouseButtonDblClick) {
-        mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent->button() == Qt::LeftButton && m_message) {
-            QPoint pos = mouseEvent->pos();
-            QTableWidgetItem *item = m_table->itemAt(pos);
-            const int sigIndex = item ? item->data(kSignalIndexRole).toInt() : -1;
-            if (sigIndex >= 0 && sigIndex < m_message->getSignals().size()) {
-                CanSignal *signal = m_message->getSignals().at(sigIndex);
-                showSignalDetailDialog(signal);
+    }
+}
+
+int SignalLayoutWidget::rowHeight() const
+{
+    return fontMetrics().height() + 10;
+}
+
+void SignalLayoutWidget::updateScrollBar()
+{
+    const int rowH = rowHeight();
+    const int visible = qMax(0, viewport()->height() - rowH);
+    verticalScrollBar()->setPageStep(visible);
+    verticalScrollBar()->setSingleStep(rowH);
+    verticalScrollBar()->setRange(0, qMax(0, m_byteCount * rowH - visible));
+}
+
+int SignalLayoutWidget::cellAt(const QPoint &pos) const
+{
+    const int rowH = rowHeight();
+    const int width = viewport()->width();
+    if (m_byteCount == 0 || width <= 0 || pos.y() < rowH || pos.x() < 0 || pos.x() >= width) {
+        return -1;
+    }
+    const int row = (pos.y() - rowH + verticalScrollBar()->value()) / rowH;
+    const int col = pos.x() * 8 / width;
+    if (row >= m_byteCount) {
+        return -1;
+    }
+    return row * 8 + col;
+}
+
+void SignalLayoutWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    const int width = viewport()->width();
+    const int height = viewport()->height();
+    const int rowH = rowHeight();
+    const int scroll = verticalScrollBar()->value();
+    const QColor gridColor = palette().color(QPalette::Mid);
+    auto colLeft = [width](int col) { return col * width / 8; };
+
+    painter.fillRect(viewport()->rect(), palette().brush(QPalette::Base));
+
+    if (m_byteCount > 0) {
+        painter.save();
+        painter.setClipRect(0, rowH, width, height - rowH);
+        const QVector<QString> &labels = bitLabels();
+        const int firstRow = scroll / rowH;
+        const int lastRow = qMin(m_byteCount - 1, (scroll + height - rowH) / rowH);
+        for (int row = firstRow; row <= lastRow; ++row) {
+            const int y = rowH + row * rowH - scroll;
+            for (int col = 0; col < 8; ++col) {
+                const int cell = row * 8 + col;
+                const int sigIndex = m_cellSignal.at(cell);
+                const QRect rect(colLeft(col), y, colLeft(col + 1) - colLeft(col), rowH);
+                if (sigIndex < 0) {
+                    painter.fillRect(rect, m_emptyBrush);
+                } else {
+                    const int colorIndex = sigIndex % m_signalBrushes.size();
+                    painter.fillRect(rect, sigIndex == m_highlightedIndex ? m_highlightBrushes.at(colorIndex)
+                                                                          : m_signalBrushes.at(colorIndex));
+                }
+
+                painter.setPen(palette().color(QPalette::Text));
+                if (sigIndex >= 0 && m_signalStart.at(sigIndex) == cell) {
+                    const QString &fullName = m_signalList.at(sigIndex)->getName();
+                    painter.drawText(rect, Qt::AlignCenter, fullName.length() > kMaxSignalNameChars
+                                     ? fullName.left(kMaxSignalNameChars) + QString("…") : fullName);
+                } else {
+                    painter.drawText(rect, Qt::AlignCenter, labels.at(row * 8 + (7 - col)));
+                }
+                painter.setPen(gridColor);
+                painter.drawLine(rect.topRight(), rect.bottomRight());
+                painter.drawLine(rect.bottomLeft(), rect.bottomRight());
             }
         }
+        painter.restore();
+    }
+
+    // 表头：显示列 0..7 对应 bit 7..0
+    const QRect header(0, 0, width, rowH);
+    painter.fillRect(header, palette().brush(QPalette::Button));
+    painter.setPen(palette().color(QPalette::ButtonText));
+    const QVector<QString> &labels = bitLabels();
+    for (int col = 0; col < 8; ++col) {
+        const QRect rect(colLeft(col), 0, colLeft(col + 1) - colLeft(col), rowH);
+        painter.drawText(rect, Qt::AlignCenter, labels.at(7 - col));
     }
-    return QWidget::eventFilter(watched, event);
+    painter.setPen(gridColor);
+    painter.drawLine(header.bottomLeft(), header.bottomRight());
+}
+
+void SignalLayoutWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
 }
 
-QColor SignalLayoutWidget::colorForSignal(int signalIndex) const
+void SignalLayoutWidget::mouseMoveEvent(QMouseEvent *event)
 {
-    if (signalIndex < 0 || m_signalColors.isEmpty()) {
-        return QColor(0xE0, 0xE0, 0xE0);
+    const int cell = cellAt(event->pos());
+    if (cell == m_hoverCell) {
+        return;
+    }
+    m_hoverCell = cell;
+    const int sigIndex = cell >= 0 ? m_cellSignal.at(cell) : -1;
+    if (sigIndex < 0) {
+        QToolTip::hideText();
+    } else {
+        QToolTip::showText(viewport()->mapToGlobal(event->pos()) + QPoint(12, 20),
+                           m_signalList.at(sigIndex)->getName(), viewport());
     }
-    return m_signalColors.at(signalIndex % m_signalColors.size());
 }
 
-void SignalLayoutWidget::setMessage(CanMessage *message)
+void SignalLayoutWidget::mouseDoubleClickEvent(QMouseEvent *event)
 {
-    m_message = message;
-    buildLayout();
+    if (event->button() != Qt::LeftButton) {
+        return;
+    }
+    const int cell = cellAt(event->pos());
+    const int sigIndex = cell >= 0 ? m_cellSignal.at(cell) : -1;
+    if (sigIndex >= 0) {
+        showSignalDetailDialog(m_signalList.at(sigIndex));
+    }
 }
 
-void SignalLayoutWidget::setHighlightedSignal(CanSignal *signal)
+bool SignalLayoutWidget::viewportEvent(QEvent *event)
 {
-    m_highlightedSignal = signal;
-    buildLayout();
+    if (event->type() == QEvent::Leave) {
+        m_hoverCell = -1;
+        QToolTip::hideText();
+    } else if (event->type() == QEvent::ToolTip) {
+        return true; // tooltips are driven by mouseMoveEvent
+    }
+    return QAbstractScrollArea::viewportEvent(event);
 }
 
 void SignalLayoutWidget::showSignalDetailDialog(CanSignal *signal)
@@ -208,7 +323,7 @@ void SignalLayoutWidget::showSignalDetailDialog(CanSignal *signal)
      .arg(inactiveValue);
 
     QString valueTableText;
-    const QMap<int, QString> valueTable = signal->getValueTable();
+    const QMap<int, QString> &valueTable = signal->getValueTable();
     if (valueTable.isEmpty()) {
         valueTableText = "No value table defined for this signal.";
     } else {
@@ -240,128 +355,3 @@ void SignalLayoutWidget::showSignalDetailDialog(CanSignal *signal)
     dialog->setAttribute(Qt::WA_DeleteOnClose);
     dialog->show();
 }
-
-void SignalLayoutWidget::buildLayout()
-{
-    m_table->clear();
-    m_table->setRowCount(0);
-    m_table->setColumnCount(0);
-
-    if (!m_message) {
-        return;
-    }
-
-    const int dlc = m_message->getLength();
-    if (dlc <= 0) {
-        return;
-    }
-
-    const QList<CanSignal*> signalList = m_message->getSignals();
-
-    // Grid: 8 columns (0-7), one row per byte. Signal names go inside the grid (in each signal's first cell).
-    const int totalCols = 8;
-    m_table->setColumnCount(totalCols);
-    m_table->setRowCount(dlc);
-
-    QStringList headers;
-    headers << "7" << "6" << "5" << "4" << "3" << "2" << "1" << "0";
-    m_table->setHorizontalHeaderLabels(headers);
-
-    // DBC 约定：@0 = Motorola（大端，startBit 为 MSB），@1 = Intel（小端，startBit 为 LSB）
-    // 物理位 c：0=LSB、7=MSB。显示列 0 对应 bit 7（左 MSB），显示列 7 对应 bit 0（右 LSB），故 displayCol = 7 - c
-    QVector<QVector<int>> cellSignal(dlc, QVector<int>(8, -1));
-    QHash<int, QPair<int, int>> signalStartCell;
-    for (int i = 0; i < signalList.size(); ++i) {
-        CanSignal *sig = signalList.at(i);
-        const int startBit = sig->getStartBit();
-        const int length = sig->getLength();
-        const bool motorola = (sig->getByteOrder() == 0);
-        int startRow = -1, startCol = -1;
-        int bitIndex = startBit;
-        for (int k = 0; k < length; ++k) {
-            int r, c;
-            if (motorola) {
-                r = bitIndex / 8;
-                c = bitIndex % 8;
-                if (k == 0) {
-                    startRow = r;
-                    startCol = 7 - c;
-                }
-                if (r >= 0 && r < dlc && c >= 0 && c < 8) {
-                    cellSignal[r][7 - c] = i;
-                }
-                if (bitIndex % 8 == 0) {
-                    bitIndex += 15;
-                } else {
-                    bitIndex -= 1;
-                }
-            } else {
-                bitIndex = startBit + k;
-                r = bitIndex / 8;
-                c = bitIndex % 8;
-                if (k == 0) {
-                    startRow = r;
-                    startCol = 7 - c;
-                }
-                if (r >= 0 && r < dlc && c >= 0 && c < 8) {
-                    cellSignal[r][7 - c] = i;
-                }
-            }
-        }
-        if (startRow >= 0 && startCol >= 0) {
-            signalStartCell[i] = qMakePair(startRow, startCol);
-        }
-    }
-
-    for (int row = 0; row < dlc; ++row) {
-        for (int col = 0; col < 8; ++col) {
-            const int globalBit = row * 8 + (7 - col);
-            const int sigIndex = cellSignal[row][col];
-
-            QString cellText;
-            QString tooltip;
-            if (sigIndex >= 0) {
-                QPair<int, int> start = signalStartCell.value(sigIndex, qMakePair(-1, -1));
-                if (start.first == row && start.second == col) {
-                    QString fullName = signalList.at(sigIndex)->getName();
-                    if (fullName.length() > kMaxSignalNameChars) {
-                        cellText = fullName.left(kMaxSignalNameChars) + QString("…");
-                        tooltip = fullName;
-                    } else {
-                        cellText = fullName;
-                    }
-                } else {
-                    cellText = QString::number(globalBit);
-                }
-                if (tooltip.isEmpty() && sigIndex >= 0) {
-                    tooltip = signalList.at(sigIndex)->getName();
-                }
-            } else {
-                cellText = QString::number(globalBit);
-            }
-
-            QTableWidgetItem *item = new QTableWidgetItem(cellText);
-            item->setTextAlignment(Qt::AlignCenter);
-            item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-            item->setData(Qt::UserRole, tooltip);
-            item->setData(kSignalIndexRole, sigIndex);
-            item->setToolTip(QString());
-            m_table->setItem(row, col, item);
-
-            if (sigIndex >= 0) {
-                QColor bg = colorForSignal(sigIndex);
-                if (signalList.at(sigIndex) == m_highlightedSignal) {
-                    bg = bg.darker(120);
-                }
-                item->setBackground(bg);
-            } else {
-                item->setBackground(QColor(0xF5, 0xF5, 0xF5));
-            }
-        }
-    }
-
-    m_table->resizeColumnsToContents();
-    for (int c = 0; c < 8; ++c) {
-        m_table->horizontalHeader()->setSectionResizeMode(c, QHeaderView::Stretch);
-    }
-}
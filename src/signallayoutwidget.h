@@ -1,19 +1,23 @@
 #ifndef SIGNALLAYOUTWIDGET_H
 #define SIGNALLAYOUTWIDGET_H
 
-#include <QWidget>
-#include <QTableWidget>
-#include <QObject>
+#include <QAbstractScrollArea>
+#include <QBrush>
+#include <QList>
+#include <QVector>
 
 class CanMessage;
 class CanSignal;
 
 /**
  * CANoe-style bitfield layout view for a CAN message.
- * Shows signal names on the left and a grid of bits (bytes x 8) with
- * each cell colored by signal and displaying global bit index.
+ * Paints a grid of bits (bytes x 8) with each cell colored by signal and showing the
+ * global bit index; the signal name is drawn in the signal's first cell.
+ *
+ * The bit -> signal table is computed once per setMessage() into reused buffers;
+ * highlighting only repaints, and hover hit-testing is plain arithmetic.
  */
-class SignalLayoutWidget : public QWidget
+class SignalLayoutWidget : public QAbstractScrollArea
 {
     Q_OBJECT
 
@@ -26,20 +30,30 @@ public:
     void setHighlightedSignal(CanSignal *signal);
 
 protected:
-    bool eventFilter(QObject *watched, QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    bool viewportEvent(QEvent *event) override;
 
 private:
-    void buildLayout();
+    void computeLayout();
+    void updateScrollBar();
+    int rowHeight() const;
+    /** Cell (row * 8 + display column) under a viewport position, or -1. */
+    int cellAt(const QPoint &pos) const;
     void showSignalDetailDialog(CanSignal *signal);
-    /** Returns global bit index for cell (row, col). row=byte, col=0..7, bit 0 = MSB of byte. */
-    static int cellToBit(int row, int col);
-    static void bitToCell(int bit, int *row, int *col);
-    QColor colorForSignal(int signalIndex) const;
 
-    QTableWidget *m_table;
     CanMessage *m_message;
-    CanSignal *m_highlightedSignal;
-    QList<QColor> m_signalColors;
+    QList<CanSignal *> m_signalList;
+    int m_byteCount = 0;
+    int m_highlightedIndex = -1;
+    int m_hoverCell = -1;
+    QVector<int> m_cellSignal;   // per cell: index into m_signalList, or -1
+    QVector<int> m_signalStart;  // per signal: cell holding its start bit (name label), or -1
+    QVector<QBrush> m_signalBrushes;
+    QVector<QBrush> m_highlightBrushes;
+    QBrush m_emptyBrush;
 };
 
 #endif // SIGNALLAYOUTWIDGET_H
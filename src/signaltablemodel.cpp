@@ -0,0 +1,234 @@
+#include "signaltablemodel.h"
+
+#include "canmessage.h"
+#include "cansignal.h"
+#include "editcommands.h"
+#include "messagetreemodel.h"
+
+#include <QBrush>
+
+SignalTableModel::SignalTableModel(MessageTreeModel *tree, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_tree(tree)
+{
+}
+
+int SignalTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !m_message) {
+        return 0;
+    }
+    return m_message->getSignals().size();
+}
+
+int SignalTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SignalTableModel::data(const QModelIndex &index, int role) const
+{
+    const CanSignal *signal = index.isValid() ? signalAt(index.row()) : nullptr;
+    if (!signal) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        switch (index.column()) {
+        case ColumnName: return signal->getName();
+        case ColumnStartBit: return QString::number(signal->getStartBit());
+        case ColumnLength: return QString::number(signal->getLength());
+        case ColumnFactor: return QString::number(signal->getFactor());
+        case ColumnOffset: return QString::number(signal->getOffset());
+        case ColumnMin: return QString::number(signal->getMin());
+        case ColumnMax: return QString::number(signal->getMax());
+        case ColumnUnit: return signal->getUnit();
+        default: break;
+        }
+    } else if (role == Qt::BackgroundRole) {
+        if (m_highlighted.contains(signal)) {
+            return QBrush(QColor(255, 236, 140));
+        }
+    } else if (role == SortRole) {
+        switch (index.column()) {
+        case ColumnName: return signal->getName();
+        case ColumnStartBit: return signal->getStartBit();
+        case ColumnLength: return signal->getLength();
+        case ColumnFactor: return signal->getFactor();
+        case ColumnOffset: return signal->getOffset();
+        case ColumnMin: return signal->getMin();
+        case ColumnMax: return signal->getMax();
+        case ColumnUnit: return signal->getUnit();
+        default: break;
+        }
+    }
+    return QVariant();
+}
+
+bool SignalTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid()) {
+        return false;
+    }
+    CanSignal *signal = signalAt(index.row());
+    if (!signal) {
+        return false;
+    }
+
+    const QString text = value.toString().trimmed();
+    const QString commandText = tr("Edit %1 of %2")
+        .arg(headerData(index.column(), Qt::Horizontal).toString(), signal->getName());
+    // Only the edited field's old/new value is recorded; unchanged values push nothing.
+    auto pushString = [&](const QString &(CanSignal::*getter)() const, void (CanSignal::*setter)(QString)) {
+        const QString before = (signal->*getter)();
+        if (before != text) {
+            m_tree->pushEdit(new SetSignalFieldCommand<QString>(m_tree, m_message, signal, setter,
+                                                                before, text, commandText));
+        }
+    };
+    auto pushInt = [&](int (CanSignal::*getter)() const, void (CanSignal::*setter)(int), int after) {
+        const int before = (signal->*getter)();
+        if (before != after) {
+            m_tree->pushEdit(new SetSignalFieldCommand<int>(m_tree, m_message, signal, setter,
+                                                            before, after, commandText));
+        }
+    };
+    auto pushDouble = [&](double (CanSignal::*getter)() const, void (CanSignal::*setter)(double), double after) {
+        const double before = (signal->*getter)();
+        if (before != after) {
+            m_tree->pushEdit(new SetSignalFieldCommand<double>(m_tree, m_message, signal, setter,
+                                                               before, after, commandText));
+        }
+    };
+
+    bool ok = false;
+    switch (index.column()) {
+    case ColumnName:
+        pushString(&CanSignal::getName, &CanSignal::setName);
+        break;
+    case ColumnStartBit: {
+        const int v = text.toInt(&ok);
+        if (!ok) {
+            emit editRejected(tr("无效的起始位：%1").arg(text));
+            return false;
+        }
+        pushInt(&CanSignal::getStartBit, &CanSignal::setStartBit, v);
+        break;
+    }
+    case ColumnLength: {
+        const int v = text.toInt(&ok);
+        if (!ok || v <= 0) {
+            emit editRejected(tr("无效的长度：%1").arg(text));
+            return false;
+        }
+        pushInt(&CanSignal::getLength, &CanSignal::setLength, v);
+        break;
+    }
+    case ColumnFactor: {
+        const double v = text.toDouble(&ok);
+        if (!ok) {
+            emit editRejected(tr("无效的系数：%1").arg(text));
+            return false;
+        }
+        pushDouble(&CanSignal::getFactor, &CanSignal::setFactor, v);
+        break;
+    }
+    case ColumnOffset: {
+        const double v = text.toDouble(&ok);
+        if (!ok) {
+            emit editRejected(tr("无效的偏移：%1").arg(text));
+            return false;
+        }
+        pushDouble(&CanSignal::getOffset, &CanSignal::setOffset, v);
+        break;
+    }
+    case ColumnMin: {
+        const double v = text.toDouble(&ok);
+        if (!ok) {
+            emit editRejected(tr("无效的最小值：%1").arg(text));
+            return false;
+        }
+        pushDouble(&CanSignal::getMin, &CanSignal::setMin, v);
+        break;
+    }
+    case ColumnMax: {
+        const double v = text.toDouble(&ok);
+        if (!ok) {
+            emit editRejected(tr("无效的最大值：%1").arg(text));
+            return false;
+        }
+        pushDouble(&CanSignal::getMax, &CanSignal::setMax, v);
+        break;
+    }
+    case ColumnUnit:
+        pushString(&CanSignal::getUnit, &CanSignal::setUnit);
+        break;
+    default:
+        return false;
+    }
+
+    // The command reaches this model again through MessageTreeModel::signalUpdated.
+    return true;
+}
+
+QVariant SignalTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    switch (section) {
+    case ColumnName: return QStringLiteral("Name");
+    case ColumnStartBit: return QStringLiteral("Start Bit");
+    case ColumnLength: return QStringLiteral("Length");
+    case ColumnFactor: return QStringLiteral("Factor");
+    case ColumnOffset: return QStringLiteral("Offset");
+    case ColumnMin: return QStringLiteral("Min");
+    case ColumnMax: return QStringLiteral("Max");
+    case ColumnUnit: return QStringLiteral("Unit");
+    default: return QVariant();
+    }
+}
+
+Qt::ItemFlags SignalTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsEditable;
+}
+
+void SignalTableModel::setMessage(CanMessage *message)
+{
+    beginResetModel();
+    m_message = message;
+    endResetModel();
+}
+
+CanSignal *SignalTableModel::signalAt(int row) const
+{
+    return m_message ? m_message->getSignals().value(row) : nullptr;
+}
+
+int SignalTableModel::rowOfSignal(const CanSignal *signal) const
+{
+    return m_message ? m_message->getSignals().indexOf(const_cast<CanSignal *>(signal)) : -1;
+}
+
+void SignalTableModel::signalChanged(CanSignal *signal)
+{
+    const int row = rowOfSignal(signal);
+    if (row >= 0) {
+        emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+    }
+}
+
+void SignalTableModel::setHighlightedSignals(const QSet<const CanSignal *> &highlighted)
+{
+    m_highlighted = highlighted;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0, 0), index(rowCount() - 1, ColumnCount - 1), {Qt::BackgroundRole});
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef SIGNALTABLEMODEL_H
+#define SIGNALTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSet>
+
+class CanMessage;
+class CanSignal;
+class MessageTreeModel;
+
+/**
+ * Table model over one message's signal list. Cells are formatted on demand; nothing is
+ * cached per cell, so switching messages is a model reset and sorting is done by a proxy
+ * on SortRole (typed values, not display text). Edits are pushed as undoable field
+ * commands through the message tree model, which notifies every view.
+ */
+class SignalTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        ColumnName,
+        ColumnStartBit,
+        ColumnLength,
+        ColumnFactor,
+        ColumnOffset,
+        ColumnMin,
+        ColumnMax,
+        ColumnUnit,
+        ColumnCount
+    };
+
+    static constexpr int SortRole = Qt::UserRole + 1;
+
+    explicit SignalTableModel(MessageTreeModel *tree, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    /** Shows the signals of message; nullptr clears the table. */
+    void setMessage(CanMessage *message);
+    CanMessage *message() const { return m_message; }
+    CanSignal *signalAt(int row) const;
+    int rowOfSignal(const CanSignal *signal) const;
+    /** Call after changing a signal outside the model. */
+    void signalChanged(CanSignal *signal);
+    /** Signals drawn with the search highlight background. */
+    void setHighlightedSignals(const QSet<const CanSignal *> &highlighted);
+
+signals:
+    /** An edit was refused; reason is user-visible. */
+    void editRejected(const QString &reason);
+
+private:
+    MessageTreeModel *m_tree;
+    CanMessage *m_message = nullptr;
+    QSet<const CanSignal *> m_highlighted;
+};
+
+#endif // SIGNALTABLEMODEL_H
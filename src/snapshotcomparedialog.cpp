@@ -0,0 +1,172 @@
+#include "snapshotcomparedialog.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDialogButtonBox>
+#include <QGroupBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTextEdit>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace {
+QString describeMessage(const MessageSnapshot &snapshot)
+{
+    const CanMessage &message = snapshot.message();
+    QString text = QString("ID: %1\nName: %2\nLength: %3\nTransmitter: %4\nCycle Time: %5 ms\nSend Type: %6\n")
+        .arg(message.getFormattedId(), message.getName())
+        .arg(message.getLength())
+        .arg(message.getTransmitter())
+        .arg(message.getCycleTime())
+        .arg(message.getSendType());
+    text += QString("\nSignals (%1):\n").arg(snapshot.signalList().size());
+    for (const CanSignal &signal : snapshot.signalList()) {
+        text += QString("  %1  bit %2|%3 %4  (%5, %6)  [%7 .. %8] %9\n")
+            .arg(signal.getName())
+            .arg(signal.getStartBit())
+            .arg(signal.getLength())
+            .arg(signal.getByteOrder() == 0 ? "Intel" : "Motorola")
+            .arg(signal.getFactor())
+            .arg(signal.getOffset())
+            .arg(signal.getMin())
+            .arg(signal.getMax())
+            .arg(signal.getUnit());
+    }
+    return text;
+}
+
+QString kindText(DbcDiff::Kind kind)
+{
+    switch (kind) {
+    case DbcDiff::Added: return QObject::tr("新增");
+    case DbcDiff::Removed: return QObject::tr("删除");
+    case DbcDiff::Modified: return QObject::tr("修改");
+    }
+    return QString();
+}
+
+const int kMessageIndexRole = Qt::UserRole + 1;
+
+void addFieldItems(QTreeWidgetItem *parent, const QList<DbcDiff::FieldChange> &fields, int messageIndex)
+{
+    for (const DbcDiff::FieldChange &field : fields) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(parent);
+        item->setText(1, field.field);
+        item->setText(2, field.before);
+        item->setText(3, field.after);
+        item->setData(0, kMessageIndexRole, messageIndex);
+    }
+}
+} // namespace
+
+SnapshotCompareDialog::SnapshotCompareDialog(const QString &beforeTitle, const DbcSnapshot &before,
+                                             const QString &afterTitle, const DbcSnapshot &after,
+                                             QWidget *parent)
+    : QDialog(parent)
+    , m_diff(DbcDiffer::diff(before, after))
+    , m_afterVersion(after.version)
+{
+    setWindowTitle(tr("Compare: %1 ↔ %2").arg(beforeTitle, afterTitle));
+    resize(1000, 600);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel(tr("新增 %1 个、删除 %2 个、修改 %3 个报文")
+                                     .arg(m_diff.count(DbcDiff::Added))
+                                     .arg(m_diff.count(DbcDiff::Removed))
+                                     .arg(m_diff.count(DbcDiff::Modified)), this));
+
+    m_list = new QTreeWidget(this);
+    m_list->setColumnCount(4);
+    m_list->setHeaderLabels(QStringList() << tr("Change") << tr("Item") << beforeTitle << afterTitle);
+    m_list->setUniformRowHeights(true);
+    if (!m_diff.databaseFields.isEmpty()) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(m_list);
+        item->setText(0, kindText(DbcDiff::Modified));
+        item->setText(1, tr("Database"));
+        item->setData(0, kMessageIndexRole, -1);
+        addFieldItems(item, m_diff.databaseFields, -1);
+    }
+    for (int i = 0; i < m_diff.messages.size(); ++i) {
+        const DbcDiff::MessageChange &change = m_diff.messages.at(i);
+        const CanMessage &message = change.kind == DbcDiff::Added ? change.after.message() : change.before.message();
+        QTreeWidgetItem *item = new QTreeWidgetItem(m_list);
+        item->setText(0, kindText(change.kind));
+        item->setText(1, QString("%1 %2").arg(message.getFormattedId(), change.name));
+        item->setData(0, kMessageIndexRole, i);
+        addFieldItems(item, change.fields, i);
+        for (const DbcDiff::SignalChange &signalChange : change.signalChanges) {
+            QTreeWidgetItem *signalItem = new QTreeWidgetItem(item);
+            signalItem->setText(0, kindText(signalChange.kind));
+            signalItem->setText(1, tr("Signal %1").arg(signalChange.name));
+            signalItem->setData(0, kMessageIndexRole, i);
+            addFieldItems(signalItem, signalChange.fields, i);
+        }
+    }
+    m_list->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    auto makePane = [this](const QString &title, QTextEdit **edit) {
+        QGroupBox *box = new QGroupBox(title, this);
+        QVBoxLayout *boxLayout = new QVBoxLayout(box);
+        *edit = new QTextEdit(box);
+        (*edit)->setReadOnly(true);
+        (*edit)->setFont(QFont("Courier", 10));
+        (*edit)->setLineWrapMode(QTextEdit::NoWrap);
+        boxLayout->addWidget(*edit);
+        return box;
+    };
+
+    QSplitter *sides = new QSplitter(Qt::Horizontal, this);
+    sides->addWidget(makePane(beforeTitle, &m_before));
+    sides->addWidget(makePane(afterTitle, &m_after));
+
+    QSplitter *main = new QSplitter(Qt::Vertical, this);
+    main->addWidget(m_list);
+    main->addWidget(sides);
+    main->setSizes(QList<int>() << 200 << 400);
+    layout->addWidget(main);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *copyButton = buttons->addButton(tr("Copy Change History"), QDialogButtonBox::ActionRole);
+    copyButton->setEnabled(!m_diff.isEmpty());
+    connect(copyButton, &QPushButton::clicked, this, &SnapshotCompareDialog::copyChangeHistory);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttons);
+
+    connect(m_list, &QTreeWidget::currentItemChanged, this, [this](QTreeWidgetItem *current) {
+        showDifference(current ? current->data(0, kMessageIndexRole).toInt() : -1);
+    });
+    if (m_list->topLevelItemCount() > 0) {
+        m_list->setCurrentItem(m_list->topLevelItem(0));
+    }
+}
+
+void SnapshotCompareDialog::showDifference(int index)
+{
+    if (index < 0 || index >= m_diff.messages.size()) {
+        m_before->clear();
+        m_after->clear();
+        return;
+    }
+    const DbcDiff::MessageChange &change = m_diff.messages.at(index);
+    m_before->setPlainText(change.kind == DbcDiff::Added ? tr("（不存在）") : describeMessage(change.before));
+    m_after->setPlainText(change.kind == DbcDiff::Removed ? tr("（不存在）") : describeMessage(change.after));
+}
+
+void SnapshotCompareDialog::copyChangeHistory()
+{
+    const QList<DbcExcelConverter::ChangeHistoryEntry> entries =
+        DbcDiffer::changeHistoryEntries(m_diff, m_afterVersion, QString(), QDate::currentDate());
+    QStringList rows;
+    for (const DbcExcelConverter::ChangeHistoryEntry &e : entries) {
+        // 多行内容加引号，粘贴到 Excel 时保持在同一单元格
+        QString content = e.changeContent;
+        content.replace(QLatin1Char('"'), QLatin1String("\"\""));
+        rows << QStringList{e.serialNumber, e.protocolVersion, QString("\"%1\"").arg(content),
+                            e.changer, e.changeDate, e.reviewer}.join(QLatin1Char('\t'));
+    }
+    QApplication::clipboard()->setText(rows.join(QLatin1Char('\n')));
+}
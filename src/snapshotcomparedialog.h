@@ -0,0 +1,38 @@
+#ifndef SNAPSHOTCOMPAREDIALOG_H
+#define SNAPSHOTCOMPAREDIALOG_H
+
+#include <QDialog>
+#include <QList>
+
+#include "dbcdiff.h"
+#include "dbcsnapshot.h"
+
+class QTreeWidget;
+class QTextEdit;
+
+/**
+ * Side-by-side comparison of two database snapshots: a tree of added/removed/modified
+ * messages with their changed fields and signals, and the selected message from both sides.
+ */
+class SnapshotCompareDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    SnapshotCompareDialog(const QString &beforeTitle, const DbcSnapshot &before,
+                          const QString &afterTitle, const DbcSnapshot &after,
+                          QWidget *parent = nullptr);
+
+private:
+    void showDifference(int index);
+    /** Copies the diff as tab-separated change-history rows (pasteable into the Excel sheet). */
+    void copyChangeHistory();
+
+    DbcDiff m_diff;
+    QString m_afterVersion;
+    QTreeWidget *m_list;
+    QTextEdit *m_before;
+    QTextEdit *m_after;
+};
+
+#endif // SNAPSHOTCOMPAREDIALOG_H
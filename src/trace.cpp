@@ -0,0 +1,211 @@
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+
+struct Event
+{
+    const char *name;
+    qint64 startNs;
+    qint64 endNs;
+};
+
+/** Ring buffer of one thread. Only its owner writes; the mutex is uncontended except while dumping. */
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    std::vector<Event> events;
+    quint64 written = 0;
+    int tid = 0;
+    QString name;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; // kept after thread exit so the dump still sees them
+    int nextTid = 1;
+    QString outputPath;
+    bool atExitRegistered = false;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer &currentBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(Trace::kRingCapacity);
+        QThread *thread = QThread::currentThread();
+        const QCoreApplication *app = QCoreApplication::instance();
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer->tid = reg.nextTid++;
+        if (app && thread == app->thread()) {
+            buffer->name = QStringLiteral("main");
+        } else if (thread && !thread->objectName().isEmpty()) {
+            buffer->name = QString("%1 #%2").arg(thread->objectName()).arg(buffer->tid);
+        } else {
+            buffer->name = QString("thread #%1").arg(buffer->tid);
+        }
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+QByteArray jsonString(const QString &text)
+{
+    QByteArray out = "\"";
+    for (const QChar ch : text) {
+        if (ch == QLatin1Char('"') || ch == QLatin1Char('\\')) {
+            out += '\\';
+            out += char(ch.unicode());
+        } else if (ch.unicode() < 0x20) {
+            out += ' ';
+        } else {
+            out += QString(ch).toUtf8();
+        }
+    }
+    out += '"';
+    return out;
+}
+
+void writeAtExit()
+{
+    const QString path = registry().outputPath;
+    if (path.isEmpty()) {
+        return;
+    }
+    QString error;
+    if (!Trace::writeChromeTrace(path, &error)) {
+        fprintf(stderr, "Failed to write trace %s: %s\n", qPrintable(path), qPrintable(error));
+    }
+}
+
+} // namespace
+
+void Trace::setEnabled(bool enabled)
+{
+    nowNs(); // fix the time origin before the first event
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::startSession(const QString &filePath)
+{
+    Registry &reg = registry(); // constructed before atexit registration, so it outlives writeAtExit
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.outputPath = filePath;
+        if (!reg.atExitRegistered) {
+            reg.atExitRegistered = true;
+            std::atexit(writeAtExit);
+        }
+    }
+    setEnabled(true);
+}
+
+void Trace::initFromEnvironment()
+{
+    const QString path = qEnvironmentVariable("DBC_TRACE");
+    if (!path.isEmpty()) {
+        startSession(path);
+    }
+}
+
+qint64 Trace::nowNs()
+{
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point origin = Clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count();
+}
+
+void Trace::record(const char *name, qint64 startNs, qint64 endNs)
+{
+    ThreadBuffer &buffer = currentBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.written % buffer.events.size()] = Event{name, startNs, endNs};
+    ++buffer.written;
+}
+
+void Trace::clear()
+{
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->written = 0;
+    }
+}
+
+bool Trace::writeChromeTrace(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        separator();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":" + jsonString(buffer->name) + "}}";
+
+        const quint64 capacity = buffer->events.size();
+        const quint64 count = qMin(buffer->written, capacity);
+        const quint64 begin = buffer->written - count; // oldest event still in the ring
+        for (quint64 i = begin; i < buffer->written; ++i) {
+            const Event &event = buffer->events[i % capacity];
+            separator();
+            out += "{\"name\":" + jsonString(QString::fromLatin1(event.name)) + ",\"cat\":\"dbc\",\"ph\":\"X\",\"pid\":"
+                   + pid + ",\"tid\":" + tid + ",\"ts\":" + QByteArray::number(event.startNs / 1000.0, 'f', 3)
+                   + ",\"dur\":" + QByteArray::number((event.endNs - event.startNs) / 1000.0, 'f', 3) + "}";
+        }
+        if (out.size() > (1 << 20)) {
+            file.write(out);
+            out.clear();
+        }
+    }
+    out += "]}\n";
+    if (file.write(out) != out.size()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,254 @@
+#include "xlsxarchive.h"
+#include "trace.h"
+
+#include <QFile>
+#include <QFuture>
+#include <QtConcurrent>
+
+#include <cstring>
+
+#include "miniz.h"
+
+namespace {
+struct ExtractSink
+{
+    QByteArray *buffer;
+};
+
+size_t appendToBuffer(void *opaque, mz_uint64 fileOffset, const void *data, size_t size)
+{
+    auto *sink = static_cast<ExtractSink *>(opaque);
+    // miniz streams entries front to back; anything else means a corrupt package.
+    if (fileOffset != static_cast<mz_uint64>(sink->buffer->size())) {
+        return 0;
+    }
+    sink->buffer->append(static_cast<const char *>(data), static_cast<int>(size));
+    return size;
+}
+
+struct DeflatedEntry
+{
+    QByteArray data;
+    mz_uint32 crc32 = 0;
+    bool compressed = false;
+};
+
+// Raw deflate (no zlib header) so the result can be stored as-is in a zip entry.
+DeflatedEntry deflateEntry(const QByteArray &content, int level)
+{
+    DBC_TRACE_SCOPE("deflateEntry");
+    DeflatedEntry result;
+    result.crc32 = static_cast<mz_uint32>(mz_crc32(MZ_CRC32_INIT,
+        reinterpret_cast<const unsigned char *>(content.constData()), static_cast<size_t>(content.size())));
+    if (level <= 0 || content.size() <= 3) {
+        return result;
+    }
+    const mz_uint flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+    size_t compressedSize = 0;
+    void *buffer = tdefl_compress_mem_to_heap(content.constData(), static_cast<size_t>(content.size()), &compressedSize, static_cast<int>(flags));
+    if (!buffer) {
+        return result;
+    }
+    // Incompressible parts are stored instead.
+    if (compressedSize < static_cast<size_t>(content.size())) {
+        result.data = QByteArray(static_cast<const char *>(buffer), static_cast<int>(compressedSize));
+        result.compressed = true;
+    }
+    mz_free(buffer);
+    return result;
+}
+} // namespace
+
+struct XlsxArchiveReader::Private
+{
+    mz_zip_archive archive;
+    bool open = false;
+};
+
+XlsxArchiveReader::XlsxArchiveReader()
+    : d(new Private)
+{
+    memset(&d->archive, 0, sizeof(d->archive));
+}
+
+XlsxArchiveReader::~XlsxArchiveReader()
+{
+    close();
+    delete d;
+}
+
+bool XlsxArchiveReader::open(const QString &filePath, QString *error)
+{
+    close();
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("Failed to open %1 as zip archive").arg(filePath);
+        }
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+    if (!openData(data, nullptr)) {
+        if (error) {
+            *error = QString("Failed to open %1 as zip archive").arg(filePath);
+        }
+        return false;
+    }
+    m_name = filePath;
+    return true;
+}
+
+bool XlsxArchiveReader::openData(const QByteArray &data, QString *error)
+{
+    close();
+    m_data = data;
+    if (!mz_zip_reader_init_mem(&d->archive, m_data.constData(), static_cast<size_t>(m_data.size()), 0)) {
+        if (error) {
+            *error = QStringLiteral("Failed to open data as zip archive");
+        }
+        m_data.clear();
+        memset(&d->archive, 0, sizeof(d->archive));
+        return false;
+    }
+    d->open = true;
+    m_name = QStringLiteral("archive");
+    return true;
+}
+
+void XlsxArchiveReader::close()
+{
+    if (d->open) {
+        mz_zip_reader_end(&d->archive);
+        memset(&d->archive, 0, sizeof(d->archive));
+        d->open = false;
+    }
+    m_data.clear();
+    m_name.clear();
+}
+
+bool XlsxArchiveReader::isOpen() const
+{
+    return d->open;
+}
+
+int XlsxArchiveReader::entryCount() const
+{
+    return d->open ? static_cast<int>(mz_zip_reader_get_num_files(&d->archive)) : 0;
+}
+
+int XlsxArchiveReader::entryIndex(const QString &entryName) const
+{
+    if (!d->open) {
+        return -1;
+    }
+    return mz_zip_reader_locate_file(&d->archive, entryName.toUtf8().constData(), nullptr, 0);
+}
+
+QByteArray XlsxArchiveReader::read(int index, QString *error) const
+{
+    DBC_TRACE_SCOPE("XlsxArchiveReader::read");
+    if (!d->open || index < 0 || index >= entryCount()) {
+        if (error) {
+            *error = QString("Missing entry #%1 in %2").arg(index).arg(m_name);
+        }
+        return QByteArray();
+    }
+
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(&d->archive, static_cast<mz_uint>(index), &stat) || stat.m_is_directory) {
+        if (error) {
+            *error = QString("Missing entry #%1 in %2").arg(index).arg(m_name);
+        }
+        return QByteArray();
+    }
+
+    QByteArray data;
+    data.reserve(static_cast<int>(stat.m_uncomp_size));
+    ExtractSink sink{&data};
+    if (!mz_zip_reader_extract_to_callback(&d->archive, static_cast<mz_uint>(index), appendToBuffer, &sink, 0)) {
+        if (error) {
+            *error = QString("Failed to extract %1 from %2").arg(QString::fromUtf8(stat.m_filename), m_name);
+        }
+        return QByteArray();
+    }
+    return data;
+}
+
+QByteArray XlsxArchiveReader::read(const QString &entryName, QString *error) const
+{
+    const int index = entryIndex(entryName);
+    const QByteArray data = index >= 0 ? read(index, nullptr) : QByteArray();
+    if (data.isEmpty()) {
+        if (error) {
+            *error = QString("Missing entry %1 in %2").arg(entryName, m_name);
+        }
+    }
+    return data;
+}
+
+bool XlsxArchiveWriter::write(const QString &filePath,
+                              const QList<Entry> &entries,
+                              int compressionLevel,
+                              QString *error)
+{
+    DBC_TRACE_SCOPE("XlsxArchiveWriter::write");
+    const int level = qBound(0, compressionLevel, static_cast<int>(MZ_UBER_COMPRESSION));
+
+    QList<QFuture<DeflatedEntry>> pending;
+    for (const Entry &entry : entries) {
+        const QByteArray content = entry.second;
+        pending.append(QtConcurrent::run([content, level]() {
+            return deflateEntry(content, level);
+        }));
+    }
+
+    mz_zip_archive archive;
+    memset(&archive, 0, sizeof(archive));
+    if (!mz_zip_writer_init_file(&archive, filePath.toUtf8().constData(), 0)) {
+        for (QFuture<DeflatedEntry> &future : pending) {
+            future.waitForFinished();
+        }
+        if (error) {
+            *error = QString("Failed to initialize archive writer for %1").arg(filePath);
+        }
+        return false;
+    }
+
+    for (int i = 0; i < entries.size(); ++i) {
+        const Entry &entry = entries.at(i);
+        const DeflatedEntry deflated = pending[i].result();
+        const QByteArray name = entry.first.toUtf8();
+        mz_bool ok;
+        if (deflated.compressed) {
+            ok = mz_zip_writer_add_mem_ex(&archive, name.constData(),
+                                          deflated.data.constData(), static_cast<size_t>(deflated.data.size()),
+                                          nullptr, 0, MZ_ZIP_FLAG_COMPRESSED_DATA,
+                                          static_cast<mz_uint64>(entry.second.size()), deflated.crc32);
+        } else {
+            ok = mz_zip_writer_add_mem(&archive, name.constData(),
+                                       entry.second.constData(), static_cast<size_t>(entry.second.size()),
+                                       MZ_NO_COMPRESSION);
+        }
+        if (!ok) {
+            for (int j = i + 1; j < pending.size(); ++j) {
+                pending[j].waitForFinished();
+            }
+            if (error) {
+                *error = QString("Failed to add %1 to archive").arg(entry.first);
+            }
+            mz_zip_writer_end(&archive);
+            return false;
+        }
+    }
+
+    const bool ok = mz_zip_writer_finalize_archive(&archive);
+    mz_zip_writer_end(&archive);
+    if (!ok) {
+        if (error) {
+            *error = QString("Failed to finalize Excel archive %1").arg(filePath);
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef XLSXARCHIVE_H
+#define XLSXARCHIVE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * Read-only access to an XLSX (zip) package. The package is read from disk and its
+ * central directory parsed once; entries are then located by name or index and
+ * inflated on demand through a streaming callback.
+ */
+class XlsxArchiveReader
+{
+public:
+    XlsxArchiveReader();
+    ~XlsxArchiveReader();
+
+    bool open(const QString &filePath, QString *error = nullptr);
+    /** Opens an in-memory package. The buffer is shared, not copied. */
+    bool openData(const QByteArray &data, QString *error = nullptr);
+    void close();
+    bool isOpen() const;
+
+    /** Package bytes, so that another reader (e.g. on a worker thread) can share them. */
+    QByteArray data() const { return m_data; }
+    int entryCount() const;
+    /** Returns -1 if the package has no entry with that name. */
+    int entryIndex(const QString &entryName) const;
+    QByteArray read(int index, QString *error = nullptr) const;
+    QByteArray read(const QString &entryName, QString *error = nullptr) const;
+
+private:
+    Q_DISABLE_COPY(XlsxArchiveReader)
+
+    struct Private;
+    Private *d;
+    QByteArray m_data;
+    QString m_name;
+};
+
+/**
+ * Writes an XLSX (zip) package. Entries are deflated concurrently on the global
+ * thread pool and then appended to the archive in order on the calling thread.
+ */
+class XlsxArchiveWriter
+{
+public:
+    /** Package part: zip entry name and uncompressed content. */
+    using Entry = QPair<QString, QByteArray>;
+
+    /** compressionLevel is a miniz level, 0 (store) to 10 (uber). */
+    static bool write(const QString &filePath,
+                      const QList<Entry> &entries,
+                      int compressionLevel,
+                      QString *error = nullptr);
+};
+
+#endif // XLSXARCHIVE_H